@@ -0,0 +1,191 @@
+/** @file : BatchScan.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the headless scan that writes the matching files to standard output.
+History : Added so a scan can run from a scheduled job or feed another program, without the console screen.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "BatchScan.hpp"
+
+#include <iostream>
+
+
+namespace {
+	// Each worker's buffer is written out once it holds this much.
+	std::size_t const BUFFER_SIZE = 1024 * 1024;
+
+	// Room kept past BUFFER_SIZE so that one more record never makes the buffer grow.
+	std::size_t const SLACK = 64 * 1024;
+
+	void AppendNumber(std::string& out, unsigned long long value) {
+		char digits[24];
+		char* p = digits + sizeof(digits);
+		do
+		{
+			*--p = static_cast<char>('0' + value % 10);
+			value /= 10;
+		} while (value);
+		out.append(p, digits + sizeof(digits));
+	}
+
+	// JSON text must be UTF-8, and paths come in the ANSI code page, so a path with any byte past ASCII is
+	// converted through UTF-16. Plain ASCII paths, nearly all of them, are copied as they are.
+	std::string ToUtf8(std::string const& text) {
+		std::string::size_type i = 0;
+		while (i < text.size() && static_cast<unsigned char>(text[i]) < 0x80)
+			++i;
+		if (i == text.size())
+			return text;
+
+		int const wide = MultiByteToWideChar(CP_ACP, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+		std::wstring utf16(wide, L'\0');
+		MultiByteToWideChar(CP_ACP, 0, text.data(), static_cast<int>(text.size()), &utf16[0], wide);
+
+		int const narrow = WideCharToMultiByte(CP_UTF8, 0, utf16.data(), wide, nullptr, 0, nullptr, nullptr);
+		std::string utf8(narrow, '\0');
+		WideCharToMultiByte(CP_UTF8, 0, utf16.data(), wide, &utf8[0], narrow, nullptr, nullptr);
+		return utf8;
+	}
+
+	void AppendJsonString(std::string& out, std::string const& text) {
+		static char const HEX[] = "0123456789abcdef";
+		out += '"';
+		for (char c : text)
+		{
+			unsigned char const u = static_cast<unsigned char>(c);
+			if (c == '"' || c == '\\')
+			{
+				out += '\\';
+				out += c;
+			}
+			else if (u < 0x20)
+			{
+				out += "\\u00";
+				out += HEX[u >> 4];
+				out += HEX[u & 0xf];
+			}
+			else
+				out += c;
+		}
+		out += '"';
+	}
+}
+
+
+// -------- CONSTRUCTOR --------
+BatchScan::BatchScan(std::string const& folder, std::string const& filter, bool recurse, Format format) : folder_(folder), filter_(filter), recurse_(recurse), format_(format), out_(GetStdHandle(STD_OUTPUT_HANDLE)), failed_(false), written_(0) {
+}
+
+// -------- OPERATIONS --------
+
+// The filter is only applied when it can reject something, since ".*", the default, matches every extension.
+
+int BatchScan::Run() {
+	std::regex r;
+	try
+	{
+		r = filter_;
+	}
+	catch (std::regex_error&)
+	{
+		std::cerr << "Invalid regex: " << filter_ << std::endl;
+		return 2;
+	}
+	bool const all = filter_ == ".*";
+
+	written_ = 0;
+	failed_ = false;
+	MultiScan engine(MultiScan::SplitRoots(folder_));
+	buffers_.assign(engine.GetThreadCount(), std::string());
+	for (auto& buffer : buffers_)
+		buffer.reserve(BUFFER_SIZE + SLACK);
+
+	try
+	{
+		engine.Run(recurse_, [&](unsigned worker, std::tr2::sys::path const& file) {
+			if (failed_.load(std::memory_order_relaxed))
+				return;
+
+			if (!all)
+			{
+				std::string ext = file.extension();
+				if (!std::regex_match(ext, r))
+					return;
+			}
+			Emit(worker, file, engine.GetErrors());
+		});
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << "Cannot scan " << folder_ << ": " << e.what() << std::endl;
+		return 2;
+	}
+
+	for (auto& buffer : buffers_)
+		Flush(buffer);
+
+	// What could not be read was skipped; say so, but it does not fail the run.
+	if (engine.GetErrors().GetTotal())
+		std::cerr << engine.GetErrors().Summarize() << std::endl;
+
+	return failed_ ? 1 : 0;
+}
+
+// Only the JSON records need the size and time, so only they pay for the extra stat. A file that is gone by
+// the time it is looked at is left out, and counted in errors.
+
+void BatchScan::Emit(unsigned worker, std::tr2::sys::path const& file, ScanErrors& errors) {
+	std::string& buffer = buffers_[worker];
+	switch (format_)
+	{
+		case LINES: buffer += file.string(); buffer += '\n'; break;
+		case NUL: buffer += file.string(); buffer += '\0'; break;
+		case NDJSON:
+		{
+			std::error_code ec;
+			FileEntry entry = ScanEngine::Describe(file, ec);
+			if (ec)
+			{
+				errors.Count(ec, entry.path_);
+				return;
+			}
+
+			buffer += "{\"path\":";
+			AppendJsonString(buffer, ToUtf8(entry.path_));
+			buffer += ",\"size\":";
+			AppendNumber(buffer, entry.size_);
+			buffer += ",\"mtime\":";
+			if (entry.mtime_ < 0)
+			{
+				buffer += '-';
+				AppendNumber(buffer, static_cast<unsigned long long>(-entry.mtime_));
+			}
+			else
+				AppendNumber(buffer, static_cast<unsigned long long>(entry.mtime_));
+			buffer += "}\n";
+		}
+		break;
+	}
+
+	if (buffer.size() >= BUFFER_SIZE)
+		Flush(buffer);
+}
+
+// WriteFile on a pipe or file may take less than it was given, so it is called until all of it is out.
+
+void BatchScan::Flush(std::string& text) {
+	std::lock_guard<std::mutex> lk(lock_);
+	char const* p = text.data();
+	std::size_t left = text.size();
+	while (left && !failed_)
+	{
+		DWORD wrote = 0;
+		if (!WriteFile(out_, p, static_cast<DWORD>(left), &wrote, NULL) || wrote == 0)
+			failed_ = true;
+		p += wrote;
+		left -= wrote;
+		written_ += wrote;
+	}
+	text.clear();
+}
@@ -0,0 +1,87 @@
+/** @file : BatchScan.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the headless scan that writes the matching files to standard output.
+History : Added so a scan can run from a scheduled job or feed another program, without the console screen.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __BATCH_SCAN_GUARD__
+#define __BATCH_SCAN_GUARD__
+
+#include <Windows.h>
+
+#include "ScanEngine.hpp"
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <regex>
+
+
+// Runs the same walk as the browser, with the same folder, extension filter and recursion, and writes every
+// matching file to standard output as it is found. Several folders separated by ';' are walked at once, as in
+// the browser. Each worker fills its own large buffer and only takes the lock to hand a full buffer to the
+// output in one write, so output costs one system call per buffer rather than one per file. Files are written
+// in the order they are found, not sorted.
+
+class BatchScan
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		enum Format
+		{
+			LINES,		// one path per line
+			NUL,		// paths ended by a NUL character, for xargs -0
+			NDJSON		// one JSON object per line with the path, size and last write time
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::string					folder_;
+		std::string					filter_;
+		bool						recurse_;
+		Format						format_;
+
+		HANDLE						out_;
+		std::mutex					lock_;
+		std::vector<std::string>	buffers_;
+		std::atomic<bool>			failed_;
+		unsigned long long			written_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		BatchScan(std::string const& folder, std::string const& filter, bool recurse, Format format);
+
+		BatchScan(BatchScan const&) = delete;
+		void operator=(BatchScan const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Scans and writes the matching files. Returns the process exit code: 0 when every file was written,
+		 // 1 if the output could not be written (for instance the reader of a pipe went away), 2 if the filter
+		 // is not a valid regular expression or the walk failed. Errors go to standard error, as does a count
+		 // of the files and folders skipped because they could not be read.
+
+		int Run();
+
+	// -------- ACCESSORS --------
+	public:
+		// Bytes written to standard output by the last run.
+		unsigned long long GetWritten() const { return written_; }
+
+	private:
+
+		 // Appends the record for one file to the worker's buffer, and writes the buffer out once it is full.
+
+		void Emit(unsigned worker, std::tr2::sys::path const& file, ScanErrors& errors);
+
+		 // Writes out text and empties it. Once a write fails nothing more is written.
+
+		void Flush(std::string& text);
+};
+
+#endif
@@ -0,0 +1,226 @@
+/** @file : BulkDelete.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for deleting the files of a listing, and the folders that leaves empty.
+History : Added so matched files can be cleaned up without leaving the browser.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "BulkDelete.hpp"
+#include "ThreadPool.hpp"
+
+#include <set>
+#include <map>
+#include <chrono>
+#include <algorithm>
+#include <Windows.h>
+
+
+// POSIX deletes came with Windows 10 and its SDK; built against an older SDK, they are declared here. Older systems
+// turn the request down at run time, and deletes fall back to the older kind.
+#ifndef FILE_DISPOSITION_FLAG_DELETE
+#define FILE_DISPOSITION_FLAG_DELETE					0x00000001
+#define FILE_DISPOSITION_FLAG_POSIX_SEMANTICS			0x00000002
+#define FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE	0x00000010
+
+typedef struct _FILE_DISPOSITION_INFO_EX
+{
+	DWORD Flags;
+} FILE_DISPOSITION_INFO_EX;
+#endif
+
+namespace {
+	// FileDispositionInfoEx, which older SDKs do not name.
+	FILE_INFO_BY_HANDLE_CLASS const DISPOSITION_INFO_EX = static_cast<FILE_INFO_BY_HANDLE_CLASS>(21);
+
+	std::string Lower(std::string text) {
+		for (auto& c : text)
+			c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+		return text;
+	}
+}
+
+// -------- CONSTRUCTOR --------
+
+BulkDelete::BulkDelete(std::vector<std::string> paths, std::vector<std::string> const& keep) : paths_(std::move(paths)), cancel_(false), posix_(true),
+	plan_(), files_(0), bytes_(0), missing_(0), folders_(0), failed_(0), seconds_(0) {
+	std::sort(paths_.begin(), paths_.end());
+	paths_.erase(std::unique(paths_.begin(), paths_.end()), paths_.end());
+
+	for (auto const& k : keep)
+	{
+		std::string folder = Lower(k);
+		std::replace(folder.begin(), folder.end(), '/', '\\');
+		if (!folder.empty() && folder.back() != '\\')
+			folder += '\\';
+		keep_.push_back(folder);
+	}
+}
+
+// -------- OPERATIONS --------
+
+void BulkDelete::Survey(std::function<void()> const& tick) {
+	auto start = std::chrono::steady_clock::now();
+	sizes_.assign(paths_.size(), MISSING);
+
+	ThreadPool pool;
+	pool.ParallelFor(paths_.size(), [&](unsigned, std::size_t i) {
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if (GetFileAttributesExA(paths_[i].c_str(), GetFileExInfoStandard, &data) && !(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			sizes_[i] = static_cast<unsigned long long>(data.nFileSizeHigh) << 32 | data.nFileSizeLow;
+	}, tick, &cancel_);
+
+	plan_ = Stats();
+	for (auto size : sizes_)
+	{
+		if (size == MISSING)
+			++plan_.missing_;
+		else
+		{
+			++plan_.files_;
+			plan_.bytes_ += size;
+		}
+	}
+	plan_.cancelled_ = cancel_;
+	plan_.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool BulkDelete::Run(std::function<void()> const& tick) {
+	auto start = std::chrono::steady_clock::now();
+	std::vector<char> deleted(paths_.size(), 0);
+
+	ThreadPool pool;
+	pool.ParallelFor(paths_.size(), [&](unsigned, std::size_t i) {
+		if (i >= sizes_.size() || sizes_[i] == MISSING)
+			return;
+
+		unsigned long error = 0;
+		if (Unlink(paths_[i], error))
+		{
+			deleted[i] = 1;
+			files_.fetch_add(1, std::memory_order_relaxed);
+			bytes_.fetch_add(sizes_[i], std::memory_order_relaxed);
+		}
+		else if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+			missing_.fetch_add(1, std::memory_order_relaxed);
+		else
+		{
+			failed_.fetch_add(1, std::memory_order_relaxed);
+			std::lock_guard<std::mutex> lk(lock_);
+			Failure failure = { paths_[i], error };
+			failures_.push_back(failure);
+		}
+	}, tick, &cancel_);
+
+	RemoveFolders(deleted, tick);
+	seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return !cancel_ && failed_ == 0;
+}
+
+std::vector<BulkDelete::Failure> BulkDelete::TakeFailures() {
+	std::lock_guard<std::mutex> lk(lock_);
+	std::vector<Failure> failures;
+	failures.swap(failures_);
+	return failures;
+}
+
+// The older kind of delete only marks the file, and is turned down for a read-only one; the attribute is then
+// cleared and the delete tried again.
+
+bool BulkDelete::Unlink(std::string const& path, unsigned long& error) {
+	HANDLE file = CreateFileA(path.c_str(), DELETE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_OPEN_REPARSE_POINT, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		error = GetLastError();
+		return false;
+	}
+
+	bool done = false;
+	if (posix_)
+	{
+		FILE_DISPOSITION_INFO_EX disposition;
+		disposition.Flags = FILE_DISPOSITION_FLAG_DELETE | FILE_DISPOSITION_FLAG_POSIX_SEMANTICS | FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE;
+		done = SetFileInformationByHandle(file, DISPOSITION_INFO_EX, &disposition, sizeof(disposition)) != FALSE;
+
+		DWORD const e = done ? ERROR_SUCCESS : GetLastError();
+		if (e == ERROR_INVALID_PARAMETER || e == ERROR_NOT_SUPPORTED || e == ERROR_INVALID_FUNCTION)
+			posix_ = false;
+		else if (!done)
+		{
+			error = e;
+			CloseHandle(file);
+			return false;
+		}
+	}
+	if (!done)
+	{
+		FILE_DISPOSITION_INFO disposition;
+		disposition.DeleteFile = TRUE;
+		done = SetFileInformationByHandle(file, FileDispositionInfo, &disposition, sizeof(disposition)) != FALSE;
+		if (!done && GetLastError() == ERROR_ACCESS_DENIED)
+		{
+			DWORD const attributes = GetFileAttributesA(path.c_str());
+			if (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_READONLY) && SetFileAttributesA(path.c_str(), attributes & ~FILE_ATTRIBUTE_READONLY))
+				done = SetFileInformationByHandle(file, FileDispositionInfo, &disposition, sizeof(disposition)) != FALSE;
+		}
+		if (!done)
+			error = GetLastError();
+	}
+
+	CloseHandle(file);
+	return done;
+}
+
+// Every folder between a deleted file and the folder kept above it is a candidate. They go one depth at a time, from
+// the deepest, so a folder is only tried once everything that could have been under it is gone; the folders of one
+// depth are removed in parallel. A folder that still has something in it is simply not removed.
+
+void BulkDelete::RemoveFolders(std::vector<char> const& deleted, std::function<void()> const& tick) {
+	std::set<std::string> candidates;
+	for (std::size_t i = 0; i < paths_.size(); ++i)
+	{
+		if (!deleted[i])
+			continue;
+
+		std::string const& path = paths_[i];
+		std::string const lower = Lower(path);
+		std::size_t under = 0;
+		for (auto const& k : keep_)
+			if (k.size() > under && lower.size() > k.size() && lower.compare(0, k.size(), k) == 0)
+				under = k.size();
+		if (!under)
+			continue;
+
+		for (std::string::size_type slash = path.find_last_of("\\/"); slash != std::string::npos && slash >= under; slash = path.find_last_of("\\/", slash - 1))
+			if (!candidates.insert(path.substr(0, slash)).second)
+				break;
+	}
+
+	std::map<std::size_t, std::vector<std::string>> depths;
+	for (auto const& folder : candidates)
+		depths[std::count(folder.begin(), folder.end(), '\\') + std::count(folder.begin(), folder.end(), '/')].push_back(folder);
+
+	ThreadPool pool;
+	for (auto d = depths.rbegin(); d != depths.rend() && !cancel_; ++d)
+	{
+		std::vector<std::string> const& folders = d->second;
+		pool.ParallelFor(folders.size(), [&](unsigned, std::size_t i) {
+			if (RemoveDirectoryA(folders[i].c_str()))
+				folders_.fetch_add(1, std::memory_order_relaxed);
+		}, tick, &cancel_);
+	}
+}
+
+// -------- ACCESSORS --------
+
+BulkDelete::Stats BulkDelete::GetStats() const {
+	Stats s;
+	s.files_ = files_;
+	s.bytes_ = bytes_;
+	s.missing_ = missing_;
+	s.folders_ = folders_;
+	s.failed_ = failed_;
+	s.seconds_ = seconds_;
+	s.cancelled_ = cancel_;
+	return s;
+}
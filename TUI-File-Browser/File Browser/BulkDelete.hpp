@@ -0,0 +1,127 @@
+/** @file : BulkDelete.hpp
+Name : Fayomi Augustine
+Purpose: Header file for deleting the files of a listing, and the folders that leaves empty.
+History : Added so matched files can be cleaned up without leaving the browser.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __BULK_DELETE_GUARD__
+#define __BULK_DELETE_GUARD__
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+
+
+// Deletes a set of files on the thread pool, in two steps. Survey is the dry run: it looks every file up and counts
+// what would go, changing nothing. Run then deletes what the survey found, and afterwards removes the folders that
+// are left empty, deepest first, up to but never including the folders kept.
+//
+// The files are taken in path order, so each worker's share is a run of neighbouring files in a few folders. Each is
+// deleted through one handle opened for deletion only, with POSIX semantics where the file system has them: the name
+// goes at once, even if another process has the file open, so its folder can be removed straight after. Read-only
+// files are deleted as well. A symbolic link is deleted, never what it points at.
+
+class BulkDelete
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		struct Failure
+		{
+			std::string		path_;
+			unsigned long	error_;		// the system error code
+		};
+
+		struct Stats
+		{
+			unsigned long long	files_;			// files found, or deleted
+			unsigned long long	bytes_;			// their size
+			unsigned long long	missing_;		// files already gone
+			unsigned long long	folders_;		// folders removed
+			unsigned long long	failed_;
+			double				seconds_;
+			bool				cancelled_;
+		};
+
+		// Size recorded for a file the survey did not find.
+		static unsigned long long const MISSING = ~0ull;
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::vector<std::string>		paths_;
+		std::vector<unsigned long long>	sizes_;		// per path, from the survey
+		std::vector<std::string>		keep_;		// lower case, each with a separator after it
+		std::atomic<bool>				cancel_;
+
+		// Cleared the first time the file system turns POSIX deletes down, after which deletes use the older kind.
+		std::atomic<bool>				posix_;
+
+		std::mutex				lock_;
+		std::vector<Failure>	failures_;
+
+		Stats							plan_;
+		std::atomic<unsigned long long>	files_;
+		std::atomic<unsigned long long>	bytes_;
+		std::atomic<unsigned long long>	missing_;
+		std::atomic<unsigned long long>	folders_;
+		std::atomic<unsigned long long>	failed_;
+		double							seconds_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Sets up the deletion of paths. Emptied folders are removed only inside one of keep, and never keep itself.
+
+		BulkDelete(std::vector<std::string> paths, std::vector<std::string> const& keep);
+
+		BulkDelete(BulkDelete const&) = delete;
+		void operator=(BulkDelete const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Looks up every file and counts the files and bytes Run would delete. Nothing is changed. tick is called
+		 // on this thread at a fixed interval.
+
+		void Survey(std::function<void()> const& tick = std::function<void()>());
+
+		 // Deletes the files the survey found, then the folders that leaves empty. Returns false if any file could
+		 // not be deleted or the run was cancelled.
+
+		bool Run(std::function<void()> const& tick = std::function<void()>());
+
+		 // Asks a running survey or deletion to stop. Files already deleted stay deleted.
+
+		void Cancel() { cancel_ = true; }
+
+		 // Hands over the files that could not be deleted since the last call.
+
+		std::vector<Failure> TakeFailures();
+
+	// -------- ACCESSORS --------
+	public:
+
+		 // What the survey found.
+
+		Stats const& GetPlan() const { return plan_; }
+
+		 // What Run has done so far.
+
+		Stats GetStats() const;
+
+	private:
+
+		 // Deletes the file at path. Returns false, with the system error in error, if it cannot.
+
+		bool Unlink(std::string const& path, unsigned long& error);
+
+		 // Removes the folders above the files deleted that are now empty, deepest first.
+
+		void RemoveFolders(std::vector<char> const& deleted, std::function<void()> const& tick);
+};
+
+#endif
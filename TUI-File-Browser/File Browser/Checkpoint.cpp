@@ -0,0 +1,269 @@
+/** @file : Checkpoint.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for saving a running scan's progress to disk and picking it up again.
+History : Added so a scan of a very large archive that is interrupted does not start again from nothing.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Checkpoint.hpp"
+#include "Hashing.hpp"
+#include "FileIO.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <Windows.h>
+
+
+namespace {
+	char const MAGIC[4] = { 'T', 'C', 'K', 'P' };
+	char const DELTA_MAGIC[4] = { 'T', 'C', 'K', 'D' };
+	unsigned const VERSION = 1;
+
+	// Bytes buffered on each side.
+	std::size_t const BUFFER_SIZE = 1024 * 1024;
+
+	// Longest path or key read back; anything longer means the file is damaged.
+	unsigned const MAX_STRING = 32768;
+
+	template <typename T>
+	void Put(std::ofstream& out, T value) {
+		out.write(reinterpret_cast<char const*>(&value), sizeof(value));
+	}
+
+	void PutString(std::ofstream& out, std::string const& text) {
+		Put(out, static_cast<unsigned>(text.size()));
+		out.write(text.data(), text.size());
+	}
+
+	template <typename T>
+	bool Get(std::ifstream& in, T& value) {
+		return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+	}
+
+	bool GetString(std::ifstream& in, std::string& text) {
+		unsigned length = 0;
+		if (!Get(in, length) || length > MAX_STRING)
+			return false;
+		text.resize(length);
+		return length == 0 || static_cast<bool>(in.read(&text[0], length));
+	}
+
+	bool GetMagic(std::ifstream& in, char const (&magic)[4]) {
+		char read[4];
+		unsigned version = 0;
+		return in.read(read, sizeof(read)) && std::equal(read, read + 4, magic) && Get(in, version) && version == VERSION;
+	}
+
+	// Closes out, a file written aside at path + ".tmp", and moves it over path.
+	bool Commit(std::ofstream& out, std::string const& path) {
+		out.close();
+		std::string const temp = path + ".tmp";
+		if (out.fail())
+		{
+			DeleteFileA(temp.c_str());
+			return false;
+		}
+		return MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+	}
+
+	// Adds one delta's files and folders to files and folders.
+	bool ReadDelta(std::string const& path, std::vector<FileEntry>& files, std::vector<FolderEntry>& folders) {
+		std::vector<char> buffer(BUFFER_SIZE);
+		std::ifstream in;
+		in.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+		in.open(path, std::ios::binary);
+
+		unsigned long long fileCount = 0, folderCount = 0;
+		if (!GetMagic(in, DELTA_MAGIC) || !Get(in, fileCount) || !Get(in, folderCount))
+			return false;
+
+		for (unsigned long long i = 0; i < fileCount; ++i)
+		{
+			FileEntry f;
+			if (!GetString(in, f.path_) || !Get(in, f.size_) || !Get(in, f.mtime_))
+				return false;
+			files.push_back(f);
+		}
+		for (unsigned long long i = 0; i < folderCount; ++i)
+		{
+			FolderEntry f;
+			if (!GetString(in, f.path_) || !Get(in, f.stamp_))
+				return false;
+			folders.push_back(f);
+		}
+		return true;
+	}
+}
+
+
+// -------- CONSTRUCTOR --------
+
+// Named after a hash of the key, as snapshots are named after a hash of their folder; the key itself is kept
+// in the file, so two keys with the same hash cannot pick up each other's scan.
+
+ScanCheckpoint::ScanCheckpoint(std::string const& key) : key_(key), deltas_(0), found_(0) {
+	std::string const cache = GetCacheFolder();
+	if (cache.empty())
+		return;
+
+	Hash128 hash;
+	hash.Update(key.data(), key.size());
+	Hash128::Digest const d = hash.Final();
+
+	std::ostringstream name;
+	name << std::hex << std::setfill('0') << std::setw(16) << static_cast<unsigned long long>(d.hi_ ^ d.lo_);
+	path_ = cache + "scan-" + name.str() + ".checkpoint";
+}
+
+// -------- OPERATIONS --------
+
+// Every delta is read into scratch vectors first, so a checkpoint with a delta missing or cut short leaves the
+// caller's files and folders untouched, and the scan starts over.
+
+bool ScanCheckpoint::Load(State& state, std::vector<FileEntry>& files, std::vector<FolderEntry>& folders) {
+	if (path_.empty())
+		return false;
+
+	std::vector<char> buffer(BUFFER_SIZE);
+	std::ifstream in;
+	in.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+	in.open(path_, std::ios::binary);
+
+	std::string key;
+	unsigned deltas = 0, roots = 0, leaders = 0;
+	unsigned long long pending = 0;
+	State read;
+	if (!GetMagic(in, MAGIC) || !GetString(in, key) || key != key_ || !Get(in, deltas))
+		return false;
+	found_ = deltas;
+	if (!Get(in, read.searched_) || !Get(in, read.matched_) || !Get(in, read.bytes_) || !Get(in, roots) || roots > MAX_STRING)
+		return false;
+
+	read.rootMatched_.resize(roots);
+	read.rootBytes_.resize(roots);
+	for (unsigned r = 0; r < roots; ++r)
+		if (!Get(in, read.rootMatched_[r]) || !Get(in, read.rootBytes_[r]))
+			return false;
+
+	if (!Get(in, pending))
+		return false;
+	for (unsigned long long i = 0; i < pending; ++i)
+	{
+		std::string folder;
+		if (!GetString(in, folder))
+			return false;
+		read.pending_.push_back(folder);
+	}
+
+	if (!Get(in, leaders))
+		return false;
+	for (unsigned i = 0; i < leaders; ++i)
+	{
+		FileEntry f;
+		if (!GetString(in, f.path_) || !Get(in, f.size_) || !Get(in, f.mtime_))
+			return false;
+		read.leaders_.push_back(f);
+	}
+
+	std::vector<FileEntry> readFiles;
+	std::vector<FolderEntry> readFolders;
+	for (unsigned delta = 0; delta < deltas; ++delta)
+		if (!ReadDelta(DeltaPath(delta), readFiles, readFolders))
+			return false;
+
+	state = read;
+	files.insert(files.end(), readFiles.begin(), readFiles.end());
+	folders.insert(folders.end(), readFolders.begin(), readFolders.end());
+	deltas_ = deltas;
+	return true;
+}
+
+// The delta goes first: until the checkpoint naming it is in place, it is an extra file a later load ignores
+// and the next save writes over.
+
+bool ScanCheckpoint::Save(State const& state, std::vector<FileEntry> const& files, std::vector<FolderEntry> const& folders) {
+	if (path_.empty())
+		return false;
+
+	std::vector<char> buffer(BUFFER_SIZE);
+	std::string const delta = DeltaPath(deltas_);
+	{
+		std::ofstream out;
+		out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+		out.open(delta + ".tmp", std::ios::binary | std::ios::trunc);
+
+		out.write(DELTA_MAGIC, sizeof(DELTA_MAGIC));
+		Put(out, VERSION);
+		Put(out, static_cast<unsigned long long>(files.size()));
+		Put(out, static_cast<unsigned long long>(folders.size()));
+		for (auto const& f : files)
+		{
+			PutString(out, f.path_);
+			Put(out, f.size_);
+			Put(out, f.mtime_);
+		}
+		for (auto const& f : folders)
+		{
+			PutString(out, f.path_);
+			Put(out, f.stamp_);
+		}
+		if (!Commit(out, delta))
+			return false;
+	}
+
+	std::ofstream out;
+	out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+	out.open(path_ + ".tmp", std::ios::binary | std::ios::trunc);
+
+	out.write(MAGIC, sizeof(MAGIC));
+	Put(out, VERSION);
+	PutString(out, key_);
+	Put(out, deltas_ + 1);
+	Put(out, state.searched_);
+	Put(out, state.matched_);
+	Put(out, state.bytes_);
+	Put(out, static_cast<unsigned>(state.rootMatched_.size()));
+	for (std::size_t r = 0; r < state.rootMatched_.size(); ++r)
+	{
+		Put(out, state.rootMatched_[r]);
+		Put(out, r < state.rootBytes_.size() ? state.rootBytes_[r] : 0ull);
+	}
+	Put(out, static_cast<unsigned long long>(state.pending_.size()));
+	for (auto const& folder : state.pending_)
+		PutString(out, folder);
+	Put(out, static_cast<unsigned>(state.leaders_.size()));
+	for (auto const& f : state.leaders_)
+	{
+		PutString(out, f.path_);
+		Put(out, f.size_);
+		Put(out, f.mtime_);
+	}
+	if (!Commit(out, path_))
+		return false;
+
+	++deltas_;
+	return true;
+}
+
+// Every delta the checkpoint named is deleted, whether or not it could be loaded, and then the ones after it until
+// one is not there: a save stopped between writing its delta and the checkpoint leaves one past the last.
+
+void ScanCheckpoint::Remove() {
+	if (path_.empty())
+		return;
+
+	DeleteFileA(path_.c_str());
+	unsigned const known = deltas_ > found_ ? deltas_ : found_;
+	for (unsigned delta = 0; ; ++delta)
+		if (!DeleteFileA(DeltaPath(delta).c_str()) && GetLastError() == ERROR_FILE_NOT_FOUND && delta >= known)
+			break;
+	deltas_ = 0;
+	found_ = 0;
+}
+
+std::string ScanCheckpoint::DeltaPath(unsigned delta) const {
+	return path_ + "-" + std::to_string(delta);
+}
@@ -0,0 +1,88 @@
+/** @file : Checkpoint.hpp
+Name : Fayomi Augustine
+Purpose: Header file for saving a running scan's progress to disk and picking it up again.
+History : Added so a scan of a very large archive that is interrupted does not start again from nothing.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __CHECKPOINT_GUARD__
+#define __CHECKPOINT_GUARD__
+
+#include "ScanEngine.hpp"
+
+#include <string>
+#include <vector>
+
+
+// Where a recursive scan had got to, kept in the cache folder under a name made from what the scan was asked
+// for. A checkpoint is taken while the walk is paused, so every folder is either listed in full or still queued:
+// the files and folders found since the last checkpoint are written to a delta of their own, then the queue and
+// the counters are written over the checkpoint file, naming the deltas that go with it. Each file is written
+// aside and moved into place, so a browser stopped part way through leaves the last checkpoint whole. A scan of
+// the same folders picks up from there: the deltas are read back, and the walk starts from the queue.
+
+class ScanCheckpoint
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// Everything but the files and folders, which go to the deltas.
+		struct State
+		{
+			unsigned long long					searched_;	// files and folders looked at
+			unsigned long long					matched_;
+			unsigned long long					bytes_;		// size of the matched files
+			std::vector<unsigned long long>		rootMatched_;
+			std::vector<unsigned long long>		rootBytes_;
+			std::vector<std::string>			pending_;	// folders queued and not yet listed
+			std::vector<FileEntry>				leaders_;	// the largest/newest leaderboard
+
+			State() : searched_(0), matched_(0), bytes_(0) { };
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::string	key_;
+		std::string	path_;		// empty without a cache folder
+		unsigned	deltas_;
+		unsigned	found_;		// deltas named by the checkpoint last read, even one that could not be loaded
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Sets up the checkpoint of a scan described by key: its folders, filter and listing, anything that
+		 // would change what it finds.
+
+		ScanCheckpoint(std::string const& key);
+
+		ScanCheckpoint(ScanCheckpoint const&) = delete;
+		void operator=(ScanCheckpoint const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Reads the checkpoint left by an earlier scan with the same key, adding its files and folders to files
+		 // and folders. Returns false, leaving them as they were, if there is none or it cannot be read whole.
+
+		bool Load(State& state, std::vector<FileEntry>& files, std::vector<FolderEntry>& folders);
+
+		 // Writes files and folders, those found since the last save, as a new delta, then the state. Returns
+		 // false if either cannot be written, in which case the last checkpoint stands.
+
+		bool Save(State const& state, std::vector<FileEntry> const& files, std::vector<FolderEntry> const& folders);
+
+		 // Deletes the checkpoint and its deltas, once the scan is done or its checkpoint could not be loaded.
+
+		void Remove();
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsEnabled() const { return !path_.empty(); }
+		unsigned GetDeltaCount() const { return deltas_; }
+
+	private:
+		std::string DeltaPath(unsigned delta) const;
+};
+
+#endif
@@ -90,6 +90,13 @@ Console& Console::Write(WORD const x, WORD const y, std::string content, Foregro
 	return *this;
 }
 
+// Moves a rectangle of the console up by calling the ConsoleAPI wrapper function.
+
+Console& Console::ScrollUp(WORD const x, WORD const y, WORD const width, WORD const height, WORD const lines, ForegroundColour foreground, BackgroundColour background) {
+	console_.ScrollUp(x, y, width, height, lines, foreground, background);
+	return *this;
+}
+
 // Clears the screen and sets a background color by calling the ConsoleAPI wrapper function.
 
 Console& Console::Clear(BackgroundColour background) {
@@ -111,6 +118,33 @@ Console& Console::GetEvent(std::vector<INPUT_RECORD>& buffer, DWORD& num)
   }
 
 
+// Reads the pending events by calling the ConsoleAPI wrapper functions, but only when there are some,
+// so the call never blocks.
+
+Console& Console::PollEvents(std::vector<INPUT_RECORD>& buffer, DWORD& num)
+  {
+	  num = 0;
+	  DWORD pending = console_.ThinGetNumberOfConsoleInputEvents();
+	  if (pending == 0)
+		  return *this;
+
+	  buffer = std::vector<INPUT_RECORD>(pending);
+	  console_.ThinReadConsoleInput(buffer.data(), buffer.size(), &num);
+
+	  return *this;
+  }
+
+
+// Waits for input by calling the ConsoleAPI wrapper function, so the caller can do other work
+// while the user is idle.
+
+Console& Console::WaitForEvent(DWORD ms, bool& ready)
+  {
+	  ready = console_.ThinWaitForConsoleInput(ms);
+	  return *this;
+  }
+
+
 // Gets the current working directory that the executable of this program is located in 
 // by calling the ConsoleAPI wrapper function.
 
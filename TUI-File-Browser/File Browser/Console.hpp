@@ -63,6 +63,10 @@ class Console
 		// Used to write text or content to the console at a specific coordinate.
 		
 		Console& Write(WORD const x, WORD const y, std::string content, ForegroundColour foreground, BackgroundColour background);
+
+		// Moves a rectangle of the console up by lines rows, blanking the rows it leaves behind.
+
+		Console& ScrollUp(WORD const x, WORD const y, WORD const width, WORD const height, WORD const lines, ForegroundColour foreground, BackgroundColour background);
 	
 		// Clears the screen and sets a background color. Similar to SetBackgroundColour.
 		
@@ -73,6 +77,14 @@ class Console
 
 		Console& GetEvent(std::vector<INPUT_RECORD>& buffer, DWORD& num);
 
+		// Reads whatever events are waiting without blocking; num is zero when there were none.
+
+		Console& PollEvents(std::vector<INPUT_RECORD>& buffer, DWORD& num);
+
+		// Waits up to ms milliseconds for input; ready is set when there is an event to read.
+
+		Console& WaitForEvent(DWORD ms, bool& ready);
+
 		
 		//Gets the current working directory that the executable of this program is located in.
 		
@@ -34,6 +34,11 @@ ConsoleAPI::State ConsoleAPI::GetState() const {
 	// Pull in data from current console state and store in state object.
 	ConsoleAPI::State state;
 
+	// Output redirected to a file or pipe, or no console at all as in a scheduled job: there is no screen to save.
+	DWORD outMode;
+	if (!GetConsoleMode(hStdOut_, &outMode))
+		return state;
+
 	try
 	{
 		// Get window and buffer size.
@@ -53,6 +58,8 @@ ConsoleAPI::State ConsoleAPI::GetState() const {
 		// Get console title.
 		DWORD length = GetConsoleTitleA((LPSTR)state.title_.c_str(), state.title_.size());
 		THROW_IF_CONSOLE_ERROR(length == 0); // Return value of title is length of title, if fails length is zero and GetLastError() contains error code.
+
+		state.saved_ = true;
 	}
 	catch (ConsoleAPI::XError& e)
 	{
@@ -67,6 +74,9 @@ ConsoleAPI::State ConsoleAPI::GetState() const {
 // and info, console mode and console title.
 
 ConsoleAPI& ConsoleAPI::SetState(State const& state) {
+	if (!state.saved_)
+		return *this;
+
 	try
 	{
 		// Set window, console buffer, and desktop data.
@@ -322,6 +332,28 @@ ConsoleAPI& ConsoleAPI::Write(WORD const x, WORD const y, std::string content, F
 	return *this;
 }
 
+// Moves the rectangle's contents up in one call, so a view that only gained a few rows at the bottom
+// need not rewrite the rows it already shows.
+
+ConsoleAPI& ConsoleAPI::ScrollUp(WORD const x, WORD const y, WORD const width, WORD const height, WORD const lines, ForegroundColour foreground, BackgroundColour background) {
+	try
+	{
+		SMALL_RECT area{ SHORT(x), SHORT(y), SHORT(x + width - 1), SHORT(y + height - 1) };
+		COORD dest{ SHORT(x), SHORT(y - lines) };
+		CHAR_INFO fill;
+		fill.Char.AsciiChar = ' ';
+		fill.Attributes = (WORD)foreground | (WORD)background;
+
+		THROW_IF_CONSOLE_ERROR(ScrollConsoleScreenBufferA(hStdOut_, &area, &area, dest, &fill));
+	}
+	catch (ConsoleAPI::XError& e)
+	{
+		MessageBoxA(NULL, e.GetFormattedMessage().c_str(), "Runtime Error", MB_OK);
+	}
+
+	return *this;
+}
+
 // background - the colour of the console background and set the cursor at left side
 
 ConsoleAPI& ConsoleAPI::Clear(BackgroundColour background) {
@@ -356,6 +388,24 @@ void ConsoleAPI::ThinReadConsoleInput(PINPUT_RECORD lpBuffer, unsigned long nLen
 }
 
 
+//gets the number of events waiting in the console input buffer
+DWORD ConsoleAPI::ThinGetNumberOfConsoleInputEvents()
+{
+	DWORD num = 0;
+	THROW_IF_CONSOLE_ERROR(GetNumberOfConsoleInputEvents(hStdIn_, &num));
+	return num;
+}
+
+
+//waits for the console input buffer to have something in it
+bool ConsoleAPI::ThinWaitForConsoleInput(DWORD ms)
+{
+	DWORD result = WaitForSingleObject(hStdIn_, ms);
+	THROW_IF_CONSOLE_ERROR((result != WAIT_FAILED));
+	return result == WAIT_OBJECT_0;
+}
+
+
 // gets directory from command argumeent also used as the default "root-folder" search for the program when start up
 
 std::string ConsoleAPI::GetCurrentDir() {
@@ -43,6 +43,10 @@ class ConsoleAPI
 				COORD						bufferCoord_;
 				DWORD						mode_;
 				std::string					title_;
+				bool						saved_;		// false when stdout is not a console, so there is nothing to restore
+
+			public:
+				State() : mode_(0), saved_(false) { };
 			};
 		class XError
 		{
@@ -121,6 +125,10 @@ class ConsoleAPI
 		 // Used to write text or content to the console at a specific coordinate.
 		
 		ConsoleAPI& Write(WORD const x, WORD const y, std::string content, ForegroundColour foreground, BackgroundColour background);
+
+		 // Moves a rectangle of the console up by lines rows, blanking the rows it leaves behind.
+
+		ConsoleAPI& ScrollUp(WORD const x, WORD const y, WORD const width, WORD const height, WORD const lines, ForegroundColour foreground, BackgroundColour background);
 	
 		 // Clears the screen and sets a background color. Similar to SetBackgroundColour.
 		
@@ -133,6 +141,14 @@ class ConsoleAPI
 
 		void ThinReadConsoleInput(PINPUT_RECORD lpBuffer, unsigned long nLength, LPDWORD lpNumberOfEventsRead);
 
+		 // Returns the number of input events waiting to be read, without blocking.
+
+		DWORD ThinGetNumberOfConsoleInputEvents();
+
+		 // Waits up to ms milliseconds for input to arrive. Returns true when there is input to read.
+
+		bool ThinWaitForConsoleInput(DWORD ms);
+
 
 	private:
 		
@@ -20,7 +20,7 @@ int main(int argc, char* argv[]) try {
 	return App::_main(argc, argv);
 }
 catch (...) {
-	cout << "Error: an exception has been thrown..." << endl;
+	cerr << "Error: an exception has been thrown..." << endl;
 }
 
 App* App::thisApp = nullptr;
@@ -28,13 +28,13 @@ App* App::thisApp = nullptr;
 App::App() {
 	if (thisApp)
 		throw "Error: App already initialized";
-	cout << "App: starting..." << endl;
+	clog << "App: starting..." << endl;
 	thisApp = this;
 }
 
 
 App::~App() {
-	cout << "App: Goodbye" << endl;
+	clog << "App: Goodbye" << endl;
 }
 
 int App::execute(int argc, char* argv[]) {
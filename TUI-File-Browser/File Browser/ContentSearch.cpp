@@ -0,0 +1,291 @@
+/** @file : ContentSearch.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the multi-threaded content search that runs over a scan's result set.
+History : Added for the matches listing of the file browser.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "ContentSearch.hpp"
+#include "ThreadPool.hpp"
+#include "FileIO.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CONTENT_SEARCH_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+namespace {
+	// Lines longer than this are split rather than carried over, so a file with no newlines
+	// cannot grow the read buffer without bound.
+	std::size_t const MAX_CARRY = 64 << 20;
+
+	// Index of the lowest set bit of a non-zero mask.
+	inline unsigned LowestBit(unsigned mask) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	// Finds the last newline in [begin, end), or returns nullptr.
+	char const* LastNewline(char const* begin, char const* end) {
+		while (end != begin)
+			if (*--end == '\n')
+				return end;
+		return nullptr;
+	}
+}
+
+// -------- CONSTRUCTOR --------
+
+// Builds the Horspool skip table for literal patterns: on a mismatch the window moves by the distance
+// from the last occurrence of the window's final byte to the end of the pattern.
+
+ContentSearch::ContentSearch(std::string const& pattern) : pattern_(pattern), literal_(IsLiteral(pattern)), cancel_(false),
+	files_(0), matchedFiles_(0), binary_(0), unreadable_(0), bytes_(0), hits_(0), seconds_(0) {
+	if (!literal_)
+		regex_ = std::regex(pattern);
+
+	std::fill(skip_, skip_ + 256, pattern_.size());
+	for (std::size_t i = 0; i + 1 < pattern_.size(); ++i)
+		skip_[static_cast<unsigned char>(pattern_[i])] = pattern_.size() - 1 - i;
+}
+
+// -------- OPERATIONS --------
+
+bool ContentSearch::IsLiteral(std::string const& pattern) {
+	return pattern.find_first_of(".^$|()[]{}*+?\\") == std::string::npos;
+}
+
+// Runs one task per file on the work-stealing pool, each worker reusing its own read buffer.
+// The pool stops starting new files once the search is cancelled.
+
+void ContentSearch::Run(std::vector<FileEntry> const& files, std::function<void()> const& tick) {
+	ThreadPool pool;
+	std::vector<std::vector<char>> buffers(pool.GetThreadCount());
+
+	auto start = std::chrono::steady_clock::now();
+
+	if (!pattern_.empty())
+	{
+		pool.ParallelFor(files.size(), [&](unsigned worker, std::size_t i) {
+			SearchFile(files[i].path_, buffers[worker]);
+		}, tick, &cancel_);
+	}
+
+	seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<SearchHit> ContentSearch::TakeHits() {
+	std::vector<SearchHit> hits;
+	std::lock_guard<std::mutex> lk(lock_);
+	hits.swap(pending_);
+	return hits;
+}
+
+ContentSearch::Stats ContentSearch::GetStats() const {
+	Stats s;
+	s.files_ = files_;
+	s.matchedFiles_ = matchedFiles_;
+	s.binary_ = binary_;
+	s.unreadable_ = unreadable_;
+	s.bytes_ = bytes_;
+	s.hits_ = hits_;
+	s.seconds_ = seconds_;
+	s.cancelled_ = cancel_;
+	return s;
+}
+
+// Reads the file in CHUNK sized pieces. Only the complete lines of each piece are searched; the
+// partial line at the end is moved to the front of the buffer and finished by the next read, so
+// line numbers can be kept by counting the newlines between hits. Literal patterns are found
+// across the whole piece at once; regex patterns are tried line by line.
+
+void ContentSearch::SearchFile(std::string const& path, std::vector<char>& buffer) {
+	InputFile in(path, true);
+	if (!in.IsOpen())
+	{
+		++unreadable_;
+		return;
+	}
+
+	std::size_t carry = 0;
+	unsigned long long line = 1;
+	unsigned long long found = 0;
+	bool first = true;
+
+	while (!cancel_)
+	{
+		if (buffer.size() < carry + CHUNK)
+			buffer.resize(carry + CHUNK);
+
+		std::size_t n = in.Read(buffer.data() + carry, CHUNK);
+		bytes_ += n;
+
+		if (first)
+		{
+			first = false;
+			if (std::memchr(buffer.data(), '\0', n < BINARY_PROBE ? n : BINARY_PROBE))
+			{
+				++binary_;
+				return;
+			}
+		}
+
+		char const* begin = buffer.data();
+		char const* end = begin + carry + n;
+		bool eof = n == 0;
+
+		// Search complete lines only, unless this is the last piece or the line is too long to keep.
+		char const* limit = end;
+		if (!eof)
+		{
+			char const* nl = LastNewline(begin, end);
+			if (nl)
+				limit = nl + 1;
+			else if (end - begin < static_cast<std::ptrdiff_t>(MAX_CARRY))
+				limit = begin;
+		}
+
+		if (literal_)
+		{
+			char const* counted = begin;
+			char const* p = begin;
+			char const* hit;
+
+			while (p < limit && (hit = FindLiteral(p, limit)) != nullptr)
+			{
+				line += std::count(counted, hit, '\n');
+				counted = hit;
+
+				char const* ls = hit;
+				while (ls != begin && ls[-1] != '\n')
+					--ls;
+				char const* le = static_cast<char const*>(std::memchr(hit, '\n', limit - hit));
+				if (!le)
+					le = limit;
+
+				Report(path, line, ls, le);
+				++found;
+
+				// One hit per line.
+				p = le;
+			}
+
+			line += std::count(counted, limit, '\n');
+		}
+		else
+		{
+			for (char const* ls = begin; ls < limit;)
+			{
+				char const* nl = static_cast<char const*>(std::memchr(ls, '\n', limit - ls));
+				char const* le = nl ? nl : limit;
+
+				if (std::regex_search(ls, le, regex_))
+				{
+					Report(path, line, ls, le);
+					++found;
+				}
+
+				if (!nl)
+					break;
+
+				++line;
+				ls = nl + 1;
+			}
+		}
+
+		if (eof)
+			break;
+
+		// Keep the partial line for the next read.
+		carry = end - limit;
+		std::memmove(buffer.data(), limit, carry);
+	}
+
+	++files_;
+	if (found)
+		++matchedFiles_;
+}
+
+// With SSE2, sixteen candidate positions are checked at once by comparing the first and last byte of
+// the pattern against two shifted loads; only positions where both match are compared in full. The
+// remainder, and builds without SSE2, use Boyer-Moore-Horspool. Single byte patterns go to memchr.
+
+char const* ContentSearch::FindLiteral(char const* begin, char const* end) const {
+	std::size_t const k = pattern_.size();
+	std::size_t const n = end - begin;
+	char const* needle = pattern_.data();
+
+	if (k == 0 || n < k)
+		return nullptr;
+
+	if (k == 1)
+		return static_cast<char const*>(std::memchr(begin, needle[0], n));
+
+	std::size_t i = 0;
+
+#ifdef CONTENT_SEARCH_SSE2
+	__m128i const firstByte = _mm_set1_epi8(needle[0]);
+	__m128i const lastByte = _mm_set1_epi8(needle[k - 1]);
+
+	for (; i + k - 1 + 16 <= n; i += 16)
+	{
+		__m128i blockFirst = _mm_loadu_si128(reinterpret_cast<__m128i const*>(begin + i));
+		__m128i blockLast = _mm_loadu_si128(reinterpret_cast<__m128i const*>(begin + i + k - 1));
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstByte, blockFirst), _mm_cmpeq_epi8(lastByte, blockLast))));
+
+		while (mask != 0)
+		{
+			unsigned bit = LowestBit(mask);
+			if (std::memcmp(begin + i + bit + 1, needle + 1, k - 2) == 0)
+				return begin + i + bit;
+			mask &= mask - 1;
+		}
+	}
+#endif
+
+	while (i + k <= n)
+	{
+		unsigned char c = static_cast<unsigned char>(begin[i + k - 1]);
+		if (c == static_cast<unsigned char>(needle[k - 1]) && std::memcmp(begin + i, needle, k - 1) == 0)
+			return begin + i;
+		i += skip_[c];
+	}
+
+	return nullptr;
+}
+
+// Trims the line for display and queues it. Once MAX_HITS have been found the search is stopped.
+
+void ContentSearch::Report(std::string const& path, unsigned long long line, char const* begin, char const* end) {
+	if (end != begin && end[-1] == '\r')
+		--end;
+
+	SearchHit hit;
+	hit.path_ = path;
+	hit.line_ = line;
+	hit.text_.assign(begin, end - begin < static_cast<std::ptrdiff_t>(MAX_LINE) ? end : begin + MAX_LINE);
+	std::replace(hit.text_.begin(), hit.text_.end(), '\t', ' ');
+
+	{
+		std::lock_guard<std::mutex> lk(lock_);
+		pending_.push_back(hit);
+	}
+
+	if (++hits_ >= MAX_HITS)
+		cancel_ = true;
+}
@@ -0,0 +1,129 @@
+/** @file : ContentSearch.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the multi-threaded content search that runs over a scan's result set.
+History : Added for the matches listing of the file browser.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __CONTENT_SEARCH_GUARD__
+#define __CONTENT_SEARCH_GUARD__
+
+#include <string>
+#include <vector>
+#include <regex>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include "ScanEngine.hpp"
+
+
+// One matching line.
+
+struct SearchHit
+{
+	std::string			path_;
+	unsigned long long	line_;
+	std::string			text_;
+};
+
+class ContentSearch
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		struct Stats
+		{
+			unsigned long long	files_;			// Files searched to the end (or until cancelled).
+			unsigned long long	matchedFiles_;	// Files with at least one hit.
+			unsigned long long	binary_;		// Files skipped because they look binary.
+			unsigned long long	unreadable_;	// Files that could not be opened.
+			unsigned long long	bytes_;			// Bytes read.
+			unsigned long long	hits_;
+			double				seconds_;
+			bool				cancelled_;
+		};
+
+		// Size of each read. Lines are carried over between reads, so a hit is never split.
+		static std::size_t const CHUNK = 4 << 20;
+
+		// A file is treated as binary if its first BINARY_PROBE bytes contain a NUL.
+		static std::size_t const BINARY_PROBE = 8192;
+
+		// Hits beyond this stop the search, so a pattern like "e" cannot exhaust memory.
+		static std::size_t const MAX_HITS = 100000;
+
+		// Characters of a matching line kept for display.
+		static std::size_t const MAX_LINE = 200;
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::string		pattern_;
+		bool			literal_;
+		std::regex		regex_;
+		std::size_t		skip_[256];
+
+		std::atomic<bool>				cancel_;
+		std::mutex						lock_;
+		std::vector<SearchHit>			pending_;
+
+		std::atomic<unsigned long long>	files_;
+		std::atomic<unsigned long long>	matchedFiles_;
+		std::atomic<unsigned long long>	binary_;
+		std::atomic<unsigned long long>	unreadable_;
+		std::atomic<unsigned long long>	bytes_;
+		std::atomic<unsigned long long>	hits_;
+		double							seconds_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Patterns without regex metacharacters are searched for literally; anything else is compiled
+		 // as a regex and matched line by line. Throws std::regex_error for a bad regex.
+
+		ContentSearch(std::string const& pattern);
+
+		ContentSearch(ContentSearch const&) = delete;
+		void operator=(ContentSearch const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Searches every file on the thread pool. tick is called on this thread at a fixed interval;
+		 // hits found so far can be collected with TakeHits from inside it.
+
+		void Run(std::vector<FileEntry> const& files, std::function<void()> const& tick = std::function<void()>());
+
+		 // Asks a running search to stop. Workers finish the chunk they are on.
+
+		void Cancel() { cancel_ = true; }
+
+		 // Hands over the hits found since the last call.
+
+		std::vector<SearchHit> TakeHits();
+
+		 // True if the pattern contains no regex metacharacters.
+
+		static bool IsLiteral(std::string const& pattern);
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsLiteralSearch() const { return literal_; }
+		Stats GetStats() const;
+
+	private:
+
+		 // Searches one file, reading it in CHUNK sized pieces into buffer.
+
+		void SearchFile(std::string const& path, std::vector<char>& buffer);
+
+		 // Finds the next literal match in [begin, end), or returns nullptr.
+
+		char const* FindLiteral(char const* begin, char const* end) const;
+
+		 // Queues the line [begin, end) as a hit.
+
+		void Report(std::string const& path, unsigned long long line, char const* begin, char const* end);
+};
+
+#endif
@@ -0,0 +1,207 @@
+/** @file : Duplicates.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the staged duplicate file finder that runs over a scan's result set.
+History : Added for the duplicates listing of the file browser.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Duplicates.hpp"
+#include "ThreadPool.hpp"
+#include "FileIO.hpp"
+#include "Hashing.hpp"
+
+#include <atomic>
+#include <algorithm>
+
+
+namespace {
+	// A file still in the running, with the key it is grouped on after the current stage.
+	struct Candidate
+	{
+		FileEntry const*	file_;
+		Hash128::Digest		key_;
+		bool				readable_;
+	};
+
+	bool SameSize(Candidate const& a, Candidate const& b) { return a.file_->size_ == b.file_->size_; }
+	bool SameKey(Candidate const& a, Candidate const& b) { return SameSize(a, b) && a.key_ == b.key_; }
+
+	bool BySizeThenKey(Candidate const& a, Candidate const& b) {
+		if (a.file_->size_ != b.file_->size_)
+			return a.file_->size_ < b.file_->size_;
+		return a.key_ < b.key_;
+	}
+
+	// Keeps only the readable candidates that share their group (as judged by same) with at least one other.
+	// Expects the candidates to be sorted so that each group is contiguous.
+	template <typename Same>
+	std::vector<Candidate> KeepGroups(std::vector<Candidate> const& in, Same same) {
+		std::vector<Candidate> out;
+		for (std::size_t i = 0; i < in.size();)
+		{
+			std::size_t j = i + 1;
+			while (j < in.size() && same(in[i], in[j]))
+				++j;
+
+			if (j - i > 1)
+			{
+				for (std::size_t k = i; k < j; ++k)
+					if (in[k].readable_)
+						out.push_back(in[k]);
+			}
+
+			i = j;
+		}
+
+		// A group may have lost members to unreadable files; drop any that are now alone.
+		if (out.size() != in.size())
+		{
+			std::vector<Candidate> again;
+			for (std::size_t i = 0; i < out.size();)
+			{
+				std::size_t j = i + 1;
+				while (j < out.size() && same(out[i], out[j]))
+					++j;
+				if (j - i > 1)
+					again.insert(again.end(), out.begin() + i, out.begin() + j);
+				i = j;
+			}
+			out.swap(again);
+		}
+
+		return out;
+	}
+}
+
+// -------- CONSTRUCTOR --------
+DuplicateFinder::DuplicateFinder() {
+	stats_ = Stats();
+}
+
+// -------- OPERATIONS --------
+
+// Stage one only needs the sizes the scan already has: a file with a unique size cannot have a duplicate.
+// Stage two hashes the first and last EDGE_BYTES of the survivors, which separates most same-size files
+// (logs, media, archives) for a few KiB each. Stage three streams the whole of whatever is left through the
+// hash in CONTENT_CHUNK reads. Both hashing stages run on the thread pool, one file per task, with a read
+// buffer per worker. The bytes each stage read are kept in the stats so the savings are visible.
+
+std::vector<DuplicateGroup> DuplicateFinder::Find(std::vector<FileEntry> const& files, std::function<void()> const& tick) {
+	stats_ = Stats();
+	ThreadPool pool;
+
+	// Stage one: group on size.
+	std::vector<Candidate> candidates;
+	candidates.reserve(files.size());
+	for (auto const& f : files)
+	{
+		if (f.size_ == 0)
+			continue;
+
+		Candidate c = { &f, Hash128::Digest(), true };
+		candidates.push_back(c);
+	}
+
+	stats_.candidates_[SIZE] = candidates.size();
+	std::sort(candidates.begin(), candidates.end(), BySizeThenKey);
+	candidates = KeepGroups(candidates, SameSize);
+
+	// Stage two: hash both ends.
+	stats_.candidates_[EDGES] = candidates.size();
+	{
+		std::atomic<unsigned long long> bytes(0);
+		std::vector<std::vector<unsigned char>> buffers(pool.GetThreadCount(), std::vector<unsigned char>(EDGE_BYTES));
+
+		pool.ParallelFor(candidates.size(), [&](unsigned worker, std::size_t i) {
+			Candidate& c = candidates[i];
+			InputFile in(c.file_->path_, false);
+			if (!in.IsOpen())
+			{
+				c.readable_ = false;
+				return;
+			}
+
+			unsigned char* buffer = buffers[worker].data();
+			unsigned long long size = c.file_->size_;
+			Hash128 h;
+
+			std::size_t n = in.ReadAt(0, buffer, EDGE_BYTES);
+			h.Update(buffer, n);
+			bytes += n;
+
+			// Small files were covered by the first read.
+			if (size > EDGE_BYTES)
+			{
+				unsigned long long tail = size > 2 * EDGE_BYTES ? size - EDGE_BYTES : EDGE_BYTES;
+				n = in.ReadAt(tail, buffer, EDGE_BYTES);
+				h.Update(buffer, n);
+				bytes += n;
+			}
+
+			c.key_ = h.Final();
+		}, tick);
+
+		stats_.bytesRead_[EDGES] = bytes;
+	}
+
+	std::sort(candidates.begin(), candidates.end(), BySizeThenKey);
+	candidates = KeepGroups(candidates, SameKey);
+
+	// Stage three: hash everything.
+	stats_.candidates_[CONTENT] = candidates.size();
+	{
+		std::atomic<unsigned long long> bytes(0);
+		std::vector<std::vector<unsigned char>> buffers(pool.GetThreadCount());
+
+		pool.ParallelFor(candidates.size(), [&](unsigned worker, std::size_t i) {
+			Candidate& c = candidates[i];
+			InputFile in(c.file_->path_, true);
+			if (!in.IsOpen())
+			{
+				c.readable_ = false;
+				return;
+			}
+
+			std::vector<unsigned char>& buffer = buffers[worker];
+			if (buffer.empty())
+				buffer.resize(CONTENT_CHUNK);
+
+			Hash128 h;
+			for (std::size_t n; (n = in.Read(buffer.data(), buffer.size())) != 0;)
+			{
+				h.Update(buffer.data(), n);
+				bytes += n;
+			}
+
+			c.key_ = h.Final();
+		}, tick);
+
+		stats_.bytesRead_[CONTENT] = bytes;
+	}
+
+	std::sort(candidates.begin(), candidates.end(), BySizeThenKey);
+	candidates = KeepGroups(candidates, SameKey);
+
+	// Build the groups.
+	std::vector<DuplicateGroup> groups;
+	for (std::size_t i = 0; i < candidates.size();)
+	{
+		DuplicateGroup g;
+		g.size_ = candidates[i].file_->size_;
+
+		std::size_t j = i;
+		for (; j < candidates.size() && SameKey(candidates[i], candidates[j]); ++j)
+			g.paths_.push_back(candidates[j].file_->path_);
+
+		std::sort(g.paths_.begin(), g.paths_.end());
+		stats_.reclaimable_ += g.GetReclaimable();
+		groups.push_back(g);
+		i = j;
+	}
+
+	stats_.groups_ = groups.size();
+	std::sort(groups.begin(), groups.end(), [](DuplicateGroup const& a, DuplicateGroup const& b) { return a.GetReclaimable() > b.GetReclaimable(); });
+
+	return groups;
+}
@@ -0,0 +1,78 @@
+/** @file : Duplicates.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the staged duplicate file finder that runs over a scan's result set.
+History : Added for the duplicates listing of the file browser.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __DUPLICATES_GUARD__
+#define __DUPLICATES_GUARD__
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "ScanEngine.hpp"
+
+
+// A set of files with identical contents.
+
+struct DuplicateGroup
+{
+	unsigned long long			size_;
+	std::vector<std::string>	paths_;
+
+	// Bytes freed by keeping one copy.
+	unsigned long long GetReclaimable() const { return paths_.empty() ? 0 : size_ * (paths_.size() - 1); }
+};
+
+class DuplicateFinder
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// The three passes, cheapest first. Each one only looks at what survived the one before.
+		enum Stage
+		{
+			SIZE,
+			EDGES,
+			CONTENT,
+			STAGE_COUNT
+		};
+
+		struct Stats
+		{
+			unsigned long long candidates_[STAGE_COUNT];	// Files still in the running going into each stage.
+			unsigned long long bytesRead_[STAGE_COUNT];		// Bytes read from disk by each stage.
+			unsigned long long groups_;
+			unsigned long long reclaimable_;
+		};
+
+		// Bytes hashed from each end of a file in the EDGES stage.
+		static std::size_t const EDGE_BYTES = 4096;
+
+		// Read size of the CONTENT stage. Large sequential reads keep the disk streaming.
+		static std::size_t const CONTENT_CHUNK = 1 << 20;
+
+	// -------- CLASS MEMBERS --------
+	private:
+		Stats stats_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		DuplicateFinder();
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Groups files of identical contents. Empty files are ignored. Groups come back largest reclaimable first.
+		 // tick is called on this thread while the hashing stages run.
+
+		std::vector<DuplicateGroup> Find(std::vector<FileEntry> const& files, std::function<void()> const& tick = std::function<void()>());
+
+	// -------- ACCESSORS --------
+	public:
+		Stats const& GetStats() const { return stats_; }
+};
+
+#endif
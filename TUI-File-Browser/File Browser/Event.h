@@ -43,6 +43,7 @@ public:
 		bool KeyDown() const { return ker_.bKeyDown ? true : false; }
 		char AsciiChar() const { return ker_.uChar.AsciiChar; }
 		unsigned short VirtualKeyCode() const { return ker_.wVirtualKeyCode; }
+		unsigned short RepeatCount() const { return ker_.wRepeatCount; }
 	};
 	class Mouse
 	{
@@ -54,6 +55,7 @@ public:
 		enum class MouseType
 		{
 			WHEELED = MOUSE_WHEELED,
+			MOVED = MOUSE_MOVED,
 			BUTTON = 0
 		};
 
@@ -9,11 +9,168 @@ version: 1.0
 #include "FileBrowser.hpp"
 #include <regex>
 #include <sstream>
+#include <iomanip>
+#include <ctime>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <system_error>
 #include "Color.h"
+#include "TopK.hpp"
+#include "Duplicates.hpp"
+#include "ContentSearch.hpp"
+#include "Preview.hpp"
+#include "LineIndex.hpp"
+#include "Follow.hpp"
+#include "Fuzzy.hpp"
+#include "Trigram.hpp"
+#include "PathTree.hpp"
+#include "ThreadPool.hpp"
+#include "Snapshot.hpp"
+#include "Hashing.hpp"
+#include "Throttle.hpp"
+#include "Progress.hpp"
+#include "ResultStore.hpp"
+#include "Checkpoint.hpp"
+#include "ProcessScan.hpp"
+#include "IndexDaemon.hpp"
+#include "Segment.hpp"
+#include "BulkDelete.hpp"
+#include <cstring>
 
 //application status
 bool FileView::done = false;
+bool FileView::previewOn = false;
+std::string FileView::previewPath;
+std::vector<std::string> FileView::previewLines;
+std::unique_ptr<TextPager> FileView::pager;
+std::string FileView::goTo;
+std::unique_ptr<LogFollower> FileView::follower;
+unsigned short FileView::heldKey = 0;
+std::shared_ptr<ScanThrottle> FileView::throttle(new ScanThrottle);
+unsigned long long FileView::budget = 0;
+unsigned FileView::processes = 0;
+ChecksumManifest::Algorithm FileView::checksum = ChecksumManifest::SHA256;
+double FileView::sampledAt = 0;
+unsigned long long FileView::sampledEntries = 0;
 Framework frame = Framework();
+PreviewLoader preview;
+
+namespace {
+	// Where the file viewer's rows are on screen.
+	WORD const VIEW_TOP = 13;
+	WORD const VIEW_ROWS = 29;
+	WORD const VIEW_WIDTH = 128;
+
+	// The preview pane takes the right of the file viewer when it is shown, after a one column separator.
+	WORD const PREVIEW_X = 80;
+	WORD const PREVIEW_WIDTH = 49;
+
+	// Used for reducing file size to MB.
+	double const BYTES_TO_MB = 1048576;
+
+	// Status of a pass turned down because the scan's files were moved to disk.
+	char const* const SPILLED = "Not available: this scan outgrew its memory budget and its files are on disk.";
+
+	// Status of a pass turned down because the file listing is read from the index daemon.
+	char const* const SERVED = "Not available: this listing is read from the index daemon, which holds its files.";
+
+	// The rates [ and ] step between in background mode, in folder listings and file stats per second. ] past
+	// the last lifts the limit, and [ from no limit comes back to it.
+	double const MIN_RATE = 125;
+	double const MAX_RATE = 16000;
+
+	// How often the footer samples a running scan's progress.
+	unsigned const SAMPLE_MS = 250;
+
+	// The key that confirms a delete after its dry run; a letter's virtual key code is its upper case character.
+	unsigned short const CONFIRM_KEY = 'Y';
+
+	// How often a recursive scan saves a checkpoint it can be picked up from.
+	std::chrono::seconds const CHECKPOINT_INTERVAL(30);
+
+	// Lower case, with '\' separators and no trailing separator, so folders typed differently compare equal.
+	std::string NormalFolder(std::string folder) {
+		for (auto& c : folder)
+			c = c == '/' ? '\\' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+		while (folder.size() > 1 && folder.back() == '\\')
+			folder.pop_back();
+		return folder;
+	}
+
+	// The folder with a separator after it, which starts the path of everything in it.
+	std::string UnderFolder(std::string const& folder) {
+		return folder.empty() || folder.back() == '\\' || folder.back() == '/' ? folder : folder + "\\";
+	}
+
+	// Entries of a vector sorted by path_ whose path starts with prefix, which sit next to each other.
+	template <typename Entry>
+	std::pair<std::size_t, std::size_t> UnderPrefix(std::vector<Entry> const& entries, std::string const& prefix) {
+		auto it = std::lower_bound(entries.begin(), entries.end(), prefix, [](Entry const& e, std::string const& p) { return e.path_ < p; });
+		std::size_t const first = it - entries.begin();
+		while (it != entries.end() && it->path_.compare(0, prefix.size(), prefix) == 0)
+			++it;
+		return std::make_pair(first, static_cast<std::size_t>(it - entries.begin()));
+	}
+
+	// Formats a byte count in MB the way the footer does.
+	std::string ToMB(unsigned long long bytes) {
+		std::ostringstream os;
+		os << std::fixed << std::setprecision(2) << bytes / BYTES_TO_MB << "MB";
+		return os.str();
+	}
+
+	// Formats a count of bytes gained or lost, with its sign.
+	std::string ToSignedMB(long long bytes) {
+		return (bytes < 0 ? "-" : "+") + ToMB(static_cast<unsigned long long>(bytes < 0 ? -bytes : bytes));
+	}
+
+	// Formats a time in seconds since 1970 as local date and time.
+	std::string ToLocalTime(long long seconds) {
+		char stamp[32] = "";
+		std::time_t t = static_cast<std::time_t>(seconds);
+		std::tm local;
+		if (localtime_s(&local, &t) == 0)
+			std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+		return stamp;
+	}
+
+	// Orders entries for the largest/newest leaderboards. Ties are broken on path so the
+	// leaderboard does not depend on which worker found a file first.
+	struct RankFiles
+	{
+		FileModel::Listing by_;
+
+		RankFiles(FileModel::Listing by = FileModel::Listing::LARGEST) : by_(by) { };
+
+		bool operator()(FileEntry const& a, FileEntry const& b) const {
+			if (by_ == FileModel::Listing::NEWEST && a.mtime_ != b.mtime_)
+				return a.mtime_ > b.mtime_;
+			if (by_ != FileModel::Listing::NEWEST && a.size_ != b.size_)
+				return a.size_ > b.size_;
+			return a.path_ < b.path_;
+		}
+	};
+
+	// The results one scan worker has gathered. Only the leaderboard is read by another thread
+	// (the tick), so only it is guarded.
+	struct ScanShard
+	{
+		std::mutex							lock_;
+		std::vector<FileEntry>				files_;
+		std::vector<FolderEntry>			folders_;
+		BoundedHeap<FileEntry, RankFiles>	leaders_;
+		unsigned long long					matched_;
+		unsigned long long					bytes_;
+		std::vector<unsigned long long>		rootMatched_;	// matched_ and bytes_ split by root
+		std::vector<unsigned long long>		rootBytes_;
+		unsigned long long					memory_;		// held by files_, as counted against the memory budget
+		std::size_t							savedFiles_;	// files_ and folders_ before these are in a checkpoint
+		std::size_t							savedFolders_;
+
+		ScanShard(RankFiles rank, std::size_t roots) : leaders_(FileModel::LEADERBOARD_SIZE, rank), matched_(0), bytes_(0), rootMatched_(roots, 0), rootBytes_(roots, 0), memory_(0), savedFiles_(0), savedFolders_(0) { };
+	};
+}
 
 
 //Gets the file and creates the console interface
@@ -39,26 +196,47 @@ FileView& FileView::CreateTUI(std::string folder, std::string filter, bool rSear
 
 	// Create labels on the console.
 	frame.AddTextToConsole(Framework::Control::Label("titleLabel", COORD{ 60, 2 }, "TUI FILE BROWSER", ForegroundColour::WHITE, BackgroundColour::GREY));
+	frame.AddTextToConsole(Framework::Control::Label("backgroundLabel", COORD{ 1, 2 }, "BACKGROUND (F11):", ForegroundColour::WHITE, BackgroundColour::GREY));
+	frame.AddTextToConsole(Framework::Control::Label("transferLabel", COORD{ 78, 2 }, "(F1)", ForegroundColour::WHITE, BackgroundColour::GREY));
 	frame.AddTextToConsole(Framework::Control::Label("folderLabel", COORD{ 1, 6 }, "FOLDER:", ForegroundColour::WHITE, BackgroundColour::GREY));
 	frame.AddTextToConsole(Framework::Control::Label("filterLabel", COORD{ 1, 8 }, "FILTER:", ForegroundColour::WHITE, BackgroundColour::GREY));
+	frame.AddTextToConsole(Framework::Control::Label("containsLabel", COORD{ 65, 8 }, "CONTAINS:", ForegroundColour::WHITE, BackgroundColour::GREY));
 	frame.AddTextToConsole(Framework::Control::Label("recursiveLabel", COORD{ 1, 10 }, "RECURSIVE SEARCH?", ForegroundColour::WHITE, BackgroundColour::GREY));
+	frame.AddTextToConsole(Framework::Control::Label("listingLabel", COORD{ 30, 10 }, "LISTING (F2):", ForegroundColour::WHITE, BackgroundColour::GREY));
+	frame.AddTextToConsole(Framework::Control::Label("previewLabel", COORD{ 60, 10 }, "PREVIEW (F4):", ForegroundColour::WHITE, BackgroundColour::GREY));
+	frame.AddTextToConsole(Framework::Control::Label("findLabel", COORD{ 84, 10 }, "FIND (F6):", ForegroundColour::WHITE, BackgroundColour::GREY));
 	frame.AddTextToConsole(Framework::Control::Label("searchedLabel", COORD{ 1, 44 }, "TOTAL SEARCHED:", ForegroundColour::WHITE, BackgroundColour::GREY));
 	frame.AddTextToConsole(Framework::Control::Label("matchingLabel", COORD{ 1, 46 }, "TOTAL MATCHED:", ForegroundColour::WHITE, BackgroundColour::GREY));
 	frame.AddTextToConsole(Framework::Control::Label("fileSizeLabel", COORD{ 1, 48 }, "TOTAL FILESIZE:", ForegroundColour::WHITE, BackgroundColour::GREY));
+	frame.AddTextToConsole(Framework::Control::Label("statusLabel", COORD{ 55, 44 }, "STATUS:", ForegroundColour::WHITE, BackgroundColour::GREY));
+	frame.AddTextToConsole(Framework::Control::Label("impactLabel", COORD{ 55, 46 }, "IMPACT:", ForegroundColour::WHITE, BackgroundColour::GREY));
+	frame.AddTextToConsole(Framework::Control::Label("scanningLabel", COORD{ 55, 48 }, "SCAN:", ForegroundColour::WHITE, BackgroundColour::GREY));
 
 	// Create input boxes for user to change model and view.
 	frame.AddControlToConsole(Framework::Control::InputTextBox("folderInput", COORD{ 10, 6 }, 100, folder, ForegroundColour::BLACK, BackgroundColour::WHITE));
 	frame.AddControlToConsole(Framework::Control::InputTextBox("filterInput", COORD{ 10, 8 }, 50, filter, ForegroundColour::BLACK, BackgroundColour::WHITE));
+	frame.AddControlToConsole(Framework::Control::InputTextBox("containsInput", COORD{ 75, 8 }, 50, "", ForegroundColour::BLACK, BackgroundColour::WHITE));
+	frame.AddControlToConsole(Framework::Control::InputTextBox("findInput", COORD{ 95, 10 }, 30, "", ForegroundColour::BLACK, BackgroundColour::WHITE));
+	frame.AddControlToConsole(Framework::Control::InputTextBox("targetInput", COORD{ 92, 2 }, 35, "", ForegroundColour::BLACK, BackgroundColour::WHITE));
 	frame.AddControlToConsole(Framework::Control::Checkbox("recursiveCheck", COORD{ 20, 10 }, 2, ForegroundColour::BLACK, BackgroundColour::WHITE, rSearch, rSearch ? "X" : " "));
+	frame.AddControlToConsole(Framework::Control::TextBox("tbxListing", COORD{ 44, 10 }, 10, ForegroundColour::BLACK, BackgroundColour::WHITE, "FILES"));
+	frame.AddControlToConsole(Framework::Control::TextBox("tbxPreview", COORD{ 74, 10 }, 3, ForegroundColour::BLACK, BackgroundColour::WHITE, "OFF"));
+	frame.AddControlToConsole(Framework::Control::TextBox("tbxBackground", COORD{ 19, 2 }, 24, ForegroundColour::BLACK, BackgroundColour::WHITE, ""));
+	frame.AddControlToConsole(Framework::Control::TextBox("tbxTransfer", COORD{ 83, 2 }, 8, ForegroundColour::BLACK, BackgroundColour::WHITE, "COPY TO"));
 
 	// Create textboxes we will use to display file stats.
 	frame.AddControlToConsole(Framework::Control::TextBox("tbxSearched", COORD{ 17, 44 }, 35, ForegroundColour::BLACK, BackgroundColour::WHITE, ""));
 	frame.AddControlToConsole(Framework::Control::TextBox("tbxMatched", COORD{ 17, 46 }, 35, ForegroundColour::BLACK, BackgroundColour::WHITE, ""));
 	frame.AddControlToConsole(Framework::Control::TextBox("tbxFileSize", COORD{ 17, 48 }, 35, ForegroundColour::BLACK, BackgroundColour::WHITE, ""));
+	frame.AddControlToConsole(Framework::Control::TextBox("tbxStatus", COORD{ 64, 44 }, 64, ForegroundColour::BLACK, BackgroundColour::WHITE, ""));
+	frame.AddControlToConsole(Framework::Control::TextBox("tbxImpact", COORD{ 64, 46 }, 64, ForegroundColour::BLACK, BackgroundColour::WHITE, ""));
+	frame.AddControlToConsole(Framework::Control::TextBox("tbxScanning", COORD{ 64, 48 }, 64, ForegroundColour::BLACK, BackgroundColour::WHITE, ""));
 
 	// Create the file viewer that will display files.
 	frame.AddControlToConsole(Framework::Control::FileViewer("fv", 12, 31, ForegroundColour::WHITE, BackgroundColour::BLACK));
 
+	DrawThrottle();
+
 	return *this;
 }
 
@@ -68,239 +246,339 @@ FileView& FileView::CreateTUI(std::string folder, std::string filter, bool rSear
 // based on the key press.
 
 void FileView::ProcessKeyEvent(Event::Keyboard const& ke, FileModel& model) {
+	// A held key sends key downs until it is let go; only the first of them is a fresh press.
+	bool const repeat = ke.KeyDown() && (ke.VirtualKeyCode() == heldKey || ke.RepeatCount() > 1);
+	if (ke.KeyDown())
+		heldKey = ke.VirtualKeyCode();
+	else if (ke.VirtualKeyCode() == heldKey)
+		heldKey = 0;
+
 	if (ke.KeyDown())
 	{
 		
-		// Get the two controls we want to examine for key events within them.
+		// Get the input controls we want to examine for key events within them.
 		Framework::Control::InputTextBox itbFolder = frame.GetControls().find("folderInput")->second;
 		Framework::Control::InputTextBox itbFilter = frame.GetControls().find("filterInput")->second;
+		Framework::Control::InputTextBox itbContains = frame.GetControls().find("containsInput")->second;
+		Framework::Control::InputTextBox itbFind = frame.GetControls().find("findInput")->second;
+		Framework::Control::InputTextBox itbTarget = frame.GetControls().find("targetInput")->second;
 
-		if (itbFolder.controlHit_)
+		// A delete goes ahead only on a fresh press of CONFIRM_KEY straight after its dry run. Repeats of a held
+		// key are ignored while it waits, and any other key keeps the files.
+		if (model.HasPlannedDelete())
 		{
-			// Flag for signifying enter key stroke.
-			bool enterHit_ = false;
+			if (repeat)
+				return;
+			if (ke.VirtualKeyCode() == CONFIRM_KEY)
+			{
+				ConfirmDelete(model);
+				return;
+			}
+			model.CancelDelete();
+			DrawStatus(model);
+		}
 
+		if (itbFolder.controlHit_)
+		{
+			// A new folder needs a new scan.
+			if (EditInput(itbFolder, ke))
+				Notify();
+		}
+		else if (itbFilter.controlHit_)
+		{
+			// So does a new filter.
+			if (EditInput(itbFilter, ke))
+				Notify();
+		}
+		else if (itbContains.controlHit_)
+		{
+			// A content search runs over the files already scanned.
+			if (EditInput(itbContains, ke))
+				SearchContents(itbContains.content_, model);
+		}
+		else if (itbFind.controlHit_)
+		{
+			// Every key press re-ranks the scanned files; Enter just gives the keyboard back.
+			EditInput(itbFind, ke);
+			model.Narrow(itbFind.content_);
+			model.fPos_ = 0;
+			model.selected_ = 0;
+			DrawRows(model);
+			DrawStatus(model);
+		}
+		else if (itbTarget.controlHit_)
+		{
+			// Enter copies or moves the files listed to the folder typed.
+			if (EditInput(itbTarget, ke))
+				RunTransfer(itbTarget.content_, model);
+		}
+		else if (follower)
+		{
+			// Esc leaves follow mode and puts the listing back.
+			if (ke.VirtualKeyCode() == VK_ESCAPE)
+			{
+				follower.reset();
+				previewPath.clear();
+				DrawRows(model);
+				DrawStatus(model);
+			}
+		}
+		else if (pager)
+		{
+			// The text viewer has the keyboard while it is open.
+			ProcessViewerKey(ke, model);
+		}
+		else
+		{
+			// These events will change the file view, much like the scroll method.
 			switch (ke.VirtualKeyCode())
 			{
-				case VK_BACK:
+				case VK_UP:
 				{
-					if (0 < itbFolder.cursorPos_ && itbFolder.cursorPos_ <= itbFolder.content_.size())
-					{
-						// Back space to remove character at cursor location.
-						--itbFolder.cursorPos_;
-						itbFolder.content_.erase(itbFolder.cursorPos_, 1);
-					}
+					// Move the selection, scrolling when it leaves the window.
+					if (model.selected_ > 0)
+						Select(model, model.selected_ - 1);
 				}
 				break;
 
-				case VK_DELETE:
-				{
-					if (0 <= itbFolder.cursorPos_ && itbFolder.cursorPos_ < itbFolder.content_.size())
-						itbFolder.content_.erase(itbFolder.cursorPos_, 1);
-				}
-				break;
+				case VK_DOWN: Select(model, model.selected_ + 1); break;
+				case VK_PRIOR: Select(model, model.selected_ > VIEW_ROWS ? model.selected_ - VIEW_ROWS : 0); break;
+				case VK_NEXT: Select(model, model.selected_ + VIEW_ROWS); break;
 
-				case VK_LEFT:
+				case VK_OEM_PLUS:
 				{
-					if (itbFolder.cursorPos_ > 0)
-						--itbFolder.cursorPos_;
+					// Make sure we are not exiting bounds of the vector.
+					if (model.fPos_ > 0)
+						--model.fPos_;
+
+					// Reset and output.
+					DrawRows(model);
 				}
 				break;
 
-				case VK_RIGHT:
+				case VK_OEM_MINUS:
 				{
-					if (itbFolder.cursorPos_ < itbFolder.content_.size())
-						++itbFolder.cursorPos_;
+					// Make sure we are not exiting bounds of the vector.
+					if (model.fPos_ + 28 < model.GetRowCount())
+						++model.fPos_;
+
+					// Reset and output.
+					DrawRows(model);
 				}
 				break;
 
-				case VK_END: itbFolder.cursorPos_ = itbFolder.content_.size(); break;
-				case VK_HOME: itbFolder.cursorPos_ = 0; break;
-				case VK_RETURN:
+				case VK_F2:
 				{
-					itbFolder.cursorPos_ = 0;
-					itbFolder.aperature_ = 0;
-					enterHit_ = true;
-					itbFolder.controlHit_ = false;
+					// Cycle the listing between all files and the largest/newest leaderboards.
+					Framework::Control::TextBox tbxListing = frame.GetControls().find("tbxListing")->second;
+					if (tbxListing.content_ == "FILES")
+						tbxListing.content_ = "LARGEST";
+					else if (tbxListing.content_ == "LARGEST")
+						tbxListing.content_ = "NEWEST";
+					else
+						tbxListing.content_ = "FILES";
 
-					itbFolder.Update(itbFolder);
+					tbxListing.Update(tbxListing);
+					tbxListing.UpdateContent(tbxListing);
+
+					// Notify controller we need to update model and view.
 					Notify();
 				}
 				break;
-				
-				default:
+
+				case VK_ESCAPE:
 				{
-					char ch = ke.AsciiChar();
-					if (isprint(ch))
-						itbFolder.content_.insert(itbFolder.cursorPos_++ + itbFolder.content_.begin(), ch);
+					// Go back from any of the listings made from the scanned files to the scanned files.
+					if (model.GetListing() == FileModel::Listing::DUPLICATES || model.GetListing() == FileModel::Listing::MATCHES || model.GetListing() == FileModel::Listing::FUZZY || model.GetListing() == FileModel::Listing::NAMES || model.GetListing() == FileModel::Listing::FOLDERS || model.GetListing() == FileModel::Listing::CHANGES || model.GetListing() == FileModel::Listing::MANIFEST || model.GetListing() == FileModel::Listing::FAILED)
+					{
+						model.SetListing(FileModel::Listing::FILES);
+						model.fPos_ = 0;
+						model.selected_ = 0;
+						DrawRows(model);
+					}
 				}
 				break;
-			}
-
-			// Update as typing occurs.
-			auto size = itbFolder.content_.size() + 1;
-			while (itbFolder.cursorPos_ < itbFolder.aperature_)
-				--itbFolder.aperature_;
 
-			while (itbFolder.cursorPos_ - itbFolder.aperature_ >= itbFolder.length_)
-				++itbFolder.aperature_;
-
-			while (size - itbFolder.aperature_ < itbFolder.length_ && size > itbFolder.length_)
-				--itbFolder.aperature_;
-
-			auto s = itbFolder.content_.substr(itbFolder.aperature_, itbFolder.length_);
-			s += std::string(itbFolder.length_ / 2, ' ');
-
-			frame.Write(itbFolder.xPos_, itbFolder.yPos_, s, itbFolder.foreground_, itbFolder.background_);
-			itbFolder.UpdateInputContent(itbFolder);
-
-			// Replace cursor.
-			COORD cLoc{ itbFolder.xPos_, itbFolder.yPos_ };
-			cLoc.X += itbFolder.cursorPos_ - itbFolder.aperature_;
-			frame.ResetCursorPosition(cLoc.X, cLoc.Y, enterHit_ ? false : true);
+				case VK_F3:
+				{
+					// Toggle between the file listing and the duplicate groups found in it. Duplicates are looked
+					// for in the scanned files, so this does not rescan.
+					if (model.GetListing() == FileModel::Listing::DUPLICATES)
+						model.SetListing(FileModel::Listing::FILES);
+					else if (model.GetListing() == FileModel::Listing::FILES)
+					{
+						Framework::Control::FileViewer fv = frame.GetControls().find("fv")->second;
+						fv.content_ = "Finding duplicates...";
+						fv.ClearFileView();
+						fv.UpdateFileView(fv);
 
-			// Update control.
-			itbFolder.Update(itbFolder);
-		}
-		else if (itbFilter.controlHit_)
-		{
-			// Flag for signifying enter key stroke.
-			bool enterHit_ = false;
+						model.FindDuplicates();
+					}
 
-			switch (ke.VirtualKeyCode())
-			{
-			case VK_BACK:
-			{
-				if (0 < itbFilter.cursorPos_ && itbFilter.cursorPos_ <= itbFilter.content_.size())
-				{
-					// Back space to remove character at cursor location.
-					--itbFilter.cursorPos_;
-					itbFilter.content_.erase(itbFilter.cursorPos_, 1);
+					model.fPos_ = 0;
+					model.selected_ = 0;
+					DrawRows(model);
+					DrawStatus(model);
 				}
-			}
-			break;
+				break;
 
-			case VK_DELETE:
-			{
-				if (0 <= itbFilter.cursorPos_ && itbFilter.cursorPos_ < itbFilter.content_.size())
-					itbFilter.content_.erase(itbFilter.cursorPos_, 1);
-			}
-			break;
+				case VK_RETURN:
+				{
+					// In the folder listing, go into the selected folder.
+					if (model.GetListing() == FileModel::Listing::FOLDERS)
+					{
+						if (model.GetRowCount())
+							OpenFolder(model.GetRowFolder(static_cast<std::size_t>(model.selected_)));
+						break;
+					}
 
-			case VK_LEFT:
-			{
-				if (itbFilter.cursorPos_ > 0)
-					--itbFilter.cursorPos_;
-			}
-			break;
+					// Open the selected file in the text viewer.
+					std::string path = model.GetRowCount() ? model.GetRowPath(static_cast<std::size_t>(model.selected_)) : std::string();
+					if (path.empty())
+						break;
 
-			case VK_RIGHT:
-			{
-				if (itbFilter.cursorPos_ < itbFilter.content_.size())
-					++itbFilter.cursorPos_;
-			}
-			break;
+					pager.reset(new TextPager(path));
+					if (!pager->IsOpen())
+					{
+						pager.reset();
+						ShowStatus("Cannot open " + path);
+						break;
+					}
 
-			case VK_END: itbFilter.cursorPos_ = itbFilter.content_.size(); break;
-			case VK_HOME: itbFilter.cursorPos_ = 0; break;
-			case VK_RETURN:
-			{
-				itbFilter.cursorPos_ = 0;
-				itbFilter.aperature_ = 0;
-				enterHit_ = true;
-				itbFilter.controlHit_ = false;
+					preview.Cancel();
+					DrawViewer();
+				}
+				break;
 
-				itbFilter.Update(itbFilter);
-				Notify();
-			}
-			break;
+				case VK_F5:
+				{
+					// Follow the selected file as it grows.
+					std::string path = model.GetRowCount() ? model.GetRowPath(static_cast<std::size_t>(model.selected_)) : std::string();
+					if (path.empty())
+						break;
 
-			default:
-			{
-				char ch = ke.AsciiChar();
-				if (isprint(ch))
-					itbFilter.content_.insert(itbFilter.cursorPos_++ + itbFilter.content_.begin(), ch);
-			}
-			break;
-			}
+					follower.reset(new LogFollower(path, VIEW_ROWS, VIEW_WIDTH));
+					preview.Cancel();
+					DrawFollow(true, 0, true);
+				}
+				break;
 
-			// Update as typing occurs.
-			auto size = itbFilter.content_.size() + 1;
-			while (itbFilter.cursorPos_ < itbFilter.aperature_)
-				--itbFilter.aperature_;
+				case VK_F7:
+				{
+					// Toggle between the files and the folders under the folder shown, each summed up on one row.
+					if (model.GetListing() == FileModel::Listing::FOLDERS)
+						model.SetListing(FileModel::Listing::FILES);
+					else if (model.GetListing() == FileModel::Listing::FILES)
+						model.ListFolders();
+
+					model.fPos_ = 0;
+					model.selected_ = 0;
+					DrawRows(model);
+					DrawStatus(model);
+				}
+				break;
 
-			while (itbFilter.cursorPos_ - itbFilter.aperature_ >= itbFilter.length_)
-				++itbFilter.aperature_;
+				case VK_BACK:
+				{
+					// Go up a folder, as long as the last scan covers it.
+					std::string const folder = model.GetParentFolder();
+					if (!folder.empty())
+						OpenFolder(folder);
+				}
+				break;
 
-			while (size - itbFilter.aperature_ < itbFilter.length_ && size > itbFilter.length_)
-				--itbFilter.aperature_;
+				case VK_F8:
+				{
+					// Refresh the scan, listing again only the folders that changed. Without the folders of a
+					// recursive file listing to go on, this is a full rescan.
+					Framework::Control::FileViewer fv = frame.GetControls().find("fv")->second;
+					fv.content_ = "Refreshing...";
+					fv.ClearFileView();
+					fv.UpdateFileView(fv);
+
+					if (model.Refresh())
+						OpenFolder(model.GetSearchFolder());
+					else
+						Notify();
+				}
+				break;
 
-			auto s = itbFilter.content_.substr(itbFilter.aperature_, itbFilter.length_);
-			s += std::string(itbFilter.length_ / 2, ' ');
+				case VK_F9:
+				{
+					// Save a snapshot of the scan and list what changed since the one before.
+					Framework::Control::FileViewer fv = frame.GetControls().find("fv")->second;
+					fv.content_ = "Saving snapshot...";
+					fv.ClearFileView();
+					fv.UpdateFileView(fv);
+
+					model.TakeSnapshot();
+					model.fPos_ = 0;
+					model.selected_ = 0;
+					DrawRows(model);
+					DrawStatus(model);
+				}
+				break;
 
-			frame.Write(itbFilter.xPos_, itbFilter.yPos_, s, itbFilter.foreground_, itbFilter.background_);
-			itbFilter.UpdateInputContent(itbFilter);
+				case VK_F6:
+				{
+					// Give the find box the keyboard, with the cursor after what is already in it.
+					itbFind.controlHit_ = true;
+					itbFind.cursorPos_ = itbFind.content_.size();
+					itbFind.aperature_ = itbFind.cursorPos_ >= itbFind.length_ ? itbFind.cursorPos_ - itbFind.length_ + 1 : 0;
+					itbFind.Update(itbFind);
+					frame.ResetCursorPosition(static_cast<SHORT>(itbFind.xPos_ + itbFind.cursorPos_ - itbFind.aperature_), itbFind.yPos_, true);
+				}
+				break;
 
-			// Replace cursor.
-			COORD cLoc{ itbFilter.xPos_, itbFilter.yPos_ };
-			cLoc.X += itbFilter.cursorPos_ - itbFilter.aperature_;
-			frame.ResetCursorPosition(cLoc.X, cLoc.Y, enterHit_ ? false : true);
+				case VK_F11:
+				case VK_OEM_4:
+				case VK_OEM_6:
+				{
+					// Background mode and its rate; the next scan picks them up.
+					AdjustThrottle(ke.VirtualKeyCode());
+				}
+				break;
 
-			// Update control.
-			itbFilter.Update(itbFilter);
-		}
-		else
-		{
-			// These events will change the file view, much like the scroll method.
-			switch (ke.VirtualKeyCode())
-			{
-				case VK_PRIOR:
-				case VK_OEM_PLUS:
-				case VK_UP:
+				case VK_F1:
 				{
-					// Make sure we are not exiting bounds of the vector.
-					if (model.fPos_ > 0)
-						--model.fPos_;
+					// Switch what Enter in the target folder box does between copying and moving the files listed.
+					Framework::Control::TextBox tbxTransfer = frame.GetControls().find("tbxTransfer")->second;
+					tbxTransfer.content_ = tbxTransfer.content_ == "COPY TO" ? "MOVE TO" : "COPY TO";
+					tbxTransfer.Update(tbxTransfer);
+					tbxTransfer.UpdateContent(tbxTransfer);
+				}
+				break;
 
-					// Reset and output.
-					int viewBound = 0;
-					model.startRow_ = 13;
-
-					for (auto i = model.fPos_; i < model.GetFiles().size(); ++i) {
-						if (viewBound <= 28) {
-							frame.Write(1, model.startRow_, std::string(200, ' '), ForegroundColour::WHITE, BackgroundColour::BLACK);
-							frame.Write(1, model.startRow_++, model.GetFiles()[static_cast<unsigned int>(i)], ForegroundColour::WHITE, BackgroundColour::BLACK);
-						}
-						else
-							break;
-
-						viewBound++;
-					}
+				case VK_DELETE:
+				{
+					// Show what deleting the files listed would take away; CONFIRM_KEY then deletes them.
+					RunDelete(model);
 				}
 				break;
 
-				case VK_NEXT:
-				case VK_OEM_MINUS:
-				case VK_DOWN:
+				case VK_F10:
+				case VK_F12:
 				{
-					// Make sure we are not exiting bounds of the vector.
-					if (model.fPos_ + 28 < model.GetFiles().size())
-						++model.fPos_;
+					// F10 writes a checksum manifest of the files shown into the folder shown, and F12 checks the
+					// files against the one there.
+					RunManifest(ke.VirtualKeyCode() == VK_F12, model);
+				}
+				break;
 
-					// Reset and output.
-					int viewBound = 0;
-					model.startRow_ = 13;
-
-					for (auto i = model.fPos_; i < model.GetFiles().size(); ++i) {
-						if (viewBound <= 28) {
-							frame.Write(1, model.startRow_, std::string(200, ' '), ForegroundColour::WHITE, BackgroundColour::BLACK);
-							frame.Write(1, model.startRow_++, model.GetFiles()[static_cast<unsigned int>(i)], ForegroundColour::WHITE, BackgroundColour::BLACK);
-						}
-						else
-							break;
-
-						viewBound++;
-					}
+				case VK_F4:
+				{
+					// Show or hide the preview pane. The file viewer is narrowed to make room for it.
+					previewOn = !previewOn;
+					previewPath.clear();
+					if (!previewOn)
+						preview.Cancel();
+
+					Framework::Control::TextBox tbxPreview = frame.GetControls().find("tbxPreview")->second;
+					tbxPreview.content_ = previewOn ? "ON" : "OFF";
+					tbxPreview.Update(tbxPreview);
+					tbxPreview.UpdateContent(tbxPreview);
+
+					DrawRows(model);
 				}
 				break;
 			}
@@ -308,125 +586,394 @@ void FileView::ProcessKeyEvent(Event::Keyboard const& ke, FileModel& model) {
 	}
 }
 
-// Checks for mouse clicks which will update the appropriate control's cursor position within its bounds,
-// and set its hit flag to true. Otherwise, the mouse wheel up or down will be used to scroll the file viewer.
-
-void FileView::ProcessMouseEvent(Event::Mouse const& me, FileModel& model) {
-	switch (me.GetType())
-	{
-		// Scroll events for the file viewer.
-		case Event::Mouse::MouseType::WHEELED:
-		{
-			if (me.MouseWheelUp())
-			{
-				// Make sure we are not exiting bounds of the vector.
-				if (model.fPos_ > 0)
-					--model.fPos_;
+// The controller shows the folder from the last scan when it can, so this only rescans when it has to.
 
-				// Reset and output.
-				int viewBound = 0;
-				model.startRow_ = 13;
+void FileView::OpenFolder(std::string const& folder) {
+	if (folder.empty())
+		return;
 
-				for (auto i = model.fPos_; i < model.GetFiles().size(); ++i) {
-					if (viewBound <= 28) {
-						frame.Write(1, model.startRow_, std::string(200, ' '), ForegroundColour::WHITE, BackgroundColour::BLACK);
-						frame.Write(1, model.startRow_++, model.GetFiles()[static_cast<unsigned int>(i)], ForegroundColour::WHITE, BackgroundColour::BLACK);
-					}
-					else
-						break;
+	Framework::Control::InputTextBox itbFolder = frame.GetControls().find("folderInput")->second;
+	itbFolder.content_ = folder;
+	itbFolder.cursorPos_ = 0;
+	itbFolder.aperature_ = 0;
+	itbFolder.Update(itbFolder);
+	itbFolder.UpdateInputContent(itbFolder);
 
-					viewBound++;
-				}
-			}
-			else if (me.MouseWheelDown())
-			{
-				// Make sure we are not exiting bounds of the vector.
-				if (model.fPos_ + 28 < model.GetFiles().size())
-					++model.fPos_;
+	Notify();
+}
 
-				// Reset and output.
-				int viewBound = 0;
-				model.startRow_ = 13;
+// Moves the text viewer with the cursor keys. Digits are collected into a target that Enter jumps to as a line
+// number and '%' jumps to as a percentage of the file. Esc drops a half typed target first, then closes the viewer
+// and puts the listing back.
 
-				for (auto i = model.fPos_; i < model.GetFiles().size(); ++i) {
-					if (viewBound <= 28) {
-						frame.Write(1, model.startRow_, std::string(200, ' '), ForegroundColour::WHITE, BackgroundColour::BLACK);
-						frame.Write(1, model.startRow_++, model.GetFiles()[static_cast<unsigned int>(i)], ForegroundColour::WHITE, BackgroundColour::BLACK);
-					}
-					else
-						break;
+void FileView::ProcessViewerKey(Event::Keyboard const& ke, FileModel& model) {
+	switch (ke.VirtualKeyCode())
+	{
+		case VK_UP: pager->Up(1); break;
+		case VK_DOWN: pager->Down(1); break;
+		case VK_PRIOR: pager->Up(VIEW_ROWS); break;
+		case VK_NEXT: pager->Down(VIEW_ROWS); break;
+		case VK_HOME: pager->GoToLine(1); break;
+		case VK_END:
+		{
+			pager->GoToPercent(100);
+			pager->Up(VIEW_ROWS - 1);
+		}
+		break;
 
-					viewBound++;
-				}
-			}
+		case VK_BACK:
+		{
+			if (!goTo.empty())
+				goTo.pop_back();
 		}
 		break;
-		case Event::Mouse::MouseType::BUTTON:
+
+		case VK_RETURN:
 		{
-			// Get variables we will need.
-			auto clickPos = me.MousePosition();
-			
-			Framework::Control::Checkbox cb = frame.GetControls().find("recursiveCheck")->second;
-			Framework::Control::InputTextBox itbFolder = frame.GetControls().find("folderInput")->second;
-			Framework::Control::InputTextBox itbFilter = frame.GetControls().find("filterInput")->second;
+			if (!goTo.empty())
+				pager->GoToLine(std::stoull(goTo));
+			goTo.clear();
+		}
+		break;
 
-			// Test for change to recursion.
-			cb.controlHit_ = clickPos.X == 20 && clickPos.Y == 10;
-			if (cb.controlHit_ && me.LeftPressed())
+		case VK_ESCAPE:
+		{
+			if (!goTo.empty())
 			{
-				// Change state and content according to the press.
-				cb.state_ = !cb.state_;
-				cb.content_ = cb.state_ ? "X" : " ";
-				cb.controlHit_ = !cb.controlHit_;
-
-				// Update control.
-				cb.Update(cb);
-				cb.UpdateCheckState(cb);
-
-				// Notify controller we need to update model and view.
-				Notify();
+				goTo.clear();
+				break;
 			}
 
-			// Test for click on folder textbox.
-			itbFolder.controlHit_ = clickPos.X >= 10 && clickPos.X <= 185 && clickPos.Y == 6;
-			if (itbFolder.controlHit_ && me.LeftPressed())
-			{
-				// Show cursor at selection point.
-				itbFolder.cursorPos_ = min(me.MousePosition().X - itbFolder.xPos_ + itbFolder.aperature_, itbFolder.content_.size());
-				COORD mLoc{ itbFolder.cursorPos_ - itbFolder.aperature_ + itbFolder.xPos_, itbFolder.yPos_ };
-				frame.ResetCursorPosition(mLoc.X, mLoc.Y, true);
-
-				// Update control.
-				itbFolder.Update(itbFolder);
-				
-				// Update other control to take off its controlHit status.
-				itbFilter.controlHit_ = false;
-				itbFilter.Update(itbFilter);
-			}
+			pager.reset();
+			previewPath.clear();
+			DrawRows(model);
+			DrawStatus(model);
+		}
+		return;
 
-			// Test for click on filter textbox.
-			itbFilter.controlHit_ = clickPos.X >= 10 && clickPos.X <= 185 && clickPos.Y == 8;
-			if (itbFilter.controlHit_ && me.LeftPressed())
+		default:
+		{
+			char ch = ke.AsciiChar();
+			if (isdigit(static_cast<unsigned char>(ch)) && goTo.size() < 18)
+				goTo += ch;
+			else if (ch == '%' && !goTo.empty())
 			{
-				// Show cursor at selection point.
-				itbFilter.cursorPos_ = min(me.MousePosition().X - itbFilter.xPos_ + itbFilter.aperature_, itbFilter.content_.size());
-				COORD mLoc{ itbFilter.cursorPos_ - itbFilter.aperature_ + itbFilter.xPos_, itbFilter.yPos_ };
-				frame.ResetCursorPosition(mLoc.X, mLoc.Y, true);
-
-				// Update control.
-				itbFilter.Update(itbFilter);
-
-				// Update other control to take off its controlHit status.
-				itbFolder.controlHit_ = false;
-				itbFolder.Update(itbFolder);
+				pager->GoToPercent(std::stod(goTo));
+				goTo.clear();
 			}
 		}
 		break;
 	}
+
+	DrawViewer();
 }
 
-// Switches the ctrl handled events. If the event is equal to CTRL + C, the application's
-// quit flag will be set and the program will destruct.
+// Applies a key press to an input textbox that has the keyboard: editing keys change the content and the cursor,
+// printable characters are inserted at the cursor. The visible part of the content is scrolled so the cursor
+// stays inside the box, then the box is redrawn and its state saved. Returns true when Enter was pressed,
+// which also gives up the keyboard.
+
+bool FileView::EditInput(Framework::Control::InputTextBox& itb, Event::Keyboard const& ke) {
+	// Flag for signifying enter key stroke.
+	bool enterHit_ = false;
+
+	switch (ke.VirtualKeyCode())
+	{
+		case VK_BACK:
+		{
+			if (0 < itb.cursorPos_ && itb.cursorPos_ <= itb.content_.size())
+			{
+				// Back space to remove character at cursor location.
+				--itb.cursorPos_;
+				itb.content_.erase(itb.cursorPos_, 1);
+			}
+		}
+		break;
+
+		case VK_DELETE:
+		{
+			if (0 <= itb.cursorPos_ && itb.cursorPos_ < itb.content_.size())
+				itb.content_.erase(itb.cursorPos_, 1);
+		}
+		break;
+
+		case VK_LEFT:
+		{
+			if (itb.cursorPos_ > 0)
+				--itb.cursorPos_;
+		}
+		break;
+
+		case VK_RIGHT:
+		{
+			if (itb.cursorPos_ < itb.content_.size())
+				++itb.cursorPos_;
+		}
+		break;
+
+		case VK_END: itb.cursorPos_ = itb.content_.size(); break;
+		case VK_HOME: itb.cursorPos_ = 0; break;
+		case VK_RETURN:
+		{
+			itb.cursorPos_ = 0;
+			itb.aperature_ = 0;
+			enterHit_ = true;
+			itb.controlHit_ = false;
+		}
+		break;
+
+		default:
+		{
+			char ch = ke.AsciiChar();
+			if (isprint(ch))
+				itb.content_.insert(itb.cursorPos_++ + itb.content_.begin(), ch);
+		}
+		break;
+	}
+
+	// Update as typing occurs.
+	auto size = itb.content_.size() + 1;
+	while (itb.cursorPos_ < itb.aperature_)
+		--itb.aperature_;
+
+	while (itb.cursorPos_ - itb.aperature_ >= itb.length_)
+		++itb.aperature_;
+
+	while (size - itb.aperature_ < itb.length_ && size > itb.length_)
+		--itb.aperature_;
+
+	auto s = itb.content_.substr(itb.aperature_, itb.length_);
+	s += std::string(itb.length_ / 2, ' ');
+
+	frame.Write(itb.xPos_, itb.yPos_, s, itb.foreground_, itb.background_);
+	itb.UpdateInputContent(itb);
+
+	// Replace cursor.
+	COORD cLoc{ itb.xPos_, itb.yPos_ };
+	cLoc.X += itb.cursorPos_ - itb.aperature_;
+	frame.ResetCursorPosition(cLoc.X, cLoc.Y, enterHit_ ? false : true);
+
+	// Update control.
+	itb.Update(itb);
+
+	return enterHit_;
+}
+
+// Runs a content search over the model's files, showing the hits in the file viewer as they are found.
+// Esc stops the search; the hits found so far are kept.
+
+void FileView::SearchContents(std::string const& pattern, FileModel& model) {
+	Framework::Control::FileViewer fv = frame.GetControls().find("fv")->second;
+	fv.content_ = "Searching... (Esc to cancel)";
+	fv.ClearFileView();
+	fv.UpdateFileView(fv);
+
+	model.fPos_ = 0;
+	model.selected_ = 0;
+	model.SearchContents(pattern, [&model] {
+		DrawRows(model);
+		DrawStatus(model);
+		return !frame.EscapePressed();
+	});
+
+	DrawRows(model);
+	DrawStatus(model);
+}
+
+// Runs a manifest pass over the model's files, showing its running totals in the status line; a verify also
+// lists problems as they are found. Esc stops the pass; a manifest being written is then not written at all.
+
+void FileView::RunManifest(bool verify, FileModel& model) {
+	Framework::Control::FileViewer fv = frame.GetControls().find("fv")->second;
+	fv.content_ = verify ? "Verifying... (Esc to cancel)" : "Hashing... (Esc to cancel)";
+	fv.ClearFileView();
+	fv.UpdateFileView(fv);
+
+	model.fPos_ = 0;
+	model.selected_ = 0;
+	auto progress = [&model, verify] {
+		if (verify)
+			DrawRows(model);
+		DrawStatus(model);
+		return !frame.EscapePressed();
+	};
+	if (verify)
+		model.VerifyManifest(progress);
+	else
+		model.WriteManifest(checksum, progress);
+
+	DrawRows(model);
+	DrawStatus(model);
+}
+
+// Runs a copy or move of the model's listed files, showing its running totals in the status line. Esc stops it;
+// files already done stay done, and the one being copied is removed.
+
+void FileView::RunTransfer(std::string const& target, FileModel& model) {
+	Framework::Control::TextBox tbxTransfer = frame.GetControls().find("tbxTransfer")->second;
+	FileTransfer::Mode const mode = tbxTransfer.content_ == "MOVE TO" ? FileTransfer::MOVE : FileTransfer::COPY;
+
+	model.TransferFiles(target, mode, [&model] {
+		DrawStatus(model);
+		return !frame.EscapePressed();
+	});
+
+	model.fPos_ = 0;
+	model.selected_ = 0;
+	DrawRows(model);
+	DrawStatus(model);
+}
+
+// The dry run only writes the status line. The delete itself shows its running totals there; Esc stops it, and
+// what is already deleted stays deleted.
+
+void FileView::RunDelete(FileModel& model) {
+	model.PlanDelete([&model] {
+		DrawStatus(model);
+		return !frame.EscapePressed();
+	});
+	DrawStatus(model);
+}
+
+void FileView::ConfirmDelete(FileModel& model) {
+	auto progress = [&model] {
+		DrawStatus(model);
+		return !frame.EscapePressed();
+	};
+
+	Framework::Control::FileViewer fv = frame.GetControls().find("fv")->second;
+	fv.content_ = "Deleting... (Esc to cancel)";
+	fv.ClearFileView();
+	fv.UpdateFileView(fv);
+
+	model.DeletePlanned(progress);
+	model.fPos_ = 0;
+	model.selected_ = 0;
+	DrawRows(model);
+	DrawStatus(model);
+}
+
+// Checks for mouse clicks which will update the appropriate control's cursor position within its bounds,
+// and set its hit flag to true. Otherwise, the mouse wheel up or down will be used to scroll the file viewer.
+
+void FileView::ProcessMouseEvent(Event::Mouse const& me, FileModel& model) {
+	// A click or the wheel keeps the files of a planned delete, as any key but CONFIRM_KEY does.
+	if (me.GetType() != Event::Mouse::MouseType::MOVED && model.HasPlannedDelete())
+	{
+		model.CancelDelete();
+		DrawStatus(model);
+	}
+
+	switch (me.GetType())
+	{
+		// Scroll events for the file viewer.
+		case Event::Mouse::MouseType::WHEELED:
+		{
+			// The wheel moves the text viewer three lines at a time while it is open, and does nothing in follow mode.
+			if (follower)
+				break;
+			else if (pager)
+			{
+				if (me.MouseWheelUp())
+					pager->Up(3);
+				else if (me.MouseWheelDown())
+					pager->Down(3);
+
+				DrawViewer();
+			}
+			else if (me.MouseWheelUp())
+			{
+				// Make sure we are not exiting bounds of the vector.
+				if (model.fPos_ > 0)
+					--model.fPos_;
+
+				// Reset and output.
+				DrawRows(model);
+			}
+			else if (me.MouseWheelDown())
+			{
+				// Make sure we are not exiting bounds of the vector.
+				if (model.fPos_ + 28 < model.GetRowCount())
+					++model.fPos_;
+
+				// Reset and output.
+				DrawRows(model);
+			}
+		}
+		break;
+		case Event::Mouse::MouseType::BUTTON:
+		{
+			// Get variables we will need.
+			auto clickPos = me.MousePosition();
+			
+			Framework::Control::Checkbox cb = frame.GetControls().find("recursiveCheck")->second;
+
+			// Test for change to recursion.
+			cb.controlHit_ = clickPos.X == 20 && clickPos.Y == 10;
+			if (cb.controlHit_ && me.LeftPressed())
+			{
+				// Change state and content according to the press.
+				cb.state_ = !cb.state_;
+				cb.content_ = cb.state_ ? "X" : " ";
+				cb.controlHit_ = !cb.controlHit_;
+
+				// Update control.
+				cb.Update(cb);
+				cb.UpdateCheckState(cb);
+
+				// Notify controller we need to update model and view.
+				Notify();
+			}
+
+			// A click on a row of the file viewer selects it, unless the viewer or follow mode is covering the rows.
+			WORD const width = previewOn ? PREVIEW_X - 2 : VIEW_WIDTH;
+			if (me.LeftPressed() && !pager && !follower && clickPos.Y >= VIEW_TOP && clickPos.Y < VIEW_TOP + VIEW_ROWS && clickPos.X >= 1 && clickPos.X <= width)
+			{
+				auto row = model.fPos_ + (clickPos.Y - VIEW_TOP);
+				if (row < model.GetRowCount())
+					Select(model, row);
+			}
+
+			// Test for click on one of the input textboxes. The one clicked takes the keyboard and the others lose it.
+			if (me.LeftPressed())
+			{
+				std::string const inputs[] = { "folderInput", "filterInput", "containsInput", "findInput", "targetInput" };
+
+				std::string clicked;
+				for (auto const& id : inputs)
+				{
+					Framework::Control::InputTextBox itb = frame.GetControls().find(id)->second;
+					if (clickPos.Y == itb.yPos_ && clickPos.X >= itb.xPos_ && clickPos.X <= itb.xPos_ + itb.length_)
+						clicked = id;
+				}
+
+				for (auto const& id : inputs)
+				{
+					if (clicked.empty())
+						break;
+
+					Framework::Control::InputTextBox itb = frame.GetControls().find(id)->second;
+					itb.controlHit_ = id == clicked;
+
+					if (itb.controlHit_)
+					{
+						// Show cursor at selection point.
+						itb.cursorPos_ = min(me.MousePosition().X - itb.xPos_ + itb.aperature_, itb.content_.size());
+						COORD mLoc{ itb.cursorPos_ - itb.aperature_ + itb.xPos_, itb.yPos_ };
+						frame.ResetCursorPosition(mLoc.X, mLoc.Y, true);
+					}
+
+					// Update control.
+					itb.Update(itb);
+				}
+			}
+		}
+		break;
+	}
+}
+
+// Switches the ctrl handled events. If the event is equal to CTRL + C, the application's
+// quit flag will be set and the program will destruct.
 
 BOOL FileView::CtrlHandler(DWORD ctrlType) {
 	switch (ctrlType)
@@ -439,6 +986,272 @@ BOOL FileView::CtrlHandler(DWORD ctrlType) {
 	return FALSE;
 }
 
+// Writes the model's status line into the footer's status textbox.
+
+void FileView::DrawStatus(FileModel const& model) {
+	ShowStatus(model.GetStatus());
+}
+
+// The impact is rewritten on every scan tick, so like the status it is only written when it changed.
+
+void FileView::DrawImpact(FileModel const& model) {
+	ShowCell("tbxImpact", model.GetImpact());
+}
+
+// The rate is taken over the time since the last sample, so it follows the scan as it speeds up and slows
+// down. A scan's clock starts again at zero, which is how a new scan is told from the one sampled before.
+
+void FileView::DrawProgress(FileModel const& model) {
+	ScanProgress const* progress = model.GetProgress();
+	if (!progress)
+		return;
+
+	ScanProgress::Reading const reading = progress->Read();
+	if (reading.seconds_ < sampledAt)
+	{
+		sampledAt = 0;
+		sampledEntries = 0;
+	}
+	if (reading.seconds_ - sampledAt < SAMPLE_MS / 1000.0)
+		return;
+
+	double const rate = (reading.entries_ - sampledEntries) / (reading.seconds_ - sampledAt);
+	sampledAt = reading.seconds_;
+	sampledEntries = reading.entries_;
+
+	std::ostringstream searched;
+	searched << reading.entries_ << " (" << static_cast<unsigned long long>(rate) << "/s)";
+	std::ostringstream scanning;
+	scanning << reading.pending_ << " queued";
+	if (model.GetSkipped())
+		scanning << ", " << model.GetSkipped() << " skipped";
+	scanning << ": " << reading.folder_;
+
+	ShowCell("tbxSearched", searched.str());
+	ShowCell("tbxMatched", std::to_string(reading.matched_));
+	ShowCell("tbxFileSize", ToMB(reading.bytes_));
+	ShowCell("tbxScanning", scanning.str());
+}
+
+// The throttle is shared with the scan workers, which read it before each folder they list, so a change made
+// here during a scan reaches them without the scan being restarted.
+
+bool FileView::AdjustThrottle(WORD key) {
+	double const rate = throttle->GetRate();
+	switch (key)
+	{
+		case VK_F11: throttle->SetBackground(!throttle->IsBackground()); break;
+		case VK_OEM_4: throttle->SetRate(rate == 0 ? MAX_RATE : std::max(MIN_RATE, rate / 2)); break;
+		case VK_OEM_6: throttle->SetRate(rate == 0 || rate >= MAX_RATE ? 0 : rate * 2); break;
+		default: return false;
+	}
+
+	DrawThrottle();
+	return true;
+}
+
+void FileView::DrawThrottle() {
+	Framework::Control::TextBox tbxBackground = frame.GetControls().find("tbxBackground")->second;
+
+	std::ostringstream os;
+	os << (throttle->IsBackground() ? "ON" : "OFF") << ", ";
+	if (throttle->GetRate() == 0)
+		os << "no limit";
+	else
+		os << throttle->GetRate() << "/s ([ ])";
+
+	tbxBackground.content_ = os.str();
+	tbxBackground.Update(tbxBackground);
+	tbxBackground.UpdateContent(tbxBackground);
+}
+
+// Skipping a write when nothing changed lets callers refresh the status on every idle tick.
+
+void FileView::ShowStatus(std::string const& status) {
+	ShowCell("tbxStatus", status);
+}
+
+void FileView::ShowCell(std::string const& id, std::string const& text) {
+	Framework::Control::TextBox tbx = frame.GetControls().find(id)->second;
+	std::string content = text.substr(0, tbx.length_);
+	if (content == tbx.content_)
+		return;
+
+	tbx.content_ = content;
+	tbx.Update(tbx);
+	tbx.UpdateContent(tbx);
+}
+
+// The viewer uses the whole width of the file viewer; the preview pane is covered while it is open.
+
+void FileView::DrawViewer() {
+	std::vector<std::string> lines = pager->Page(VIEW_WIDTH, VIEW_ROWS);
+	for (WORD i = 0; i < VIEW_ROWS; ++i)
+	{
+		std::string line = i < lines.size() ? lines[i] : std::string();
+		line.resize(VIEW_WIDTH, ' ');
+		frame.Write(1, VIEW_TOP + i, line, ForegroundColour::WHITE, BackgroundColour::BLACK);
+	}
+
+	ShowStatus(pager->Describe() + (goTo.empty() ? std::string() : "  Go to: " + goTo));
+}
+
+// Clears the viewable area of the file viewer and writes up to 29 rows of the model's current listing,
+// starting at the model's scroll position. The selection is kept on a visible row and drawn highlighted.
+// With the preview pane shown, rows are cut short to leave room for it, and a selection that has moved to
+// another file asks the loader for that file's preview; the older request is dropped by the loader.
+
+void FileView::DrawRows(FileModel& model) {
+	WORD const width = previewOn ? PREVIEW_X - 2 : VIEW_WIDTH;
+	auto const count = model.GetRowCount();
+
+	// Scrolling drags the selection along with the window.
+	if (model.selected_ < model.fPos_)
+		model.selected_ = model.fPos_;
+	else if (model.selected_ >= model.fPos_ + VIEW_ROWS)
+		model.selected_ = model.fPos_ + VIEW_ROWS - 1;
+	if (count != 0 && model.selected_ >= count)
+		model.selected_ = count - 1;
+
+	int viewBound = 0;
+	model.startRow_ = VIEW_TOP;
+
+	for (auto i = model.fPos_; i < count; ++i) {
+		if (viewBound < VIEW_ROWS) {
+			std::string row = model.GetRow(static_cast<std::size_t>(i));
+			row.resize(width, ' ');
+
+			if (i == model.selected_)
+				frame.Write(1, model.startRow_++, row, ForegroundColour::BLACK, BackgroundColour::GREY);
+			else
+				frame.Write(1, model.startRow_++, row, ForegroundColour::WHITE, BackgroundColour::BLACK);
+		}
+		else
+			break;
+
+		viewBound++;
+	}
+
+	// Blank whatever is left below a short listing.
+	while (viewBound < VIEW_ROWS) {
+		frame.Write(1, model.startRow_++, std::string(width, ' '), ForegroundColour::WHITE, BackgroundColour::BLACK);
+		viewBound++;
+	}
+
+	if (!previewOn)
+		return;
+
+	std::string path = count != 0 ? model.GetRowPath(static_cast<std::size_t>(model.selected_)) : std::string();
+	if (path != previewPath)
+	{
+		previewPath = path;
+		previewLines.clear();
+		if (!path.empty())
+			previewLines.push_back("Loading...");
+		preview.Request(path, PREVIEW_WIDTH, VIEW_ROWS);
+	}
+
+	DrawPreview();
+}
+
+// Moves the selection and scrolls the window just far enough to keep it in view, then redraws.
+
+void FileView::Select(FileModel& model, unsigned long long row) {
+	auto const count = model.GetRowCount();
+	if (count == 0)
+		return;
+
+	if (row >= count)
+		row = count - 1;
+
+	model.selected_ = row;
+	if (row < model.fPos_)
+		model.fPos_ = row;
+	else if (row >= model.fPos_ + VIEW_ROWS)
+		model.fPos_ = row - VIEW_ROWS + 1;
+
+	DrawRows(model);
+}
+
+// The complete lines sit above the bottom row, which holds the line still being written. When a few lines
+// arrive, the rows above are scrolled up by that many and only the new rows are written, so the cost of a
+// redraw follows the number of new lines rather than the size of the view.
+
+void FileView::DrawFollow(bool all, std::size_t added, bool partial) {
+	std::deque<std::string> const& lines = follower->GetLines();
+	WORD const body = VIEW_ROWS - 1;
+
+	auto writeRow = [](WORD row, std::string line) {
+		line.resize(VIEW_WIDTH, ' ');
+		frame.Write(1, VIEW_TOP + row, line, ForegroundColour::WHITE, BackgroundColour::BLACK);
+	};
+
+	if (all || added >= body)
+	{
+		for (WORD i = 0; i < body; ++i)
+		{
+			std::size_t const blank = body - lines.size();
+			writeRow(i, i < blank ? std::string() : lines[i - blank]);
+		}
+		partial = true;
+	}
+	else if (added != 0)
+	{
+		frame.ScrollUp(1, VIEW_TOP, VIEW_WIDTH, body, static_cast<WORD>(added), ForegroundColour::WHITE, BackgroundColour::BLACK);
+		for (std::size_t i = 0; i < added; ++i)
+			writeRow(static_cast<WORD>(body - added + i), lines[lines.size() - added + i]);
+		partial = true;
+	}
+
+	if (partial)
+		writeRow(body, follower->GetPartial());
+
+	std::ostringstream status;
+	status << "Following at " << ToMB(static_cast<unsigned long long>(follower->GetRate())) << "/s";
+	if (follower->GetSkipped())
+		status << ", " << ToMB(follower->GetSkipped()) << " skipped";
+	if (follower->GetRotations())
+		status << ", rotated " << follower->GetRotations() << "x";
+	if (follower->GetTruncations())
+		status << ", truncated " << follower->GetTruncations() << "x";
+	if (!follower->IsWatched())
+		status << " (polling)";
+	ShowStatus(follower->IsOpen() ? status.str() : "Waiting for the file to appear...");
+}
+
+// Writes the separator and the preview lines, blanking the rest of the pane.
+
+void FileView::DrawPreview() {
+	for (WORD i = 0; i < VIEW_ROWS; ++i)
+	{
+		std::string line = i < previewLines.size() ? previewLines[i] : std::string();
+		line.resize(PREVIEW_WIDTH, ' ');
+
+		frame.Write(PREVIEW_X - 1, VIEW_TOP + i, "|", ForegroundColour::WHITE, BackgroundColour::BLACK);
+		frame.Write(PREVIEW_X, VIEW_TOP + i, line, ForegroundColour::WHITE, BackgroundColour::BLACK);
+	}
+}
+
+// Draws a preview that the loader finished while the user was idle, or updates the text viewer.
+
+void FileView::ProcessIdle(FileModel& model) {
+	if (follower)
+	{
+		LogFollower::Change change = follower->Poll();
+		DrawFollow(change.reset_, change.added_, change.partial_);
+	}
+	else if (pager)
+	{
+		// Redo an estimated jump once the index reaches it, and keep the indexing progress current.
+		if (pager->Refine())
+			DrawViewer();
+		else
+			ShowStatus(pager->Describe() + (goTo.empty() ? std::string() : "  Go to: " + goTo));
+	}
+	else if (previewOn && preview.TakeResult(previewLines))
+		DrawPreview();
+}
+
 //Implementation of Framework Class
 
 //creates the checkbox and sets its value to default
@@ -511,281 +1324,1795 @@ Framework::Control::TextBox::TextBox(Control const& c) {
 	yPos_ = c.yPos_;
 	length_ = c.length_;
 
-	foreground_ = c.foreground_;
-	background_ = c.background_;
+	foreground_ = c.foreground_;
+	background_ = c.background_;
+
+	controlID_ = c.controlID_;
+	content_ = c.content_;
+}
+
+//Sets the input textbox to the give parameter
+Framework::Control::InputTextBox::InputTextBox(std::string id, COORD origin, WORD const length, std::string content, ForegroundColour foreground, BackgroundColour background) {
+	// Set internal members.
+	xPos_ = origin.X;
+	yPos_ = origin.Y;
+	length_ = length;
+
+	foreground_ = foreground;
+	background_ = background;
+
+	controlID_ = id;
+	content_ = content;
+
+	cursorPos_ = 0;
+	aperature_ = 0;
+
+	controlHit_ = false;
+}
+
+Framework::Control::InputTextBox::InputTextBox(Control const& c) {
+	// Set internal members.
+	xPos_ = c.xPos_;
+	yPos_ = c.yPos_;
+	length_ = c.length_;
+
+	foreground_ = c.foreground_;
+	background_ = c.background_;
+
+	controlID_ = c.controlID_;
+	content_ = c.content_;
+
+	cursorPos_ = c.cursorPos_;
+	aperature_ = c.aperature_;
+
+	controlHit_ = c.controlHit_;
+}
+
+Framework::Control::FileViewer::FileViewer(std::string id, WORD const x, WORD const height, ForegroundColour foreground, BackgroundColour background) {
+	// Set internal members.
+	xPos_ = x;
+	height_ = height;
+
+	foreground_ = foreground;
+	background_ = background;
+
+	controlID_ = id;
+}
+Framework::Control::FileViewer::FileViewer(Control const& c) {
+	// Set internal members.
+	xPos_ = c.xPos_;
+	height_ = c.height_;
+
+	foreground_ = c.foreground_;
+	background_ = c.background_;
+
+	controlID_ = c.controlID_;
+}
+
+//Methods
+// Adds a layout section to the console to indicate areas of the console that will have
+// certain controls grouped together using the Console thick wrapper function to fill.
+
+void Framework::AddLayoutToConsole(Framework::Layout const& l) {
+	// Make call to the console to fill out the layout section on the screen.
+	console_.Fill(l.startLoc_, l.size_, l.foreground_, l.background_);
+}
+
+// Adds a control to the console to allow for display or interaction with the user, for
+// the program to update the model/view on different inputs using the Console thick wrapper function.
+
+void Framework::AddControlToConsole(Framework::Control const& control) {
+	// Check to see what control we are adding.
+	if (dynamic_cast<Framework::Control::FileViewer const*>(&control))
+	{
+		// Create a FileViewer control and paint to screen.
+		Framework::Control::FileViewer fv = control;
+		console_.Fill(fv.xPos_, fv.height_, fv.foreground_, fv.background_);
+		controls_.insert(std::make_pair(fv.controlID_, control));
+	}
+	else
+	{
+		console_.Draw(control.xPos_, control.yPos_, control.length_, control.foreground_, control.background_);
+		controls_.insert(std::make_pair(control.controlID_, control));
+	}
+}
+
+// Adds a control to the console to allow for text display only using the Console thick wrapper function.
+
+void Framework::AddTextToConsole(Framework::Control const& control) {
+	// Write text at console using control location and console call.
+	console_.Write(control.xPos_, control.yPos_, control.content_, control.foreground_, control.background_);
+}
+
+// Enables a handler to look for Ctrl key events using the Console thick wrapper function.
+
+void Framework::EnableCtrlHandler(PHANDLER_ROUTINE routine) {
+	console_.EnableCtrlHandler(routine);
+}
+
+// Sets the cursor position within the console window and its visibility using the Console thick wrapper function.
+
+void Framework::ResetCursorPosition(SHORT const x, SHORT const y, bool visible) {
+	console_.SetCursor(x, y, visible);
+}
+
+// Used to write text or content to the console at a specific coordinate using the Console thick wrapper function.
+
+void Framework::Write(WORD const x, WORD const y, std::string content, ForegroundColour foreground, BackgroundColour background) {
+	console_.Write(x, y, content, foreground, background);
+}
+
+// Moves a rectangle of the console up using the Console thick wrapper function.
+
+void Framework::ScrollUp(WORD const x, WORD const y, WORD const width, WORD const height, WORD const lines, ForegroundColour foreground, BackgroundColour background) {
+	console_.ScrollUp(x, y, width, height, lines, foreground, background);
+}
+
+// Used to call specific console functions to set size, title and other functions to create the eventual look
+// and feel of the file browser using the Console thick wrapper functions.
+
+void Framework::SetupConsole() {
+	console_.SetTitle("TUI File Browser").SetSize(130, 50).SetCursor(0, 0, false).SetBackgroundColour(BackgroundColour::WHITE).EnableKeyboardAndMouse();
+}
+
+
+// Updates the recursive toggle on the view to indicate whether or not
+// the search is a recursive or non-recursive by writing to the control's content
+// using the Write function.
+
+void Framework::Control::Checkbox::UpdateCheckState(Framework::Control::Checkbox const& c) {
+	frame.Write(c.xPos_, c.yPos_, c.content_, c.foreground_, c.background_);
+}
+
+// Updates the folder or filter input with the content from the console arguments passed in at program
+// start, or with the new user's input by writing to the control's content
+// using the Write function.
+
+void Framework::Control::InputTextBox::UpdateInputContent(Framework::Control::InputTextBox const& itb) {
+	frame.Write(itb.xPos_, itb.yPos_, itb.content_, itb.foreground_, itb.background_);
+}
+
+// Updates the file search stats on the bottom of the console with the content after
+// each new model scan by writing to the control's content, once to clear and once with the actual content,
+// using the Write function.
+
+void Framework::Control::TextBox::UpdateContent(Framework::Control::TextBox const& tbx) {
+	frame.Write(tbx.xPos_, tbx.yPos_, std::string(tbx.length_, ' '), tbx.foreground_, tbx.background_);
+	frame.Write(tbx.xPos_, tbx.yPos_, tbx.content_, tbx.foreground_, tbx.background_);
+}
+/**
+* Writes new files/content to the view when a model completes a new scan using the Write function.
+*/
+void Framework::Control::FileViewer::UpdateFileView(Framework::Control::FileViewer const& fv) {
+	frame.Write(fv.xPos_, fv.yPos_, fv.content_, fv.foreground_, fv.background_);
+}
+
+// Clears the contents of the fileview area by looping through the immediately viewable area,
+// and using the Write function to write a blank string across the whole length of the control.
+
+void Framework::Control::FileViewer::ClearFileView() {
+	WORD row = 13;
+	for (auto i = 0; i <= 28; i++) {
+		frame.Write(1, row++, std::string(200, ' '), ForegroundColour::WHITE, BackgroundColour::BLACK);
+	}
+}
+
+// Updates the variables within the particular control, saving its state by looping through the map,
+// finding the matching key value, and setting the Control associated with the key to the control reference.
+
+void Framework::Control::Update(Framework::Control& control) {
+	for (std::map<std::string, Control>::iterator it = frame.controls_.begin(); it != frame.controls_.end(); ++it) {
+		if (it->first == control.controlID_) {
+			it->second = control;
+			break;
+		}
+	}
+}
+
+// Returns an event from the console's read in input by using the Console thick wrapper function.
+
+Event Framework::GetEvent() {
+	std::vector<INPUT_RECORD> inBuffer;
+	DWORD numEvent;
+
+	console_.GetEvent(inBuffer, numEvent);
+	auto e  = Event::Event(inBuffer[0]);
+	return e;
+}
+
+// Reads any pending console input using the Console thick wrapper function and looks for an Esc key press.
+// Other events that arrive while a pass is running are dropped.
+
+bool Framework::EscapePressed() {
+	std::vector<INPUT_RECORD> inBuffer;
+	DWORD numEvent;
+
+	console_.PollEvents(inBuffer, numEvent);
+	for (DWORD i = 0; i < numEvent; ++i)
+	{
+		Event e(inBuffer[i]);
+		if (e.GetType() == Event::EventType::KEY && e.GetKeyboardEvent().KeyDown() && e.GetKeyboardEvent().VirtualKeyCode() == VK_ESCAPE)
+			return true;
+	}
+
+	return false;
+}
+
+// Reads any pending console input using the Console thick wrapper function and collects its key presses.
+
+std::vector<WORD> Framework::PressedKeys() {
+	std::vector<INPUT_RECORD> inBuffer;
+	DWORD numEvent;
+	std::vector<WORD> keys;
+
+	console_.PollEvents(inBuffer, numEvent);
+	for (DWORD i = 0; i < numEvent; ++i)
+	{
+		Event e(inBuffer[i]);
+		if (e.GetType() == Event::EventType::KEY && e.GetKeyboardEvent().KeyDown())
+			keys.push_back(e.GetKeyboardEvent().VirtualKeyCode());
+	}
+
+	return keys;
+}
+
+// Waits for console input using the Console thick wrapper function.
+
+bool Framework::WaitForEvent(unsigned ms) {
+	bool ready = false;
+	console_.WaitForEvent(ms, ready);
+	return ready;
+}
+
+// Gets the current working directory that the executable of this program is located in,
+// by using the Console thick wrapper function.
+
+std::string Framework::GetCurrentDir() {
+	std::string dir = console_.GetCurrentDir();
+	return dir;
+}
+
+
+
+//Method
+// A method that will scan a folder for files by first setting the state of the model's variables to zero
+// and then walking the folder (and, if the recurse flag is set, its sub-folders) on the scan engine's worker threads
+// starting at the passed in path "f". Each worker keeps its own shard of results so the hot path takes no shared lock.
+// In the file listing, every match is kept and the shards are merged and sorted at the end. In the largest/newest
+// listings, each shard keeps only a bounded leaderboard, so memory stays O(K) however big the tree is, and the
+// shards are merged on each engine tick so the leaderboard can be shown while the scan continues.
+
+void FileModel::Scan(std::tr2::sys::path const& f, std::regex const& r, bool recurse, std::function<void()> const& progress) {
+	// Zero out counters/file list before each scan.
+	sFiles_ = 0;
+	mFiles_ = 0;
+	startRow_ = 0;
+	fPos_ = 0;
+	selected_ = 0;
+	fSize_ = 0;
+	files_.clear();
+	leaders_.clear();
+	rows_.clear();
+	rowPaths_.clear();
+	status_.clear();
+	fuzzy_.reset();
+	nameIndex_.reset();
+	nameHits_.clear();
+	tree_.reset();
+	rowFolders_.clear();
+	folders_.clear();
+	root_ = folder_;
+	impact_.clear();
+	skipped_ = 0;
+	errors_.clear();
+	scanErrors_.reset();
+	store_.reset();
+	index_.reset();
+	segment_.reset();
+
+	// A folder the index daemon holds is not walked; its rows are read from the daemon's segment, or asked for
+	// as they are shown.
+	if (recurse && (OpenSegment(f.string()) || OpenIndex(f.string())))
+		return;
+
+	bool const ranked = listing_ != Listing::FILES;
+
+	MultiScan engine(MultiScan::SplitRoots(f.string()));
+	engine.SetThrottle(throttle_.get());
+	roots_ = engine.GetRoots();
+
+	// With worker processes, the walk is spread over them rather than over this process's threads. The engine
+	// still settles the roots, and which one each file is under.
+	std::unique_ptr<ProcessScan> processes;
+	if (processes_)
+	{
+		processes.reset(new ProcessScan(roots_, processes_));
+		processes->SetThrottle(throttle_.get());
+	}
+	unsigned const workers = processes ? processes->GetProcessCount() : engine.GetThreadCount();
+	ScanErrors& errors = processes ? processes->GetErrors() : engine.GetErrors();
+	auto searched = [&] { return processes ? processes->GetSearched() : engine.GetSearched(); };
+
+	progress_.reset(new ScanProgress);
+	progress_->Reset(workers);
+	engine.SetProgress(progress_.get());
+	if (processes)
+		processes->SetProgress(progress_.get());
+
+	// With a memory budget, each worker spills its files to disk whenever they outgrow its share of it.
+	std::shared_ptr<ResultStore> store;
+	if (budget_ && !ranked)
+		store = std::make_shared<ResultStore>(budget_, workers);
+	std::vector<std::unique_ptr<ScanShard>> shards;
+	for (unsigned i = 0; i < workers; ++i)
+		shards.push_back(std::unique_ptr<ScanShard>(new ScanShard(RankFiles(listing_), roots_.size())));
+
+	// Merges the per-thread leaderboards. Each holds at most LEADERBOARD_SIZE entries, so this is cheap enough
+	// to run on every tick.
+	auto collectLeaders = [&] {
+		BoundedHeap<FileEntry, RankFiles> merged(LEADERBOARD_SIZE, RankFiles(listing_));
+		for (auto& shard : shards)
+		{
+			std::lock_guard<std::mutex> lk(shard->lock_);
+			merged.Merge(shard->leaders_);
+		}
+		leaders_ = merged.Sorted();
+	};
+
+	// A recursive scan saves a checkpoint every CHECKPOINT_INTERVAL, and a later scan of the same folders with the
+	// same filter and listing picks up from the last one instead of starting over: what it had found is read back
+	// and the walk starts from the folders it still had queued. Not with a memory budget, whose chunks on disk
+	// belong to the browser that wrote them.
+	ScanCheckpoint checkpoint(std::to_string(static_cast<int>(listing_)) + "|" + regex_ + "|" + f.string());
+	bool const checkpointing = recurse && !store && checkpoint.IsEnabled();
+	bool resumed = false;
+	ScanCheckpoint::State base;
+	base.rootMatched_.assign(roots_.size(), 0);
+	base.rootBytes_.assign(roots_.size(), 0);
+	if (checkpointing)
+	{
+		ScanCheckpoint::State saved;
+		resumed = checkpoint.Load(saved, files_, folders_) && saved.rootMatched_.size() == roots_.size();
+		if (resumed)
+		{
+			if (processes)
+				processes->SetStart(saved.pending_);
+			else
+				engine.SetStart(saved.pending_);
+			for (auto const& leader : saved.leaders_)
+				shards[0]->leaders_.Offer(leader);
+			base.searched_ = saved.searched_;
+			base.matched_ = saved.matched_;
+			base.bytes_ = saved.bytes_;
+			base.rootMatched_ = saved.rootMatched_;
+			base.rootBytes_ = saved.rootBytes_;
+		}
+		else
+		{
+			files_.clear();
+			folders_.clear();
+			checkpoint.Remove();
+		}
+	}
+
+	// Taken with every worker paused, or with worker processes between folders handed on, so the shards only
+	// hold files from folders listed in full. Only what was found since the last checkpoint is written, as a
+	// delta; the shards' marks move on once it is saved.
+	auto saveCheckpoint = [&] {
+		auto save = [&](std::vector<std::string> const& pending) {
+			ScanCheckpoint::State state = base;
+			state.searched_ += searched();
+			state.pending_ = pending;
+
+			std::vector<FileEntry> files;
+			std::vector<FolderEntry> folders;
+			for (auto& shard : shards)
+			{
+				state.matched_ += shard->matched_;
+				state.bytes_ += shard->bytes_;
+				for (std::size_t i = 0; i < roots_.size(); ++i)
+				{
+					state.rootMatched_[i] += shard->rootMatched_[i];
+					state.rootBytes_[i] += shard->rootBytes_[i];
+				}
+				files.insert(files.end(), shard->files_.begin() + shard->savedFiles_, shard->files_.end());
+				folders.insert(folders.end(), shard->folders_.begin() + shard->savedFolders_, shard->folders_.end());
+			}
+			if (ranked)
+			{
+				collectLeaders();
+				state.leaders_ = leaders_;
+			}
+
+			if (checkpoint.Save(state, files, folders))
+			{
+				for (auto& shard : shards)
+				{
+					shard->savedFiles_ = shard->files_.size();
+					shard->savedFolders_ = shard->folders_.size();
+				}
+			}
+		};
+
+		if (processes)
+			processes->Checkpoint(save);
+		else
+			engine.Checkpoint(save);
+	};
+	auto checkpointed = std::chrono::steady_clock::now();
+
+	// Folder listings and file stats per second since the scan started, which is what it asks of the disks, and
+	// in background mode the worker time spent waiting for the rate limit.
+	auto const start = std::chrono::steady_clock::now();
+	double const waited = throttle_ ? throttle_->GetWaitedSeconds() : 0;
+	std::atomic<unsigned long long> stats(0);
+	auto measureImpact = [&] {
+		double const seconds = std::max(0.001, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		std::ostringstream os;
+		unsigned long long const listed = processes ? processes->GetListed() : engine.GetListed();
+		os << std::fixed << std::setprecision(0) << listed / seconds << " listings/s, " << stats.load(std::memory_order_relaxed) / seconds << " stats/s";
+		if (throttle_ && throttle_->IsBackground())
+			os << "; background, workers held " << std::setprecision(1) << throttle_->GetWaitedSeconds() - waited << "s";
+		impact_ = os.str();
+	};
+
+	// Counts a file that matched and keeps it in the worker's shard.
+	auto keep = [&](unsigned worker, FileEntry const& entry) {
+		// Increment counters.
+		ScanShard& shard = *shards[worker];
+		shard.matched_++;
+		shard.bytes_ += entry.size_;
+		progress_->Matched(worker, entry.size_);
+		std::size_t const root = engine.RootOf(entry.path_);
+		shard.rootMatched_[root]++;
+		shard.rootBytes_[root] += entry.size_;
+
+		// Add to the leaderboard or the file list.
+		if (ranked)
+		{
+			std::lock_guard<std::mutex> lk(shard.lock_);
+			shard.leaders_.Offer(entry);
+		}
+		else
+		{
+			shard.files_.push_back(entry);
+			if (store)
+			{
+				shard.memory_ += ResultStore::Footprint(shard.files_.back());
+				if (shard.memory_ > store->GetShare())
+				{
+					store->Spill(shard.files_);
+					shard.memory_ = 0;
+				}
+			}
+		}
+	};
+
+	auto tick = [&] {
+		if (checkpointing && std::chrono::steady_clock::now() - checkpointed >= CHECKPOINT_INTERVAL)
+		{
+			saveCheckpoint();
+			checkpointed = std::chrono::steady_clock::now();
+		}
+
+		sFiles_ = base.searched_ + searched();
+		if (ranked)
+			collectLeaders();
+		measureImpact();
+		skipped_ = errors.GetTotal();
+		if (progress)
+			progress();
+	};
+
+	// The worker processes filter and stat the files themselves, and hand on only the ones that matched.
+	if (processes)
+	{
+		processes->Run(recurse, regex_,
+			[&](unsigned worker, FileEntry const& entry) {
+				stats.fetch_add(1, std::memory_order_relaxed);
+				keep(worker, entry);
+			},
+			tick,
+			[&](unsigned worker, FolderEntry const& folder) {
+				if (!ranked)
+					shards[worker]->folders_.push_back(folder);
+			});
+	}
+	else
+	{
+		engine.Run(recurse,
+			[&](unsigned worker, std::tr2::sys::path const& file) {
+				// Check to see if extension of file matches files we are looking for.
+				std::string ext = file.extension();
+				if (!std::regex_match(ext, r))
+					return;
+
+				// Describing the file is a stat, which background mode counts against its rate.
+				if (throttle_)
+					throttle_->Take();
+				stats.fetch_add(1, std::memory_order_relaxed);
+
+				std::error_code ec;
+				FileEntry entry = ScanEngine::Describe(file, ec);
+				if (ec)
+				{
+					// Gone or locked since it was listed; it is skipped like an unreadable folder.
+					errors.Count(ec, entry.path_);
+					return;
+				}
+				keep(worker, entry);
+			},
+			tick,
+			[&](unsigned worker, std::tr2::sys::path const& folder) {
+				// Remember every folder of the file listing and when it last changed, for Refresh.
+				if (!ranked)
+					shards[worker]->folders_.push_back(FolderEntry(folder.string(), ScanEngine::Stamp(folder.string())));
+			});
+	}
+
+	// Combine the shards. Once some files have gone to disk, the rest follow a shard at a time rather than
+	// being gathered first, which would hold the whole budget twice over.
+	bool const spilled = store && store->IsSpilled();
+	mFiles_ = base.matched_;
+	unsigned long long bytes = base.bytes_;
+	std::vector<unsigned long long> rootMatched = base.rootMatched_;
+	std::vector<unsigned long long> rootBytes = base.rootBytes_;
+	for (auto& shard : shards)
+	{
+		mFiles_ += shard->matched_;
+		bytes += shard->bytes_;
+		for (std::size_t i = 0; i < roots_.size(); ++i)
+		{
+			rootMatched[i] += shard->rootMatched_[i];
+			rootBytes[i] += shard->rootBytes_[i];
+		}
+		if (spilled && !shard->files_.empty())
+			store->Spill(shard->files_);
+		files_.insert(files_.end(), shard->files_.begin(), shard->files_.end());
+		folders_.insert(folders_.end(), shard->folders_.begin(), shard->folders_.end());
+	}
+
+	// Workers finish in any order, so sort to keep the listing stable between scans.
+	std::sort(files_.begin(), files_.end(), [](FileEntry const& a, FileEntry const& b) { return a.path_ < b.path_; });
+	std::sort(folders_.begin(), folders_.end(), [](FolderEntry const& a, FolderEntry const& b) { return a.path_ < b.path_; });
+
+	if (ranked)
+		collectLeaders();
+
+	// The chunks are merged into one file on disk, and the listing is read from there. Anything a chunk could
+	// not be written for is still in files_ and is merged in from memory.
+	if (spilled)
+	{
+		if (store->Finish(files_))
+			store_ = store;
+		files_.clear();
+	}
+
+	// The walk got to the end, so there is nothing left to pick up.
+	if (checkpointing)
+		checkpoint.Remove();
+
+	sFiles_ = base.searched_ + searched();
+	fSize_ = bytes / BYTES_TO_MB;
+	measureImpact();
+	skipped_ = errors.GetTotal();
+	errors_ = errors.Summarize();
+	scanErrors_ = std::make_shared<ScanErrors>();
+	scanErrors_->Add(errors);
+
+	first_ = 0;
+	end_ = store_ ? static_cast<std::size_t>(store_->GetCount()) : files_.size();
+
+	// Index the names and folders now, while the scan's progress is still on screen, so substring searches
+	// and folder changes answer at once.
+	if (!ranked && !files_.empty())
+	{
+		Index();
+
+		std::ostringstream status;
+		status << "Name index: " << nameIndex_->GetTrigramCount() << " trigrams, " << ToMB(nameIndex_->GetMemory()) << " ("
+			<< ToMB(nameIndex_->GetPostingMemory()) << " in lists), built in " << std::fixed << std::setprecision(2) << nameIndex_->GetBuildSeconds() << "s; "
+			<< tree_->GetNodeCount() << " folder nodes";
+		status_ = status.str();
+	}
+
+	// With several roots, the footer's totals are broken down by root instead.
+	if (roots_.size() > 1)
+	{
+		std::ostringstream status;
+		status << roots_.size() << " roots on " << engine.GetDeviceCount() << " volumes:";
+		for (std::size_t i = 0; i < roots_.size(); ++i)
+			status << (i ? "; " : " ") << roots_[i] << " " << rootMatched[i] << " files " << ToMB(rootBytes[i]);
+		status_ = status.str();
+	}
+
+	// Say where the files went, since the passes that need them in memory will turn them down.
+	if (spilled)
+	{
+		std::ostringstream status;
+		if (store_)
+			status << "Over the " << ToMB(budget_) << " memory budget: " << store_->GetCount() << " files on disk, " << store_->GetSpillCount() << " chunks spilled";
+		else
+			status << "Over the " << ToMB(budget_) << " memory budget, and the files could not be moved to " << GetCacheFolder();
+		status_ = status.str();
+	}
+
+	if (resumed)
+		status_ = "Picked up from a checkpoint" + (status_.empty() ? std::string() : "; " + status_);
+	if (processes && processes->GetCrashCount())
+		status_ = std::to_string(processes->GetCrashCount()) + " worker processes died and their folders were listed again" + (status_.empty() ? std::string() : "; " + status_);
+}
+
+// Every known folder is stamped again on the thread pool, which is one attribute query each. A folder whose
+// stamp moved is listed again: its files replace the ones kept for it, sub-folders that went away take their
+// whole subtree with them, and new sub-folders are scanned in full. Files in unchanged folders are kept as
+// they were, so a file rewritten in place, which does not touch its folder's stamp, keeps its old size and time.
+// What cannot be read is counted as a scan counts it and keeps what the last scan had: an entry of a changed
+// folder keeps its old file or folder, and a folder that cannot be listed to the end is left as it was.
+
+bool FileModel::Refresh(std::function<void()> const& progress) {
+	if (segment_)
+		return SegmentReader::GetPublished() != segment_->GetNumber() && OpenSegment(folder_);
+
+	if (folders_.empty() || !recursion_ || listing_ == Listing::LARGEST || listing_ == Listing::NEWEST || store_)
+		return false;
+
+	auto start = std::chrono::steady_clock::now();
+	std::regex const r(regex_);
+	std::size_t const known = folders_.size();
+	std::size_t const before = files_.size();
+	ThreadPool pool;
+
+	std::vector<long long> stamps(folders_.size());
+	pool.ParallelFor(folders_.size(), [&](unsigned, std::size_t i) {
+		stamps[i] = ScanEngine::Stamp(folders_[i].path_);
+	}, progress);
+
+	std::vector<std::size_t> changed;
+	for (std::size_t i = 0; i < folders_.size(); ++i)
+		if (stamps[i] != folders_[i].stamp_)
+			changed.push_back(i);
+
+	// What listing a changed folder found now. unread_ are the entries that could not be looked at, and kept_
+	// is set if the folder could not be listed to the end and so stays as it was.
+	struct Listed
+	{
+		std::vector<FileEntry>		files_;
+		std::vector<std::string>	folders_;
+		std::vector<std::string>	unread_;
+		bool						gone_;
+		bool						kept_;
+	};
+
+	ScanErrors errors;
+	std::atomic<unsigned long long> searched(0);
+	std::vector<Listed> listed(changed.size());
+	pool.ParallelFor(changed.size(), [&](unsigned, std::size_t c) {
+		Listed& l = listed[c];
+		l.gone_ = stamps[changed[c]] == ScanEngine::MISSING;
+		l.kept_ = false;
+		if (l.gone_)
+			return;
+
+		std::error_code ec;
+		std::tr2::sys::directory_iterator d(folders_[changed[c]].path_, ec);
+		std::tr2::sys::directory_iterator e;
+		for (; !ec && d != e; d.increment(ec))
+		{
+			searched.fetch_add(1, std::memory_order_relaxed);
+
+			std::error_code sec;
+			std::tr2::sys::file_status const status = d->status(sec);
+			if (sec)
+			{
+				errors.Count(sec, d->path().string());
+				l.unread_.push_back(d->path().string());
+			}
+			else if (is_directory(status))
+				l.folders_.push_back(d->path().string());
+			else
+			{
+				std::string ext = d->path().extension();
+				if (!std::regex_match(ext, r))
+					continue;
+
+				FileEntry entry = ScanEngine::Describe(d->path(), sec);
+				if (sec)
+				{
+					errors.Count(sec, entry.path_);
+					l.unread_.push_back(d->path().string());
+				}
+				else
+					l.files_.push_back(entry);
+			}
+		}
+
+		if (ec)
+		{
+			// A folder that went away since it was stamped goes; one that cannot be read stays as it was.
+			errors.Count(ec, folders_[changed[c]].path_);
+			l.gone_ = ScanErrors::Classify(ec) == ScanErrors::VANISHED;
+			l.kept_ = !l.gone_;
+		}
+	}, progress);
+
+	// Mark what the changed folders no longer hold, and collect what they hold now.
+	std::vector<bool> dropFile(files_.size(), false);
+	std::vector<bool> dropFolder(folders_.size(), false);
+	std::vector<FileEntry> added;
+	std::vector<std::string> newFolders;
+	std::size_t removedFolders = 0;
+
+	auto dropSubtree = [&](std::size_t folder) {
+		std::string const prefix = UnderFolder(folders_[folder].path_);
+		auto files = UnderPrefix(files_, prefix);
+		auto folders = UnderPrefix(folders_, prefix);
+		for (std::size_t i = files.first; i < files.second; ++i)
+			dropFile[i] = true;
+		for (std::size_t i = folders.first; i < folders.second; ++i)
+			dropFolder[i] = true;
+		dropFolder[folder] = true;
+		++removedFolders;
+	};
+
+	for (std::size_t c = 0; c < changed.size(); ++c)
+	{
+		std::size_t const folder = changed[c];
+		if (dropFolder[folder])
+			continue;
+		if (listed[c].gone_)
+		{
+			dropSubtree(folder);
+			continue;
+		}
+		if (listed[c].kept_)
+			continue;
+
+		folders_[folder].stamp_ = stamps[folder];
+		std::string const prefix = UnderFolder(folders_[folder].path_);
+		std::vector<std::string>& unread = listed[c].unread_;
+		std::sort(unread.begin(), unread.end());
+
+		auto files = UnderPrefix(files_, prefix);
+		for (std::size_t i = files.first; i < files.second; ++i)
+			if (files_[i].path_.find_first_of("\\/", prefix.size()) == std::string::npos && !std::binary_search(unread.begin(), unread.end(), files_[i].path_))
+				dropFile[i] = true;
+		added.insert(added.end(), listed[c].files_.begin(), listed[c].files_.end());
+
+		std::vector<std::string>& now = listed[c].folders_;
+		std::sort(now.begin(), now.end());
+
+		auto under = UnderPrefix(folders_, prefix);
+		for (std::size_t i = under.first; i < under.second; ++i)
+			if (!dropFolder[i] && folders_[i].path_.find_first_of("\\/", prefix.size()) == std::string::npos && !std::binary_search(now.begin(), now.end(), folders_[i].path_)
+				&& !std::binary_search(unread.begin(), unread.end(), folders_[i].path_))
+				dropSubtree(i);
+
+		for (auto const& sub : now)
+		{
+			auto at = std::lower_bound(folders_.begin(), folders_.end(), sub, [](FolderEntry const& f, std::string const& p) { return f.path_ < p; });
+			if (at == folders_.end() || at->path_ != sub)
+				newFolders.push_back(sub);
+		}
+	}
+
+	// New folders are walked like a scan, folders included.
+	std::vector<FolderEntry> addedFolders;
+	std::mutex lock;
+	for (auto const& folder : newFolders)
+	{
+		ScanEngine engine;
+		engine.SetThrottle(throttle_.get());
+		engine.SetErrors(&errors);
+		engine.Run(std::tr2::sys::path(folder), true,
+			[&](unsigned, std::tr2::sys::path const& file) {
+				std::string ext = file.extension();
+				if (!std::regex_match(ext, r))
+					return;
+
+				std::error_code ec;
+				FileEntry entry = ScanEngine::Describe(file, ec);
+				if (ec)
+				{
+					errors.Count(ec, entry.path_);
+					return;
+				}
+				std::lock_guard<std::mutex> lk(lock);
+				added.push_back(entry);
+			},
+			progress,
+			[&](unsigned, std::tr2::sys::path const& sub) {
+				FolderEntry entry(sub.string(), ScanEngine::Stamp(sub.string()));
+				std::lock_guard<std::mutex> lk(lock);
+				addedFolders.push_back(entry);
+			});
+		searched += engine.GetSearched();
+	}
+
+	// Splice: keep what was not dropped and merge in what was found, both sorted by path.
+	std::size_t removed = 0;
+	std::vector<FileEntry> files;
+	files.reserve(files_.size() + added.size());
+	for (std::size_t i = 0; i < files_.size(); ++i)
+	{
+		if (dropFile[i])
+			++removed;
+		else
+			files.push_back(std::move(files_[i]));
+	}
+
+	auto byPath = [](FileEntry const& a, FileEntry const& b) { return a.path_ < b.path_; };
+	std::sort(added.begin(), added.end(), byPath);
+	std::size_t const kept = files.size();
+	files.insert(files.end(), added.begin(), added.end());
+	std::inplace_merge(files.begin(), files.begin() + kept, files.end(), byPath);
+	files_.swap(files);
+
+	std::vector<FolderEntry> folders;
+	for (std::size_t i = 0; i < folders_.size(); ++i)
+		if (!dropFolder[i])
+			folders.push_back(folders_[i]);
+	folders.insert(folders.end(), addedFolders.begin(), addedFolders.end());
+	std::sort(folders.begin(), folders.end(), [](FolderEntry const& a, FolderEntry const& b) { return a.path_ < b.path_; });
+	folders_.swap(folders);
+
+	unsigned long long bytes = 0;
+	for (auto const& f : files_)
+		bytes += f.size_;
+
+	std::shared_ptr<ScanErrors> const merged = std::make_shared<ScanErrors>();
+	if (scanErrors_)
+		merged->Add(*scanErrors_);
+	merged->Add(errors);
+	scanErrors_ = merged;
+
+	// The folders not re-read keep what the scan found in them, so this pass's counts go on top of the scan's.
+	sFiles_ += searched;
+	mFiles_ = files_.size();
+	fSize_ = bytes / BYTES_TO_MB;
+	skipped_ = scanErrors_->GetTotal();
+	errors_ = scanErrors_->Summarize();
+	listing_ = Listing::FILES;
+	fPos_ = 0;
+	selected_ = 0;
+	rows_.clear();
+	rowPaths_.clear();
+	rowFolders_.clear();
+	fuzzy_.reset();
+	nameHits_.clear();
+
+	if (removed || !added.empty())
+		Index();
+
+	double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::ostringstream status;
+	status << "Refresh: " << changed.size() << " folders re-read, " << known - changed.size() << " skipped, "
+		<< addedFolders.size() << " new, " << removedFolders << " removed; " << added.size() << " files listed, "
+		<< (files_.size() >= before ? "+" : "-") << (files_.size() >= before ? files_.size() - before : before - files_.size()) << " in all, in "
+		<< std::fixed << std::setprecision(2) << seconds << "s";
+	status_ = status.str();
+	return true;
+}
+
+// The folder shown is looked up again in the new tree, and the scanned folder is shown if it is gone.
+
+void FileModel::Index() {
+	nameIndex_.reset();
+	tree_.reset();
+	first_ = 0;
+	end_ = files_.size();
+	node_ = 0;
+	nodeRest_.clear();
+	if (files_.empty())
+		return;
+
+	nameIndex_ = std::make_shared<TrigramIndex>(files_);
+	tree_ = std::make_shared<PathTree>(files_);
+
+	node_ = FindFolder(folder_, &nodeRest_);
+	if (node_ == PathTree::NONE)
+	{
+		folder_ = root_;
+		node_ = FindFolder(folder_, &nodeRest_);
+	}
+	if (node_ != PathTree::NONE)
+	{
+		first_ = tree_->GetFirst(node_);
+		end_ = tree_->GetEnd(node_);
+	}
+}
+
+// Runs the staged duplicate finder over the scanned files. Each group becomes a header row with the
+// file size, copy count and reclaimable bytes, followed by one indented row per copy. The status line
+// reports the totals and the bytes each stage had to read.
+
+void FileModel::FindDuplicates(std::function<void()> const& progress) {
+	if (store_ || index_ || segment_)
+	{
+		status_ = store_ ? SPILLED : SERVED;
+		return;
+	}
+
+	std::vector<FileEntry> subset;
+	DuplicateFinder finder;
+	std::vector<DuplicateGroup> groups = finder.Find(GetShownFiles(subset), progress);
+
+	rows_.clear();
+	rowPaths_.clear();
+	for (auto const& g : groups)
+	{
+		std::ostringstream header;
+		header << g.paths_.size() << " x " << ToMB(g.size_) << "  (" << ToMB(g.GetReclaimable()) << " reclaimable)";
+		rows_.push_back(header.str());
+		rowPaths_.push_back(std::string());
+
+		for (auto const& p : g.paths_)
+		{
+			rows_.push_back("    " + p);
+			rowPaths_.push_back(p);
+		}
+	}
+
+	DuplicateFinder::Stats const& stats = finder.GetStats();
+	std::ostringstream status;
+	status << stats.groups_ << " groups, " << ToMB(stats.reclaimable_) << " reclaimable. Read: edges "
+		<< ToMB(stats.bytesRead_[DuplicateFinder::EDGES]) << " (" << stats.candidates_[DuplicateFinder::EDGES] << " files), content "
+		<< ToMB(stats.bytesRead_[DuplicateFinder::CONTENT]) << " (" << stats.candidates_[DuplicateFinder::CONTENT] << " files)";
+	status_ = status.str();
+
+	listing_ = Listing::DUPLICATES;
+}
+
+// Runs the content search over the scanned files. On every tick the hits found so far are moved into the
+// listing, so the viewer fills in while the search runs, and the status line shows the running totals.
+// The final status reports the throughput of the search.
+
+void FileModel::SearchContents(std::string const& pattern, std::function<bool()> const& progress) {
+	if (store_ || index_ || segment_)
+	{
+		status_ = store_ ? SPILLED : SERVED;
+		return;
+	}
+
+	rows_.clear();
+	rowPaths_.clear();
+	listing_ = Listing::MATCHES;
+
+	std::unique_ptr<ContentSearch> search;
+	try
+	{
+		search.reset(new ContentSearch(pattern));
+	}
+	catch (std::regex_error&)
+	{
+		status_ = "Invalid search pattern.";
+		return;
+	}
+
+	auto collect = [&] {
+		for (auto const& hit : search->TakeHits())
+		{
+			std::ostringstream row;
+			row << hit.path_ << ":" << hit.line_ << ": " << hit.text_;
+			rows_.push_back(row.str());
+			rowPaths_.push_back(hit.path_);
+		}
+
+		ContentSearch::Stats const stats = search->GetStats();
+		std::ostringstream status;
+		status << stats.hits_ << " hits in " << stats.matchedFiles_ << " files, " << ToMB(stats.bytes_) << " read";
+		if (stats.seconds_ > 0)
+			status << " in " << std::fixed << std::setprecision(2) << stats.seconds_ << "s (" << stats.bytes_ / stats.seconds_ / 1e9 << " GB/s)";
+		if (stats.hits_ >= ContentSearch::MAX_HITS)
+			status << " [hit limit]";
+		else if (stats.cancelled_)
+			status << " [cancelled]";
+		status_ = status.str();
+	};
+
+	std::vector<FileEntry> subset;
+	search->Run(GetShownFiles(subset), [&] {
+		collect();
+		if (progress && !progress())
+			search->Cancel();
+	});
+
+	collect();
+}
+
+// The manifest goes into the folder shown and names the files shown relative to it, so sha256sum -c run there
+// checks it. Files that could not be read are listed, and the status line reports the throughput of the pass.
+
+void FileModel::WriteManifest(ChecksumManifest::Algorithm algorithm, std::function<bool()> const& progress) {
+	if (store_ || index_ || segment_)
+	{
+		status_ = store_ ? SPILLED : SERVED;
+		return;
+	}
+	if (folder_.find(';') != std::string::npos)
+	{
+		status_ = "A manifest covers one folder; show one of the scanned folders first.";
+		return;
+	}
+
+	std::string const path = UnderFolder(folder_) + ChecksumManifest::GetName(algorithm);
+	char const* const name = algorithm == ChecksumManifest::CRC32C ? (Crc32c::IsHardware() ? "CRC-32C (SSE4.2)" : "CRC-32C") : "SHA-256";
+	ChecksumManifest manifest(algorithm);
+	auto report = [&] {
+		ChecksumManifest::Stats const stats = manifest.GetStats();
+		std::ostringstream status;
+		status << "Hashing with " << name << ": " << stats.files_ << " files, " << ToMB(stats.bytes_) << " read";
+		status_ = status.str();
+	};
+
+	std::vector<FileEntry> subset;
+	bool const written = manifest.Write(GetShownFiles(subset), folder_, path, [&] {
+		report();
+		if (progress && !progress())
+			manifest.Cancel();
+	});
+
+	rows_.clear();
+	rowPaths_.clear();
+	for (auto const& p : manifest.TakeProblems())
+	{
+		rows_.push_back("UNREADABLE  " + p.path_);
+		rowPaths_.push_back(p.path_);
+	}
+	if (!rows_.empty())
+		listing_ = Listing::MANIFEST;
+
+	ChecksumManifest::Stats const stats = manifest.GetStats();
+	std::ostringstream status;
+	if (stats.cancelled_)
+		status << "Manifest cancelled; nothing written.";
+	else if (!written)
+		status << "Cannot write " << path;
+	else
+	{
+		status << name << " manifest of " << stats.files_ << " files (" << ToMB(stats.bytes_) << ") written to " << path;
+		if (stats.seconds_ > 0)
+			status << " in " << std::fixed << std::setprecision(2) << stats.seconds_ << "s (" << stats.bytes_ / stats.seconds_ / BYTES_TO_MB << " MB/s)";
+		if (stats.unreadable_)
+			status << "; " << stats.unreadable_ << " unreadable left out";
+	}
+	status_ = status.str();
+}
+
+// Problems are listed as they come in, each prefixed with what went wrong; a missing file keeps no path, as there
+// is nothing to open.
+
+void FileModel::VerifyManifest(std::function<bool()> const& progress) {
+	std::string path = UnderFolder(folder_) + ChecksumManifest::SHA256_NAME;
+	if (GetFileAttributesA(path.c_str()) == INVALID_FILE_ATTRIBUTES)
+		path = UnderFolder(folder_) + ChecksumManifest::CRC32C_NAME;
+	if (GetFileAttributesA(path.c_str()) == INVALID_FILE_ATTRIBUTES)
+	{
+		status_ = std::string("No ") + ChecksumManifest::SHA256_NAME + " or " + ChecksumManifest::CRC32C_NAME + " in " + folder_;
+		return;
+	}
+
+	rows_.clear();
+	rowPaths_.clear();
+	listing_ = Listing::MANIFEST;
+
+	ChecksumManifest manifest;
+	auto collect = [&] {
+		for (auto const& p : manifest.TakeProblems())
+		{
+			char const* const outcome = p.outcome_ == ChecksumManifest::FAILED ? "FAILED      " : p.outcome_ == ChecksumManifest::MISSING ? "MISSING     " : "UNREADABLE  ";
+			rows_.push_back(outcome + p.path_);
+			rowPaths_.push_back(p.outcome_ == ChecksumManifest::MISSING ? std::string() : p.path_);
+		}
+
+		ChecksumManifest::Stats const stats = manifest.GetStats();
+		std::ostringstream status;
+		status << stats.files_ << " files checked against " << path << ": " << stats.files_ - stats.failed_ << " good, " << stats.failed_
+			<< " failed, " << stats.missing_ << " missing, " << stats.unreadable_ << " unreadable";
+		if (stats.malformed_)
+			status << ", " << stats.malformed_ << " bad lines";
+		status << "; " << ToMB(stats.bytes_) << " read";
+		if (stats.seconds_ > 0)
+			status << " in " << std::fixed << std::setprecision(2) << stats.seconds_ << "s (" << stats.bytes_ / stats.seconds_ / BYTES_TO_MB << " MB/s)";
+		if (stats.cancelled_)
+			status << " [cancelled]";
+		status_ = status.str();
+	};
+
+	bool const read = manifest.Verify(path, [&] {
+		collect();
+		if (progress && !progress())
+			manifest.Cancel();
+	});
+
+	collect();
+	if (!read)
+		status_ = "Cannot read " + path;
+}
+
+// Each file listed is transferred once, even from a listing with several rows per file, such as the matches. The
+// status line reports how the files went, and the throughput.
+
+void FileModel::TransferFiles(std::string const& target, FileTransfer::Mode mode, std::function<bool()> const& progress) {
+	if (target.empty())
+	{
+		status_ = "Type the folder to copy or move to first.";
+		return;
+	}
+	if (store_ || index_ || segment_)
+	{
+		status_ = store_ ? SPILLED : SERVED;
+		return;
+	}
+
+	std::string const base = UnderFolder(folder_);
+	std::string const to = UnderFolder(target);
+	std::vector<FileTransfer::Item> items;
+	for (auto const& path : GetListedPaths())
+	{
+		FileTransfer::Item item;
+		item.from_ = path;
+		item.to_ = to + (path.compare(0, base.size(), base) == 0 ? path.substr(base.size()) : path.substr(path.find_last_of("\\/") + 1));
+		if (NormalFolder(item.to_) != NormalFolder(item.from_))
+			items.push_back(item);
+	}
+	if (items.empty())
+	{
+		status_ = "No files listed to copy or move.";
+		return;
+	}
+
+	char const* const verb = mode == FileTransfer::MOVE ? "Moved" : "Copied";
+	FileTransfer transfer(mode);
+	bool const clean = transfer.Run(items, [&] {
+		FileTransfer::Stats const stats = transfer.GetStats();
+		std::ostringstream status;
+		status << verb << " " << stats.files_ << " of " << items.size() << " files, " << ToMB(stats.bytes_);
+		if (stats.failed_)
+			status << "; " << stats.failed_ << " failed";
+		status_ = status.str();
+		if (progress && !progress())
+			transfer.Cancel();
+	});
+
+	std::vector<FileTransfer::Failure> const failures = transfer.TakeFailures();
+	if (!failures.empty())
+	{
+		rows_.clear();
+		rowPaths_.clear();
+		for (auto const& f : failures)
+		{
+			rows_.push_back(f.path_ + "  (" + std::system_category().message(f.error_) + ")");
+			rowPaths_.push_back(f.path_);
+		}
+		listing_ = Listing::FAILED;
+	}
+
+	FileTransfer::Stats const stats = transfer.GetStats();
+	std::ostringstream status;
+	status << verb << " " << stats.files_ << " of " << items.size() << " files (" << ToMB(stats.bytes_) << ") to " << target;
+	if (stats.seconds_ > 0)
+		status << " in " << std::fixed << std::setprecision(2) << stats.seconds_ << "s (" << stats.bytes_ / stats.seconds_ / BYTES_TO_MB << " MB/s)";
+	if (stats.renamed_)
+		status << "; " << stats.renamed_ << " renamed";
+	if (stats.cloned_)
+		status << "; " << stats.cloned_ << " cloned";
+	if (stats.sparse_)
+		status << "; " << stats.sparse_ << " sparse";
+	if (stats.failed_)
+		status << "; " << stats.failed_ << " failed";
+	if (stats.cancelled_)
+		status << " [cancelled]";
+	else if (clean && mode == FileTransfer::MOVE)
+		status << ". F8 brings the listing up to date.";
+	status_ = status.str();
+}
+
+// The folders scanned are kept, and so is the folder shown, so a delete never takes away the folder being looked at.
+
+void FileModel::PlanDelete(std::function<bool()> const& progress) {
+	deletion_.reset();
+	if (listing_ == Listing::DUPLICATES)
+	{
+		status_ = "Not deleted: the duplicates listing holds every copy of each file, the first one included.";
+		return;
+	}
+	if (listing_ != Listing::FILES && listing_ != Listing::MATCHES)
+	{
+		status_ = "Only the file listing and content matches can be deleted from.";
+		return;
+	}
+	if (store_ || index_ || segment_)
+	{
+		status_ = store_ ? SPILLED : SERVED;
+		return;
+	}
+
+	std::vector<std::string> keep(roots_);
+	if (folder_.find(';') == std::string::npos)
+		keep.push_back(folder_);
+
+	deletion_ = std::make_shared<BulkDelete>(GetListedPaths(), keep);
+	std::shared_ptr<BulkDelete> const deletion = deletion_;
+	deletion->Survey([&] {
+		if (progress && !progress())
+			deletion->Cancel();
+	});
 
-	controlID_ = c.controlID_;
-	content_ = c.content_;
+	BulkDelete::Stats const& plan = deletion->GetPlan();
+	std::ostringstream status;
+	if (plan.cancelled_ || !plan.files_)
+	{
+		deletion_.reset();
+		status << (plan.cancelled_ ? "Delete cancelled." : "No files listed to delete.");
+	}
+	else
+	{
+		status << "Delete " << plan.files_ << " files (" << ToMB(plan.bytes_) << ") and the folders they leave empty?";
+		if (plan.missing_)
+			status << " " << plan.missing_ << " listed are already gone.";
+		status << " Press Y to go ahead, any other key or a click to keep them.";
+	}
+	status_ = status.str();
 }
 
-//Sets the input textbox to the give parameter
-Framework::Control::InputTextBox::InputTextBox(std::string id, COORD origin, WORD const length, std::string content, ForegroundColour foreground, BackgroundColour background) {
-	// Set internal members.
-	xPos_ = origin.X;
-	yPos_ = origin.Y;
-	length_ = length;
-
-	foreground_ = foreground;
-	background_ = background;
+void FileModel::CancelDelete() {
+	if (!deletion_)
+		return;
 
-	controlID_ = id;
-	content_ = content;
+	deletion_.reset();
+	status_ = "Delete cancelled; nothing was deleted.";
+}
 
-	cursorPos_ = 0;
-	aperature_ = 0;
+void FileModel::DeletePlanned(std::function<bool()> const& progress) {
+	std::shared_ptr<BulkDelete> const deletion = deletion_;
+	deletion_.reset();
+	if (!deletion)
+		return;
+
+	unsigned long long const planned = deletion->GetPlan().files_;
+	bool const clean = deletion->Run([&] {
+		BulkDelete::Stats const stats = deletion->GetStats();
+		std::ostringstream status;
+		status << "Deleted " << stats.files_ << " of " << planned << " files, " << ToMB(stats.bytes_);
+		if (stats.failed_)
+			status << "; " << stats.failed_ << " failed";
+		status_ = status.str();
+		if (progress && !progress())
+			deletion->Cancel();
+	});
+
+	std::vector<BulkDelete::Failure> const failures = deletion->TakeFailures();
+	if (!failures.empty())
+	{
+		rows_.clear();
+		rowPaths_.clear();
+		for (auto const& f : failures)
+		{
+			rows_.push_back(f.path_ + "  (" + std::system_category().message(f.error_) + ")");
+			rowPaths_.push_back(f.path_);
+		}
+		listing_ = Listing::FAILED;
+	}
 
-	controlHit_ = false;
+	BulkDelete::Stats const stats = deletion->GetStats();
+	std::ostringstream status;
+	status << "Deleted " << stats.files_ << " of " << planned << " files (" << ToMB(stats.bytes_) << ") and " << stats.folders_ << " emptied folders";
+	if (stats.seconds_ > 0)
+		status << " in " << std::fixed << std::setprecision(2) << stats.seconds_ << "s (" << std::setprecision(0) << stats.files_ / stats.seconds_ << " files/s)";
+	if (stats.missing_)
+		status << "; " << stats.missing_ << " already gone";
+	if (stats.failed_)
+		status << "; " << stats.failed_ << " failed";
+	if (stats.cancelled_)
+		status << " [cancelled]";
+	else if (clean)
+		status << ". F8 brings the listing up to date.";
+	status_ = status.str();
 }
 
-Framework::Control::InputTextBox::InputTextBox(Control const& c) {
-	// Set internal members.
-	xPos_ = c.xPos_;
-	yPos_ = c.yPos_;
-	length_ = c.length_;
+// The finder is built on first use and kept, so later queries only pay for the ranking. The status line shows
+// how many paths had to be scored and how long that took, which is the cost of the key press.
 
-	foreground_ = c.foreground_;
-	background_ = c.background_;
+void FileModel::Narrow(std::string const& query) {
+	if (query.empty())
+	{
+		listing_ = Listing::FILES;
+		status_.clear();
+		return;
+	}
+	if (store_ || index_ || segment_)
+	{
+		status_ = store_ ? SPILLED : SERVED;
+		return;
+	}
 
-	controlID_ = c.controlID_;
-	content_ = c.content_;
+	// fzf's exact match prefix; what follows is a plain substring of the name.
+	if (query[0] == '\'')
+	{
+		if (query.size() == 1)
+		{
+			listing_ = Listing::FILES;
+			status_.clear();
+			return;
+		}
 
-	cursorPos_ = c.cursorPos_;
-	aperature_ = c.aperature_;
+		if (!nameIndex_)
+			nameIndex_ = std::make_shared<TrigramIndex>(files_);
 
-	controlHit_ = c.controlHit_;
-}
+		nameHits_ = nameIndex_->Find(query.substr(1));
+		listing_ = Listing::NAMES;
 
-Framework::Control::FileViewer::FileViewer(std::string id, WORD const x, WORD const height, ForegroundColour foreground, BackgroundColour background) {
-	// Set internal members.
-	xPos_ = x;
-	height_ = height;
+		std::ostringstream status;
+		status << nameHits_.size() << " names contain \"" << query.substr(1) << "\"; checked " << nameIndex_->GetCandidates()
+			<< " in " << std::fixed << std::setprecision(2) << nameIndex_->GetSeconds() * 1000 << "ms";
+		status_ = status.str();
+		return;
+	}
 
-	foreground_ = foreground;
-	background_ = background;
+	if (!fuzzy_)
+		fuzzy_ = std::make_shared<FuzzyFinder>(files_);
 
-	controlID_ = id;
+	fuzzy_->Search(query);
+	listing_ = Listing::FUZZY;
+
+	std::ostringstream status;
+	status << fuzzy_->GetMatchCount() << " of " << fuzzy_->GetPathCount() << " files match; scored " << fuzzy_->GetScored()
+		<< " in " << std::fixed << std::setprecision(1) << fuzzy_->GetSeconds() * 1000 << "ms";
+	status_ = status.str();
 }
-Framework::Control::FileViewer::FileViewer(Control const& c) {
-	// Set internal members.
-	xPos_ = c.xPos_;
-	height_ = c.height_;
 
-	foreground_ = c.foreground_;
-	background_ = c.background_;
+// The folder is looked up one name at a time in the tree, so moving to it costs its depth rather than a pass
+// over the files, and its count and size come from its node.
+
+bool FileModel::Navigate(std::string const& folder, std::string const& filter, bool recurse, Listing listing) {
+	if (!recurse || !recursion_ || filter != regex_ || listing != Listing::FILES || !IsScanned(folder))
+		return false;
+
+	std::string rest;
+	std::uint32_t node = FindFolder(folder, &rest);
+	if (node == PathTree::NONE)
+		return false;
+
+	// Keep the status of whatever was run last, such as a refresh, unless the folder changes.
+	bool const moved = NormalFolder(folder) != NormalFolder(folder_);
+	folder_ = folder;
+	node_ = node;
+	nodeRest_ = rest;
+	first_ = tree_->GetFirst(node);
+	end_ = tree_->GetEnd(node);
+	mFiles_ = end_ - first_;
+	fSize_ = tree_->GetBytes(node) / BYTES_TO_MB;
+	fPos_ = 0;
+	selected_ = 0;
 
-	controlID_ = c.controlID_;
+	if (listing_ == Listing::FOLDERS)
+		ListFolders();
+	else
+	{
+		listing_ = Listing::FILES;
+		if (moved)
+			status_ = "Folder shown from the last scan of " + root_;
+	}
+	return true;
 }
 
-//Methods
-// Adds a layout section to the console to indicate areas of the console that will have
-// certain controls grouped together using the Console thick wrapper function to fill.
+// A chain of folders holding nothing but the next one is one node, so it shows as a single row.
 
-void Framework::AddLayoutToConsole(Framework::Layout const& l) {
-	// Make call to the console to fill out the layout section on the screen.
-	console_.Fill(l.startLoc_, l.size_, l.foreground_, l.background_);
-}
+void FileModel::ListFolders() {
+	rows_.clear();
+	rowPaths_.clear();
+	rowFolders_.clear();
+	listing_ = Listing::FOLDERS;
 
-// Adds a control to the console to allow for display or interaction with the user, for
-// the program to update the model/view on different inputs using the Console thick wrapper function.
+	if (!tree_ || node_ == PathTree::NONE)
+	{
+		status_ = "Folders are listed after a scan of the file listing.";
+		return;
+	}
 
-void Framework::AddControlToConsole(Framework::Control const& control) {
-	// Check to see what control we are adding.
-	if (dynamic_cast<Framework::Control::FileViewer const*>(&control))
+	std::string const base = UnderFolder(folder_);
+	auto addRow = [&](std::uint32_t node, std::string const& label, std::string const& folder) {
+		std::ostringstream row;
+		row << std::setw(10) << tree_->GetCount(node) << " files " << std::setw(12) << ToMB(tree_->GetBytes(node)) << "  " << label << "\\";
+		rows_.push_back(row.str());
+		rowPaths_.push_back(std::string());
+		rowFolders_.push_back(folder);
+	};
+
+	std::size_t inFolders = 0;
+	if (roots_.size() > 1 && node_ == tree_->GetRoot())
 	{
-		// Create a FileViewer control and paint to screen.
-		Framework::Control::FileViewer fv = control;
-		console_.Fill(fv.xPos_, fv.height_, fv.foreground_, fv.background_);
-		controls_.insert(std::make_pair(fv.controlID_, control));
+		// All of a scan of several roots: one row per root.
+		for (auto const& root : roots_)
+		{
+			std::uint32_t const node = tree_->Find(root);
+			if (node == PathTree::NONE)
+				continue;
+			addRow(node, root, root);
+			inFolders += tree_->GetCount(node);
+		}
+	}
+	else if (!nodeRest_.empty())
+	{
+		addRow(node_, nodeRest_, base + nodeRest_);
+		inFolders = tree_->GetCount(node_);
 	}
 	else
 	{
-		console_.Draw(control.xPos_, control.yPos_, control.length_, control.foreground_, control.background_);
-		controls_.insert(std::make_pair(control.controlID_, control));
+		for (auto child : tree_->GetChildren(node_))
+		{
+			addRow(child, tree_->GetLabel(child), base + tree_->GetLabel(child));
+			inFolders += tree_->GetCount(child);
+		}
 	}
+
+	std::ostringstream status;
+	status << rows_.size() << " folders; " << tree_->GetCount(node_) - inFolders << " files directly in this one. Enter opens, Backspace goes up";
+	status_ = status.str();
 }
 
-// Adds a control to the console to allow for text display only using the Console thick wrapper function.
+bool FileModel::IsScanned(std::string const& folder) const {
+	if (!tree_)
+		return false;
 
-void Framework::AddTextToConsole(Framework::Control const& control) {
-	// Write text at console using control location and console call.
-	console_.Write(control.xPos_, control.yPos_, control.content_, control.foreground_, control.background_);
+	std::string const f = NormalFolder(folder);
+	if (f == NormalFolder(root_))
+		return true;
+
+	for (auto const& r : roots_)
+	{
+		std::string const root = NormalFolder(r);
+		if (f == root || (f.size() > root.size() && f.compare(0, root.size(), root) == 0 && (f[root.size()] == '\\' || root.back() == '\\')))
+			return true;
+	}
+	return false;
 }
 
-// Enables a handler to look for Ctrl key events using the Console thick wrapper function.
+bool FileModel::FindRange(std::string const& folder, std::size_t& first, std::size_t& end, unsigned long long& bytes) const {
+	if (!IsScanned(folder))
+		return false;
 
-void Framework::EnableCtrlHandler(PHANDLER_ROUTINE routine) {
-	console_.EnableCtrlHandler(routine);
+	first = end = 0;
+	bytes = 0;
+	std::uint32_t const node = FindFolder(folder, nullptr);
+	if (node != PathTree::NONE)
+	{
+		first = tree_->GetFirst(node);
+		end = tree_->GetEnd(node);
+		bytes = tree_->GetBytes(node);
+	}
+	return true;
 }
 
-// Sets the cursor position within the console window and its visibility using the Console thick wrapper function.
+std::string FileModel::GetParentFolder() const {
+	std::string folder = folder_;
+	while (!folder.empty() && (folder.back() == '\\' || folder.back() == '/'))
+		folder.pop_back();
 
-void Framework::ResetCursorPosition(SHORT const x, SHORT const y, bool visible) {
-	console_.SetCursor(x, y, visible);
-}
+	if (roots_.size() > 1)
+		for (auto const& r : roots_)
+			if (NormalFolder(r) == NormalFolder(folder))
+				return root_;
 
-// Used to write text or content to the console at a specific coordinate using the Console thick wrapper function.
+	std::string::size_type slash = folder.find_last_of("\\/");
+	if (slash == std::string::npos || !IsScanned(folder.substr(0, slash)))
+		return std::string();
+	return folder.substr(0, slash + (folder.find_first_of("\\/") == slash ? 1 : 0));
+}
 
-void Framework::Write(WORD const x, WORD const y, std::string content, ForegroundColour foreground, BackgroundColour background) {
-	console_.Write(x, y, content, foreground, background);
+std::uint32_t FileModel::FindFolder(std::string const& folder, std::string* rest) const {
+	if (roots_.size() > 1 && NormalFolder(folder) == NormalFolder(root_))
+	{
+		if (rest)
+			rest->clear();
+		return tree_->GetRoot();
+	}
+	return tree_->Find(folder, rest);
 }
 
-// Used to call specific console functions to set size, title and other functions to create the eventual look
-// and feel of the file browser using the Console thick wrapper functions.
+// The leaderboards are the daemon's first rows by size or time, which it ranks as RankFiles does, and are kept
+// like a scan's; the file listing keeps the connection and reads its rows a page at a time. The footer's totals
+// are the daemon's for the folder.
 
-void Framework::SetupConsole() {
-	console_.SetTitle("TUI File Browser").SetSize(130, 50).SetCursor(0, 0, false).SetBackgroundColour(BackgroundColour::WHITE).EnableKeyboardAndMouse();
-}
+bool FileModel::OpenIndex(std::string const& folder) {
+	if (!useIndex_ || (listing_ != Listing::FILES && listing_ != Listing::LARGEST && listing_ != Listing::NEWEST))
+		return false;
 
+	auto const start = std::chrono::steady_clock::now();
+	auto client = std::make_shared<IndexClient>();
+	if (!client->Connect())
+		return false;
 
-// Updates the recursive toggle on the view to indicate whether or not
-// the search is a recursive or non-recursive by writing to the control's content
-// using the Write function.
+	bool const ranked = listing_ != Listing::FILES;
+	IndexClient::Query query;
+	query.folder_ = folder;
+	query.filter_ = regex_;
+	if (ranked)
+	{
+		query.sort_ = listing_ == Listing::LARGEST ? IndexProtocol::BY_SIZE : IndexProtocol::BY_TIME;
+		query.descending_ = true;
+		query.count_ = LEADERBOARD_SIZE;
+	}
 
-void Framework::Control::Checkbox::UpdateCheckState(Framework::Control::Checkbox const& c) {
-	frame.Write(c.xPos_, c.yPos_, c.content_, c.foreground_, c.background_);
+	IndexClient::Result result;
+	if (!client->Run(query, result))
+		return false;
+	double const ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	roots_ = MultiScan::SplitRoots(folder);
+	progress_.reset();
+	sFiles_ = result.searched_;
+	mFiles_ = result.total_;
+	fSize_ = result.bytes_ / BYTES_TO_MB;
+	first_ = 0;
+	end_ = 0;
+	if (ranked)
+		leaders_ = result.rows_;
+	else
+	{
+		end_ = static_cast<std::size_t>(result.total_);
+		client->Browse(query, result);
+		index_ = client;
+	}
+
+	std::ostringstream status;
+	status << "From the index daemon";
+	IndexClient::Stats stats;
+	if (client->GetStats(folder, regex_, stats))
+		status << " of " << stats.roots_ << " (" << stats.files_ << " files, refreshed " << ToLocalTime(stats.builtAt_) << ")";
+	status << "; first screen in " << std::fixed << std::setprecision(1) << ms << "ms";
+	status_ = status.str();
+	return true;
 }
 
-// Updates the folder or filter input with the content from the console arguments passed in at program
-// start, or with the new user's input by writing to the control's content
-// using the Write function.
+// The segment stays mapped for as long as the model, or a copy of it, uses it, so a newer one published meanwhile
+// does not move the listing under the viewer. A folder is found in it by its path, as typed; one that finds no
+// files there is left to the daemon, which looks folders up in its tree.
 
-void Framework::Control::InputTextBox::UpdateInputContent(Framework::Control::InputTextBox const& itb) {
-	frame.Write(itb.xPos_, itb.yPos_, itb.content_, itb.foreground_, itb.background_);
-}
+bool FileModel::OpenSegment(std::string const& folder) {
+	if (!useIndex_ || listing_ != Listing::FILES)
+		return false;
 
-// Updates the file search stats on the bottom of the console with the content after
-// each new model scan by writing to the control's content, once to clear and once with the actual content,
-// using the Write function.
+	auto segment = std::make_shared<SegmentReader>();
+	if (!segment->Attach() || segment->GetFilter() != regex_)
+		return false;
 
-void Framework::Control::TextBox::UpdateContent(Framework::Control::TextBox const& tbx) {
-	frame.Write(tbx.xPos_, tbx.yPos_, std::string(tbx.length_, ' '), tbx.foreground_, tbx.background_);
-	frame.Write(tbx.xPos_, tbx.yPos_, tbx.content_, tbx.foreground_, tbx.background_);
+	unsigned long long first = 0, end = segment->GetCount();
+	if (NormalFolder(folder) != NormalFolder(segment->GetRoots()))
+	{
+		auto const run = segment->Find(UnderFolder(folder));
+		if (run.first == run.second)
+			return false;
+		first = run.first;
+		end = run.second;
+	}
+
+	roots_ = MultiScan::SplitRoots(folder);
+	progress_.reset();
+	sFiles_ = segment->GetSearched();
+	mFiles_ = end - first;
+	fSize_ = segment->GetBytes(first, end) / BYTES_TO_MB;
+	first_ = static_cast<std::size_t>(first);
+	end_ = static_cast<std::size_t>(end);
+	fPos_ = 0;
+	selected_ = 0;
+	segment_ = segment;
+
+	std::ostringstream status;
+	status << "Mapped the index daemon's shared segment " << segment->GetNumber() << " of " << segment->GetRoots() << " (" << segment->GetCount()
+		<< " files, published " << ToLocalTime(segment->GetPublishedAt()) << ")";
+	status_ = status.str();
+	return true;
 }
-/**
-* Writes new files/content to the view when a model completes a new scan using the Write function.
-*/
-void Framework::Control::FileViewer::UpdateFileView(Framework::Control::FileViewer const& fv) {
-	frame.Write(fv.xPos_, fv.yPos_, fv.content_, fv.foreground_, fv.background_);
+
+std::string FileModel::GetFilePath(std::size_t i) const {
+	if (store_)
+		return store_->Get(i).path_;
+	if (segment_)
+		return segment_->Get(i).path_;
+	if (index_)
+		return index_->Get(i).path_;
+	return files_[i].path_;
 }
 
-// Clears the contents of the fileview area by looping through the immediately viewable area,
-// and using the Write function to write a blank string across the whole length of the control.
+std::vector<FileEntry> const& FileModel::GetShownFiles(std::vector<FileEntry>& subset) const {
+	if (first_ == 0 && end_ == files_.size())
+		return files_;
 
-void Framework::Control::FileViewer::ClearFileView() {
-	WORD row = 13;
-	for (auto i = 0; i <= 28; i++) {
-		frame.Write(1, row++, std::string(200, ' '), ForegroundColour::WHITE, BackgroundColour::BLACK);
+	subset.assign(files_.begin() + first_, files_.begin() + end_);
+	return subset;
+}
+
+std::vector<std::string> FileModel::GetListedPaths() const {
+	std::set<std::string> seen;
+	std::vector<std::string> paths;
+	for (std::size_t i = 0; i < GetRowCount(); ++i)
+	{
+		std::string path = GetRowPath(i);
+		if (!path.empty() && seen.insert(path).second)
+			paths.push_back(std::move(path));
 	}
+	return paths;
 }
 
-// Updates the variables within the particular control, saving its state by looping through the map,
-// finding the matching key value, and setting the Control associated with the key to the control reference.
+// Snapshots are kept in the cache folder, named after a hash of the scanned folder and the time taken, so the
+// snapshots of one folder sort oldest first by name.
 
-void Framework::Control::Update(Framework::Control& control) {
-	for (std::map<std::string, Control>::iterator it = frame.controls_.begin(); it != frame.controls_.end(); ++it) {
-		if (it->first == control.controlID_) {
-			it->second = control;
-			break;
-		}
+void FileModel::TakeSnapshot() {
+	std::string const cache = GetCacheFolder();
+	if (folders_.empty() || (files_.empty() && !store_) || cache.empty())
+	{
+		status_ = "Snapshots are taken of a recursive scan of the file listing.";
+		return;
 	}
-}
 
-// Returns an event from the console's read in input by using the Console thick wrapper function.
+	std::string const root = NormalFolder(root_);
+	Hash128 hash;
+	hash.Update(root.data(), root.size());
+	Hash128::Digest d = hash.Final();
 
-Event Framework::GetEvent() {
-	std::vector<INPUT_RECORD> inBuffer;
-	DWORD numEvent;
+	std::ostringstream os;
+	os << std::hex << std::setfill('0') << std::setw(16) << static_cast<unsigned long long>(d.hi_ ^ d.lo_) << '-';
+	std::string const prefix = os.str();
 
-	console_.GetEvent(inBuffer, numEvent);
-	auto e  = Event::Event(inBuffer[0]);
-	return e;
-}
+	long long const taken = static_cast<long long>(std::time(nullptr));
+	std::string name = prefix + ToLocalTime(taken) + ".snap";
+	std::replace(name.begin(), name.end(), ' ', '-');
+	std::replace(name.begin(), name.end(), ':', '.');
 
-// Gets the current working directory that the executable of this program is located in,
-// by using the Console thick wrapper function.
+	// The newest snapshot of this folder taken before this one.
+	std::string previous;
+	std::tr2::sys::directory_iterator it(cache), e;
+	for (; it != e; ++it)
+	{
+		std::string other = it->path().filename();
+		if (other.compare(0, prefix.size(), prefix) == 0 && other.size() > 5 && other.compare(other.size() - 5, 5, ".snap") == 0 && other < name && other > previous)
+			previous = other;
+	}
 
-std::string Framework::GetCurrentDir() {
-	std::string dir = console_.GetCurrentDir();
-	return dir;
-}
+	SnapshotWriter writer(cache + name, root_, taken);
+	if (store_)
+	{
+		for (unsigned long long i = 0; i < store_->GetCount(); ++i)
+			writer.Add(store_->Get(i));
+	}
+	else
+	{
+		for (auto const& f : files_)
+			writer.Add(f);
+	}
+	if (!writer.Close())
+	{
+		status_ = "The snapshot could not be saved to " + cache;
+		return;
+	}
 
+	if (previous.empty())
+	{
+		std::ostringstream status;
+		status << "Snapshot of " << writer.GetCount() << " files saved; the next one of this folder will be compared with it";
+		status_ = status.str();
+		return;
+	}
 
+	CompareSnapshots(cache + previous, cache + name);
+}
 
-//Method
-// A method that will scan a folder for files by first setting the state of the model's variables to zero
-// and then depending on the state of the recurse flag, it will loop through the directories using the appropriate
-// iterator starting at the passed in path "f". It will return all file names that match the regex and place them into
-// the model's file vector.
+// The folder rows sum each folder's changes with its sub-folders', so the folders at the top are where the
+// space went. Only the first MAX_CHANGE_ROWS changes are listed; the status line counts them all.
 
-void FileModel::Scan(std::tr2::sys::path const& f, std::regex r, bool recurse) {
-	// Zero out counters/file list before each scan.
-	sFiles_ = 0;
-	mFiles_ = 0;
-	startRow_ = 0;
-	fPos_ = 0;
-	fSize_ = 0;
-	files_.clear();
+void FileModel::CompareSnapshots(std::string const& before, std::string const& after) {
+	rows_.clear();
+	rowPaths_.clear();
+	listing_ = Listing::CHANGES;
 
-	// Used for reducing file size to MB.
-	double const BYTES_TO_MB = 1048576;
+	SnapshotDiff diff;
+	std::vector<std::string> changes;
+	std::vector<std::string> paths;
+	bool const ok = diff.Run(before, after, [&](SnapshotDiff::Change change, FileEntry const& b, FileEntry const& a) {
+		if (changes.size() >= MAX_CHANGE_ROWS)
+			return;
+
+		std::ostringstream row;
+		switch (change)
+		{
+			case SnapshotDiff::ADDED: row << "+ " << a.path_ << "  " << ToMB(a.size_); break;
+			case SnapshotDiff::REMOVED: row << "- " << b.path_ << "  " << ToMB(b.size_); break;
+			case SnapshotDiff::RESIZED: row << "~ " << a.path_ << "  " << ToMB(b.size_) << " -> " << ToMB(a.size_); break;
+			case SnapshotDiff::MODIFIED: row << "* " << a.path_ << "  " << ToLocalTime(a.mtime_); break;
+		}
+		changes.push_back(row.str());
+		paths.push_back(change == SnapshotDiff::REMOVED ? std::string() : a.path_);
+	});
 
-	// Scan appropriately.
-	if (recurse)
+	if (!ok)
 	{
-		std::tr2::sys::recursive_directory_iterator d(f);
-		std::tr2::sys::recursive_directory_iterator e;
+		status_ = "The snapshots could not be read.";
+		return;
+	}
 
-		for (; d != e; d++)
-		{
-			if (!is_directory(d->status()))
-			{
-				// Increment search counter again as we have hit a file.
-				sFiles_++;
+	std::vector<SnapshotDiff::FolderDelta> folders = diff.GetFolders();
+	for (std::size_t i = 0; i < folders.size() && i < MAX_FOLDER_ROWS; ++i)
+	{
+		std::ostringstream row;
+		row << std::setw(14) << ToSignedMB(folders[i].bytes_) << "  " << folders[i].path_ << "  (+" << folders[i].added_ << " -" << folders[i].removed_ << " ~" << folders[i].changed_ << ")";
+		rows_.push_back(row.str());
+		rowPaths_.push_back(std::string());
+	}
+	rows_.push_back(std::string());
+	rowPaths_.push_back(std::string());
+
+	rows_.insert(rows_.end(), changes.begin(), changes.end());
+	rowPaths_.insert(rowPaths_.end(), paths.begin(), paths.end());
+
+	SnapshotReader older(before);
+	SnapshotDiff::Stats const& stats = diff.GetStats();
+	std::ostringstream status;
+	status << "Since " << ToLocalTime(older.GetTaken()) << ": +" << stats.counts_[SnapshotDiff::ADDED] << " (" << ToMB(stats.addedBytes_) << ") -"
+		<< stats.counts_[SnapshotDiff::REMOVED] << " (" << ToMB(stats.removedBytes_) << ") ~" << stats.counts_[SnapshotDiff::RESIZED] << " ("
+		<< ToSignedMB(stats.resizedBytes_) << ") *" << stats.counts_[SnapshotDiff::MODIFIED] << " in " << std::fixed << std::setprecision(2) << stats.seconds_ << "s";
+	status_ = status.str();
+}
 
-				// Check to see if extension of file matches files we are looking for.
-				if (std::regex_match(d->path().extension(), r))
-				{
-					// Increment counters.
-					mFiles_++;
-					fSize_ += file_size(d->path()) / BYTES_TO_MB;
+// Returns the number of rows in the listing the file viewer is showing.
 
-					// Add to the file list.
-					files_.push_back(d->path());
-				}
-			}
-			else
-				sFiles_++; // Increment counter here as this will be the level at which folders will be searched.
-		}
+std::size_t FileModel::GetRowCount() const {
+	switch (listing_)
+	{
+		case Listing::FILES: return end_ - first_;
+		case Listing::LARGEST:
+		case Listing::NEWEST: return leaders_.size();
+		case Listing::FUZZY: return fuzzy_->GetResults().size();
+		case Listing::NAMES: return nameHits_.size();
+		default: return rows_.size();
 	}
+}
+
+// Returns the path for the file listing. For the leaderboards the row is prefixed with its rank
+// and either the size in MB or the last write time.
+
+std::string FileModel::GetRow(std::size_t i) const {
+	if (listing_ == Listing::FILES)
+		return GetFilePath(first_ + i);
+	if (listing_ == Listing::FUZZY)
+		return fuzzy_->GetPath(fuzzy_->GetResults()[i].item_);
+	if (listing_ == Listing::NAMES)
+		return files_[nameHits_[i]].path_;
+	if (listing_ != Listing::LARGEST && listing_ != Listing::NEWEST)
+		return rows_[i];
+
+	FileEntry const& e = leaders_[i];
+	std::ostringstream row;
+	row << std::setw(4) << i + 1 << ". ";
+
+	if (listing_ == Listing::LARGEST)
+		row << std::setw(14) << ToMB(e.size_) << "  ";
 	else
-	{
-		std::tr2::sys::directory_iterator d(f);
-		std::tr2::sys::directory_iterator e;
+		row << ToLocalTime(e.mtime_) << "  ";
 
-		for (; d != e; d++)
-		{
-			if (!is_directory(d->status()))
-			{
-				// Increment search counter again as we have hit a file.
-				sFiles_++;
+	row << e.path_;
+	return row.str();
+}
 
-				// Check to see if extension of file matches files we are looking for.
-				if (std::regex_match(d->path().extension(), r))
-				{
-					// Increment counters.
-					mFiles_++;
-					fSize_ += file_size(d->path()) / BYTES_TO_MB;
+// The file and leaderboard listings are all files; the other listings keep the path of each row alongside it.
 
-					// Add to the file list.
-					files_.push_back(d->path());
-				}
-			}
-			else
-				sFiles_++; // Increment counter here as this will be the level at which folders will be searched.
-		}
+std::string FileModel::GetRowPath(std::size_t i) const {
+	switch (listing_)
+	{
+		case Listing::FILES: return GetFilePath(first_ + i);
+		case Listing::LARGEST:
+		case Listing::NEWEST: return leaders_[i].path_;
+		case Listing::FUZZY: return fuzzy_->GetPath(fuzzy_->GetResults()[i].item_);
+		case Listing::NAMES: return files_[nameHits_[i]].path_;
+		default: return rowPaths_[i];
 	}
 }
 
+std::string FileModel::GetRowFolder(std::size_t i) const {
+	return listing_ == Listing::FOLDERS ? rowFolders_[i] : std::string();
+}
+
 
 
 // Methods
@@ -811,6 +3138,7 @@ void FileController::UpdateView() {
 	Framework::Control::TextBox tbxSearched = frame.GetControls().find("tbxSearched")->second;
 	Framework::Control::TextBox tbxMatched = frame.GetControls().find("tbxMatched")->second;
 	Framework::Control::TextBox tbxFileSize = frame.GetControls().find("tbxFileSize")->second;
+	Framework::Control::TextBox tbxListing = frame.GetControls().find("tbxListing")->second;
 	Framework::Control::FileViewer fv = frame.GetControls().find("fv")->second;
 
 	// Initial update pre-scanning.
@@ -818,6 +3146,7 @@ void FileController::UpdateView() {
 	cb.content_ = cb.state_ ? "X" : " ";
 	itbFolder.content_ = model_.GetSearchFolder();
 	itbFilter.content_ = model_.GetSearchFilter();
+	tbxListing.content_ = model_.GetListing() == FileModel::Listing::LARGEST ? "LARGEST" : model_.GetListing() == FileModel::Listing::NEWEST ? "NEWEST" : "FILES";
 	fv.yPos_ = 13;
 	fv.xPos_ = 1;
 
@@ -831,25 +3160,17 @@ void FileController::UpdateView() {
 	itbFilter.Update(itbFilter);
 	itbFilter.UpdateInputContent(itbFilter);
 
+	tbxListing.Update(tbxListing);
+	tbxListing.UpdateContent(tbxListing);
+
 	fv.Update(fv);
 	fv.ClearFileView();
 	fv.UpdateFileView(fv);
 
 	// Output contents of files.
-	int viewBound = 0;
-	model_.startRow_ = fv.yPos_;
 	model_.fPos_ = 0;
-
-	for (auto i = model_.fPos_; i < model_.GetFiles().size(); ++i) {
-		if (viewBound <= 28) {
-			frame.Write(1, model_.startRow_++, model_.GetFiles()[static_cast<unsigned int>(i)], fv.foreground_, fv.background_);
-		}
-		else
-			break;
-
-		viewBound++;
-	}
-
+	model_.selected_ = 0;
+	FileView::DrawRows(model_);
 	model_.startRow_ = 0;
 
 	// Output file stats.
@@ -883,6 +3204,10 @@ void FileController::UpdateView() {
 
 	tbxFileSize.Update(tbxFileSize);
 	tbxFileSize.UpdateContent(tbxFileSize);
+
+	FileView::DrawStatus(model_);
+	FileView::DrawImpact(model_);
+	FileView::ShowCell("tbxScanning", model_.GetErrors());
 }
 
 // Updates the model with the data from the view's user input by retrieving the recursive toggle,
@@ -895,10 +3220,24 @@ void FileController::UpdateModel() {
 	Framework::Control::Checkbox cb = frame.GetControls().find("recursiveCheck")->second;
 	Framework::Control::InputTextBox itbFolder = frame.GetControls().find("folderInput")->second;
 	Framework::Control::InputTextBox itbFilter = frame.GetControls().find("filterInput")->second;
+	Framework::Control::TextBox tbxListing = frame.GetControls().find("tbxListing")->second;
 	Framework::Control::FileViewer fv = frame.GetControls().find("fv")->second;
 
 	// Update the model.
-	model_ = FileModel(itbFolder.content_, itbFilter.content_, cb.state_);
+	FileModel::Listing listing = FileModel::Listing::FILES;
+	if (tbxListing.content_ == "LARGEST")
+		listing = FileModel::Listing::LARGEST;
+	else if (tbxListing.content_ == "NEWEST")
+		listing = FileModel::Listing::NEWEST;
+
+	// A folder inside the last recursive scan is shown from that scan's folder tree.
+	if (model_.Navigate(itbFolder.content_, itbFilter.content_, cb.state_, listing))
+		return;
+
+	model_ = FileModel(itbFolder.content_, itbFilter.content_, cb.state_, listing);
+	model_.SetThrottle(FileView::GetThrottle());
+	model_.SetMemoryBudget(FileView::GetMemoryBudget());
+	model_.SetProcesses(FileView::GetProcesses());
 
 	// Indicate to user that a scan is in progress for recursive scans, in the case that the scan is a large drive.
 	if (model_.IsRecursive()) {
@@ -923,5 +3262,15 @@ void FileController::UpdateModel() {
 		throw ConsoleAPI::XError("Invalid regex.", 833);
 	}
 	
-	model_.Scan(std::tr2::sys::path(model_.GetSearchFolder()), r, model_.IsRecursive());
+	// The footer follows the scan's progress and the leaderboards are redrawn as it runs; the file listing is
+	// only shown once it is complete. The background mode keys are taken while it runs, so the scan can be eased
+	// off or sped up part way through.
+	model_.Scan(std::tr2::sys::path(model_.GetSearchFolder()), r, model_.IsRecursive(), [this] {
+		for (WORD key : frame.PressedKeys())
+			FileView::AdjustThrottle(key);
+		FileView::DrawProgress(model_);
+		FileView::DrawImpact(model_);
+		if (model_.GetListing() != FileModel::Listing::FILES)
+			FileView::DrawRows(model_);
+	});
 }
\ No newline at end of file
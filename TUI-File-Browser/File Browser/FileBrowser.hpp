@@ -16,9 +16,26 @@ version: 1.0
 #include <map>
 #include <regex>
 #include <filesystem>
+#include <memory>
+#include <cstdint>
+#include <functional>
 #include "Event.h"
 #include "Color.h"
-
+#include "ScanEngine.hpp"
+#include "Manifest.hpp"
+#include "Transfer.hpp"
+
+
+class TextPager;
+class LogFollower;
+class FuzzyFinder;
+class TrigramIndex;
+class PathTree;
+class ScanProgress;
+class ResultStore;
+class IndexClient;
+class SegmentReader;
+class BulkDelete;
 
 //  Observer Pattern
 
@@ -219,6 +236,10 @@ class Framework
 		// Used to write text or content to the console at a specific coordinate.
 		
 		void Write(WORD const x, WORD const y, std::string content, ForegroundColour foreground, BackgroundColour background);
+
+		// Moves a rectangle of the console up by lines rows, blanking the rows it leaves behind.
+
+		void ScrollUp(WORD const x, WORD const y, WORD const width, WORD const height, WORD const lines, ForegroundColour foreground, BackgroundColour background);
 		
 		// Sets the cursor position within the console window and its visibility.
 		
@@ -236,6 +257,20 @@ class Framework
 		// Returns an event from the console's read in input.
 		
 		Event GetEvent();
+
+		// Drains the console's pending input without blocking and returns true if Esc was pressed.
+		// Used by long running passes to let the user cancel them.
+
+		bool EscapePressed();
+
+		// Drains the console's pending input without blocking and returns the keys pressed in it.
+		// Used by long running passes that take a few keys while they run.
+
+		std::vector<WORD> PressedKeys();
+
+		// Waits up to ms milliseconds for console input. Returns true when there is an event for GetEvent.
+
+		bool WaitForEvent(unsigned ms);
 		
 		// Gets the current working directory that the executable of this program is located in.
 		
@@ -246,37 +281,277 @@ class Framework
 
 class FileModel : public AbstractSubject
 {
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// What the file viewer lists for this model.
+		enum class Listing
+		{
+			FILES,
+			LARGEST,
+			NEWEST,
+			DUPLICATES,
+			MATCHES,
+			FUZZY,
+			NAMES,
+			FOLDERS,
+			CHANGES,
+			MANIFEST,
+			FAILED
+		};
+
+		// Number of entries kept by the largest/newest leaderboards.
+		static unsigned const LEADERBOARD_SIZE = 100;
+
+		// Changed files and folders listed when two snapshots are compared; the totals count them all.
+		static unsigned const MAX_CHANGE_ROWS = 100000;
+		static unsigned const MAX_FOLDER_ROWS = 20;
+
 	// -------- CONSTRUCTORS --------
 	public:
-		FileModel() { };
-		FileModel(std::string f, std::string r, bool recurse) : folder_(f), regex_(r), recursion_(recurse) { };
+		FileModel() : node_(0), first_(0), end_(0), skipped_(0), budget_(0), processes_(0), useIndex_(true), listing_(Listing::FILES), fPos_(0), selected_(0) { };
+		FileModel(std::string f, std::string r, bool recurse, Listing listing = Listing::FILES) : node_(0), first_(0), end_(0), folder_(f), root_(f), skipped_(0), budget_(0), processes_(0), useIndex_(true), regex_(r), recursion_(recurse), listing_(listing), fPos_(0), selected_(0) { };
 
 	// -------- CLASS MEMBERS --------
 	private:
-		std::vector<std::string> files_;
+		std::vector<FileEntry> files_;
+		std::vector<FileEntry> leaders_;
+		std::vector<std::string> rows_;
+		std::vector<std::string> rowPaths_;
+		std::string status_;
+
+		// Built from files_ the first time the fuzzy finder is used, and shared by copies of the model.
+		std::shared_ptr<FuzzyFinder> fuzzy_;
+
+		// Built from files_ after a scan of the file listing; nameHits_ are the files whose names held the last substring.
+		std::shared_ptr<TrigramIndex> nameIndex_;
+		std::vector<std::uint32_t> nameHits_;
+
+		// Built from files_ after a scan of the file listing. node_ is the folder shown, nodeRest_ the part of its
+		// label below that folder, and [first_, end_) its files in files_; rowFolders_ are the folder listing's folders.
+		std::shared_ptr<PathTree> tree_;
+		std::uint32_t	node_;
+		std::string		nodeRest_;
+		std::size_t		first_;
+		std::size_t		end_;
+		std::vector<std::string> rowFolders_;
+
+		// Every folder the last scan of the file listing listed, sorted by path, with its stamp when it was listed.
+		std::vector<FolderEntry> folders_;
 
 		unsigned long long	sFiles_;
 		unsigned long long	mFiles_;
 		double long		fSize_;
 		
 		std::string folder_;
+		std::string root_;
+
+		// The folders the last scan walked: root_ split on ';', less any inside another.
+		std::vector<std::string> roots_;
+
+		// Background mode settings the scan follows, and what the last scan cost the disks.
+		std::shared_ptr<ScanThrottle> throttle_;
+		std::string impact_;
+
+		// What the last scan published as it ran; a new one for each scan, so copies keep their own.
+		std::shared_ptr<ScanProgress> progress_;
+
+		// What the last scan could not read and skipped; updated while it runs. The counts behind them are kept
+		// once it is done, so a refresh adds to them; a new set for each scan and refresh, so copies keep their own.
+		unsigned long long				skipped_;
+		std::string						errors_;
+		std::shared_ptr<ScanErrors>		scanErrors_;
+
+		// Bytes of files a scan may hold in files_ before they go to store_; zero for no limit. Once the files are
+		// in store_, files_ is empty and the file listing is read from it.
+		unsigned long long				budget_;
+		std::shared_ptr<ResultStore>	store_;
+
+		// Worker processes a scan is spread over; zero to walk with this process's threads.
+		unsigned	processes_;
+
+		// Whether a recursive scan asks the index daemon first, and the connection to it while the file listing is
+		// read from it, or the daemon's shared segment it is read from instead; files_ is then empty.
+		bool							useIndex_;
+		std::shared_ptr<IndexClient>	index_;
+		std::shared_ptr<SegmentReader>	segment_;
+
+		// The files a dry run of a delete found, waiting for the delete to be confirmed.
+		std::shared_ptr<BulkDelete>		deletion_;
 		std::string regex_;
 		bool		recursion_;
+		Listing		listing_;
 
 	public:
 		unsigned long long	fPos_;
+		unsigned long long	selected_;
 		unsigned int startRow_;
 
 	// -------- OPERATIONS --------
 	public:
 		
-		 // A method that will scan a folder for files.
+		 // A method that will scan a folder for files. In the largest/newest listings only the leaderboard is kept,
+		 // and progress is called periodically on this thread so the caller can show it while the scan runs.
+		 // Several folders separated by ';' are scanned at once, each volume with its own workers. Files and
+		 // folders that cannot be read are skipped and counted in GetErrors(). A file listing that outgrows the
+		 // memory budget is moved to disk, and the passes that need every file in memory are then turned down.
+		 // With worker processes set, the walk is spread over that many copies of the browser instead of threads,
+		 // with the same result. A recursive scan saves checkpoints as it goes; one that was stopped picks up from its last checkpoint
+		 // the next time the same folders are scanned with the same filter and listing. When the index daemon holds
+		 // the folder, nothing is walked: the file listing is read from the daemon's shared segment where it can be,
+		 // and from the daemon a page at a time otherwise.
 		
-		void Scan(std::tr2::sys::path const& f, std::regex r, bool recurse);
+		void Scan(std::tr2::sys::path const& f, std::regex const& r, bool recurse, std::function<void()> const& progress = std::function<void()>());
+
+		 // Brings the last recursive scan of the file listing up to date by listing again only the folders whose
+		 // stamp changed, then shows the file listing of the same folder. A listing read from the daemon's shared
+		 // segment moves to the segment published last instead. Returns false, changing nothing, if there is no such
+		 // scan to refresh.
+
+		bool Refresh(std::function<void()> const& progress = std::function<void()>());
+
+		 // Saves the last scan of the file listing as a snapshot, then compares it with the snapshot saved before
+		 // it for the same folder, if there is one.
+
+		void TakeSnapshot();
+
+		 // Compares two saved snapshots and switches to the changes listing: the folders that changed most,
+		 // then every file added, removed, resized or modified.
+
+		void CompareSnapshots(std::string const& before, std::string const& after);
+
+		 // Finds groups of identical files among the scanned files and switches to the duplicates listing.
+		 // progress is called periodically on this thread while files are being hashed.
+
+		void FindDuplicates(std::function<void()> const& progress = std::function<void()>());
+
+		 // Searches the contents of the scanned files and switches to the matches listing, one row per matching line.
+		 // progress is called periodically on this thread while the search runs; returning false cancels it.
+
+		void SearchContents(std::string const& pattern, std::function<bool()> const& progress = std::function<bool()>());
+
+		 // Writes a checksum manifest of the files shown into the folder shown, named for algorithm. Files that
+		 // cannot be read are left out and listed. progress is called periodically on this thread while files are
+		 // hashed; returning false cancels the pass, and no manifest is written.
+
+		void WriteManifest(ChecksumManifest::Algorithm algorithm, std::function<bool()> const& progress = std::function<bool()>());
+
+		 // Checks the files named by the manifest in the folder shown, the SHA-256 one if both are there, and
+		 // switches to the manifest listing: one row per file that failed, is missing or could not be read.
+
+		void VerifyManifest(std::function<bool()> const& progress = std::function<bool()>());
+
+		 // Copies or moves every file of the listing shown into target, where each keeps its folders under the
+		 // folder shown; a file from elsewhere goes in by its name. Files that fail are listed in the failed
+		 // listing. progress is called periodically on this thread; returning false cancels the rest.
+
+		void TransferFiles(std::string const& target, FileTransfer::Mode mode, std::function<bool()> const& progress = std::function<bool()>());
+
+		 // The dry run of deleting every file of the listing shown: looks the files up and reports how many there
+		 // are and their size, deleting nothing. The plan is kept for DeletePlanned until CancelDelete. Only the
+		 // file listing and content matches are deleted from; any other listing is turned down.
+
+		void PlanDelete(std::function<bool()> const& progress = std::function<bool()>());
+
+		 // Deletes the files of the plan, then the folders that leaves empty inside the folders scanned, and drops
+		 // the plan. Files that could not be deleted are listed in the failed listing.
+
+		void DeletePlanned(std::function<bool()> const& progress = std::function<bool()>());
+
+		 // Drops the plan, if there is one, and says so in the status.
+
+		void CancelDelete();
+
+		bool HasPlannedDelete() const { return deletion_ != nullptr; }
+
+		 // Ranks the scanned files against a fuzzy query and switches to the fuzzy listing; an empty query
+		 // goes back to the file listing. A query starting with ' lists the files whose names contain the
+		 // rest of it instead, found through the name index.
+
+		void Narrow(std::string const& query);
+
+		 // Shows folder from the last scan instead of scanning it again, when that scan covers it: it was a
+		 // recursive scan of the file listing with the same filter, of folder or a folder above it. The matched
+		 // count and size become the folder's. Returns false if a new scan is needed.
+
+		bool Navigate(std::string const& folder, std::string const& filter, bool recurse, Listing listing);
+
+		 // Switches to the folder listing: one row per folder under the one shown, with its file count and size.
+
+		void ListFolders();
+
+		 // True if folder is the scanned folder or one under it, and the scan kept its folder tree.
+
+		bool IsScanned(std::string const& folder) const;
+
+		 // The run [first, end) of GetFiles() holding the files under folder, and their size, when the last scan
+		 // covers it as IsScanned says; a covered folder with no files is an empty run. Returns false otherwise.
+
+		bool FindRange(std::string const& folder, std::size_t& first, std::size_t& end, unsigned long long& bytes) const;
+
+		 // The folder above the one shown, if the last scan covers it, or an empty string. Above one of several
+		 // scanned roots is all of them.
+
+		std::string GetParentFolder() const;
+
+		 // Number of lines the file viewer can show for the current listing.
+
+		std::size_t GetRowCount() const;
+
+		 // Text of line i of the current listing.
+
+		std::string GetRow(std::size_t i) const;
+
+		 // Path of the file shown on line i of the current listing, or an empty string if the line is not a file.
+
+		std::string GetRowPath(std::size_t i) const;
+
+		 // Folder shown on line i of the folder listing, or an empty string in other listings.
+
+		std::string GetRowFolder(std::size_t i) const;
+
+	private:
+
+		 // The files of the folder shown: files_ itself, or the folder's run of it copied into subset.
+
+		std::vector<FileEntry> const& GetShownFiles(std::vector<FileEntry>& subset) const;
+
+		 // The path of every row of the listing shown that has one, each once, in the order shown.
+
+		std::vector<std::string> GetListedPaths() const;
+
+		 // Rebuilds the name index and folder tree over files_ and finds the folder shown in the new tree.
+
+		void Index();
+
+		 // The tree's node for folder, as PathTree::Find; all of a scan of several roots is the tree's root.
+
+		std::uint32_t FindFolder(std::string const& folder, std::string* rest) const;
+
+		 // Asks the index daemon for folder in the file or leaderboard listing, and shows what it answers.
+		 // Returns false, changing nothing, if no daemon is running or it does not cover the folder.
+
+		bool OpenIndex(std::string const& folder);
+
+		 // Maps the daemon's shared segment and shows folder's run of it as the file listing. Returns false,
+		 // changing nothing, if none is published, it was scanned with another filter, or folder has no files in it.
+
+		bool OpenSegment(std::string const& folder);
+
+		 // Path of file i of the file listing, wherever the files are held.
+
+		std::string GetFilePath(std::size_t i) const;
 
 	// -------- ACCESSORS --------
 	public:
 		bool IsRecursive() const { return recursion_; }
+		void SetThrottle(std::shared_ptr<ScanThrottle> const& throttle) { throttle_ = throttle; }
+		void SetMemoryBudget(unsigned long long bytes) { budget_ = bytes; }
+		void SetProcesses(unsigned processes) { processes_ = processes; }
+		bool IsSpilled() const { return store_ != nullptr; }
+		void SetUseIndex(bool use) { useIndex_ = use; }
+		bool IsServed() const { return index_ != nullptr || segment_ != nullptr; }
+		Listing GetListing() const { return listing_; }
+		void SetListing(Listing listing) { listing_ = listing; }
 
 		std::string GetSearchFolder() const { return folder_; }
 		std::string GetSearchFilter() const { return regex_; }
@@ -285,7 +560,22 @@ class FileModel : public AbstractSubject
 		unsigned long long GetMatchedFiles() const { return mFiles_; }
 		double long GetSizeOfFiles() const { return fSize_; }
 
-		std::vector<std::string> GetFiles() const { return files_; }
+		std::vector<FileEntry> const& GetFiles() const { return files_; }
+		std::vector<FileEntry> const& GetLeaders() const { return leaders_; }
+		std::shared_ptr<TrigramIndex> GetNameIndex() const { return nameIndex_; }
+
+		// One line summary of the last pass run over the result set, shown in the footer.
+		std::string GetStatus() const { return status_; }
+
+		// Folder listings and file stats per second over the last scan, shown in the footer; updated while it runs.
+		std::string GetImpact() const { return impact_; }
+
+		// Counters of the scan running, or of the last one; null before the first.
+		ScanProgress const* GetProgress() const { return progress_.get(); }
+
+		// Files and folders the last scan could not read, and one line summing them up by kind for the footer.
+		unsigned long long GetSkipped() const { return skipped_; }
+		std::string GetErrors() const { return errors_; }
 };
 class FileView : public AbstractSubject
 {
@@ -293,6 +583,33 @@ class FileView : public AbstractSubject
 	private:
 		static bool done;
 
+		// Preview pane state: whether it is shown, the file it was last asked to show and the lines it shows.
+		static bool previewOn;
+		static std::string previewPath;
+		static std::vector<std::string> previewLines;
+
+		// Text viewer state: the file open in it, and the line number or percentage being typed.
+		static std::unique_ptr<TextPager> pager;
+		static std::string goTo;
+
+		// Follow mode state: the file being followed.
+		static std::unique_ptr<LogFollower> follower;
+
+		// The key last pressed and not yet let go, so a held key's repeats are told from a fresh press.
+		static unsigned short heldKey;
+
+		// Background mode settings, the memory budget and the worker processes, handed to each scan.
+		static std::shared_ptr<ScanThrottle> throttle;
+		static unsigned long long budget;
+		static unsigned processes;
+
+		// Kind of checksum manifest F10 writes.
+		static ChecksumManifest::Algorithm checksum;
+
+		// When the scan progress was last sampled, in seconds since the scan started, and the entries it had then.
+		static double sampledAt;
+		static unsigned long long sampledEntries;
+
 	
 	public:
 		FileView() { };
@@ -310,6 +627,107 @@ class FileView : public AbstractSubject
 		
 		static BOOL CtrlHandler(DWORD ctrlType);
 
+		 // Writes the visible window of the model's listing, starting at the model's scroll position.
+
+		static void DrawRows(FileModel& model);
+
+		 // Writes the model's status line to the footer.
+
+		static void DrawStatus(FileModel const& model);
+
+		 // Writes the preview pane to the right of the file viewer.
+
+		static void DrawPreview();
+
+		 // Writes the model's scan impact to the footer.
+
+		static void DrawImpact(FileModel const& model);
+
+		 // Samples the progress of the model's running scan into the footer, at most every SAMPLE_MS; only the
+		 // cells whose text changed are written. Called on every scan tick.
+
+		static void DrawProgress(FileModel const& model);
+
+		 // Writes text to the footer textbox id, unless it is already showing it.
+
+		static void ShowCell(std::string const& id, std::string const& text);
+
+		 // F11 switches background mode, and [ and ] step its rate down and up. Returns false for any other key.
+		 // Also called while a scan runs, so the change applies to it.
+
+		static bool AdjustThrottle(WORD key);
+
+		static std::shared_ptr<ScanThrottle> const& GetThrottle() { return throttle; }
+
+		 // Bytes of files a scan may keep in memory before it moves them to disk; zero, the default, for no limit.
+
+		static void SetMemoryBudget(unsigned long long bytes) { budget = bytes; }
+		static unsigned long long GetMemoryBudget() { return budget; }
+
+		 // Worker processes each scan is spread over; zero, the default, scans with threads in this process.
+
+		static void SetProcesses(unsigned count) { processes = count; }
+		static unsigned GetProcesses() { return processes; }
+
+		 // Kind of checksum manifest F10 writes; SHA-256 by default.
+
+		static void SetChecksum(ChecksumManifest::Algorithm algorithm) { checksum = algorithm; }
+
+	private:
+
+		 // Applies a key press to an input textbox. Returns true when Enter was pressed.
+
+		static bool EditInput(Framework::Control::InputTextBox& itb, Event::Keyboard const& ke);
+
+		 // Runs a content search over the model's files, showing hits as they are found.
+
+		static void SearchContents(std::string const& pattern, FileModel& model);
+
+		 // Writes a checksum manifest of the model's files, or verifies the one in its folder, showing progress.
+
+		static void RunManifest(bool verify, FileModel& model);
+
+		 // Copies or moves the model's listed files to target, copy or move as the title bar shows, showing progress.
+
+		static void RunTransfer(std::string const& target, FileModel& model);
+
+		 // Runs the dry run of deleting the model's listed files, and shows what would go.
+
+		static void RunDelete(FileModel& model);
+
+		 // Deletes what the dry run showed, showing progress.
+
+		static void ConfirmDelete(FileModel& model);
+
+		 // Moves the selection to row, scrolling the file viewer so it stays visible.
+
+		static void Select(FileModel& model, unsigned long long row);
+
+		 // Writes text to the footer's status textbox, unless it is already showing it.
+
+		static void ShowStatus(std::string const& status);
+
+		 // Writes background mode and its rate to the title bar.
+
+		static void DrawThrottle();
+
+		 // Applies a key press to the text viewer.
+
+		static void ProcessViewerKey(Event::Keyboard const& ke, FileModel& model);
+
+		 // Writes the text viewer's page over the file viewer, and its position to the status line.
+
+		static void DrawViewer();
+
+		 // Brings the follow view up to date. Only the rows that changed are written; new lines are
+		 // scrolled in from the bottom.
+
+		static void DrawFollow(bool all, std::size_t added, bool partial);
+
+		 // Puts folder in the folder input and asks the controller to show it.
+
+		void OpenFolder(std::string const& folder);
+
 	// -------- EVENT PROCESSING -------- 
 	public:
 		
@@ -321,6 +739,10 @@ class FileView : public AbstractSubject
 		
 		void ProcessMouseEvent(Event::Mouse const& me, FileModel& model);
 
+		// Used to pick up background work that finished while no events were coming in.
+
+		void ProcessIdle(FileModel& model);
+
 	
 	public:
 		bool GetQuitState() const { return done; }
@@ -0,0 +1,133 @@
+/** @file : FileIO.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the thin file reading wrappers used by the passes that read file contents.
+History : Added for the duplicate finder. MappedFile added for the preview pane, GetCacheFolder for the line index.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "FileIO.hpp"
+
+
+// -------- CONSTRUCTOR/DESTRUCTOR --------
+
+// Opens with full sharing so files that other programs hold open can still be read, and
+// looks up the size once so callers do not have to stat again.
+
+InputFile::InputFile(std::string const& path, bool sequential) : size_(0) {
+	handle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+		sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, NULL);
+
+	LARGE_INTEGER size;
+	if (IsOpen() && GetFileSizeEx(handle_, &size))
+		size_ = static_cast<unsigned long long>(size.QuadPart);
+}
+InputFile::~InputFile() {
+	if (IsOpen())
+		CloseHandle(handle_);
+}
+
+// -------- OPERATIONS --------
+
+// ReadFile takes a DWORD length, so very large requests are capped; callers loop until zero anyway.
+
+std::size_t InputFile::Read(void* buffer, std::size_t length) {
+	DWORD read = 0;
+	DWORD want = static_cast<DWORD>(length < 0x40000000 ? length : 0x40000000);
+
+	if (!IsOpen() || !ReadFile(handle_, buffer, want, &read, NULL))
+		return 0;
+
+	return read;
+}
+
+// Passing an OVERLAPPED with the offset to a synchronous handle reads at that offset in one call.
+
+std::size_t InputFile::ReadAt(unsigned long long offset, void* buffer, std::size_t length) {
+	OVERLAPPED at = {};
+	at.Offset = static_cast<DWORD>(offset);
+	at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+	DWORD read = 0;
+	DWORD want = static_cast<DWORD>(length < 0x40000000 ? length : 0x40000000);
+
+	if (!IsOpen() || !ReadFile(handle_, buffer, want, &read, &at))
+		return 0;
+
+	return read;
+}
+
+
+// -------- MAPPED FILE --------
+
+// Opens the file and creates a mapping of the whole file; nothing is mapped into memory until Map is
+// called. Empty files cannot be mapped, so they are left without a mapping.
+
+MappedFile::MappedFile(std::string const& path) : mapping_(NULL), view_(nullptr), size_(0) {
+	file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	LARGE_INTEGER size;
+	if (IsOpen() && GetFileSizeEx(file_, &size))
+		size_ = static_cast<unsigned long long>(size.QuadPart);
+
+	if (size_ != 0)
+		mapping_ = CreateFileMappingA(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+}
+MappedFile::~MappedFile() {
+	Unmap();
+	if (mapping_)
+		CloseHandle(mapping_);
+	if (IsOpen())
+		CloseHandle(file_);
+}
+
+// Views must start on an allocation granularity boundary, so the window is widened down to one
+// and the returned pointer is moved forward to the offset asked for.
+
+char const* MappedFile::Map(unsigned long long offset, std::size_t length) {
+	Unmap();
+	if (!mapping_ || offset >= size_)
+		return nullptr;
+
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+
+	unsigned long long start = offset - offset % si.dwAllocationGranularity;
+	unsigned long long end = size_ - offset < length ? size_ : offset + length;
+
+	view_ = MapViewOfFile(mapping_, FILE_MAP_READ, static_cast<DWORD>(start >> 32), static_cast<DWORD>(start), static_cast<SIZE_T>(end - start));
+	if (!view_)
+		return nullptr;
+
+	return static_cast<char const*>(view_) + (offset - start);
+}
+
+void MappedFile::Unmap() {
+	if (view_)
+		UnmapViewOfFile(view_);
+	view_ = nullptr;
+}
+
+
+// -------- CACHE FOLDER --------
+
+std::string GetCacheFolder() {
+	char base[MAX_PATH] = "";
+	DWORD n = GetEnvironmentVariableA("LOCALAPPDATA", base, MAX_PATH);
+	if (n == 0 || n >= MAX_PATH)
+	{
+		n = GetTempPathA(MAX_PATH, base);
+		if (n == 0 || n >= MAX_PATH)
+			return std::string();
+	}
+
+	std::string folder(base);
+	if (folder.back() != '\\')
+		folder += '\\';
+	folder += "TUI File Browser\\";
+
+	if (!CreateDirectoryA(folder.c_str(), NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+		return std::string();
+
+	return folder;
+}
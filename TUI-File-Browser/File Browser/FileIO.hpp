@@ -0,0 +1,103 @@
+/** @file : FileIO.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the thin file reading wrappers used by the passes that read file contents.
+History : Added for the duplicate finder. MappedFile added for the preview pane, GetCacheFolder for the line index.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __FILE_IO_GUARD__
+#define __FILE_IO_GUARD__
+
+#include <Windows.h>
+#include <string>
+
+
+// Read-only handle to a file. Opening never throws; a file that cannot be opened reports IsOpen() == false
+// and every read returns zero, so a pass over thousands of files can simply skip the ones it cannot read.
+
+class InputFile
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		HANDLE				handle_;
+		unsigned long long	size_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+
+		 // Opens the file for reading. Sequential hints the cache manager to read ahead, which is
+		 // what a pass that streams the whole file wants.
+
+		InputFile(std::string const& path, bool sequential = true);
+		~InputFile();
+
+		// Add these so the handle cannot be closed twice.
+		InputFile(InputFile const&) = delete;
+		void operator=(InputFile const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Reads up to length bytes from the current position. Returns the number of bytes read, zero at end of file or on error.
+
+		std::size_t Read(void* buffer, std::size_t length);
+
+		 // Reads up to length bytes starting at offset, without disturbing the sequential position.
+
+		std::size_t ReadAt(unsigned long long offset, void* buffer, std::size_t length);
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsOpen() const { return handle_ != INVALID_HANDLE_VALUE; }
+		unsigned long long GetSize() const { return size_; }
+		HANDLE GetHandle() const { return handle_; }
+};
+
+// Read-only memory mapping of a window of a file. Only the window asked for is mapped, and pages are only
+// read when touched, so looking at the start of a huge file costs the same as looking at a small one.
+// Like InputFile it never throws; Map returns nullptr when the file cannot be mapped.
+
+class MappedFile
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		HANDLE				file_;
+		HANDLE				mapping_;
+		void const*			view_;
+		unsigned long long	size_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+		MappedFile(std::string const& path);
+		~MappedFile();
+
+		// Add these so the handles cannot be closed twice.
+		MappedFile(MappedFile const&) = delete;
+		void operator=(MappedFile const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Maps length bytes starting at offset (clipped to the end of the file) and returns a pointer to the
+		 // byte at offset. Any previous window is unmapped first.
+
+		char const* Map(unsigned long long offset, std::size_t length);
+
+		 // Unmaps the current window.
+
+		void Unmap();
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsOpen() const { return file_ != INVALID_HANDLE_VALUE; }
+		unsigned long long GetSize() const { return size_; }
+};
+
+// Folder the browser keeps its caches in, with a trailing separator: "TUI File Browser" under the user's local
+// application data, or under the temp folder when that is not set. Created on first use; empty if it cannot be.
+
+std::string GetCacheFolder();
+
+#endif
@@ -0,0 +1,236 @@
+/** @file : Follow.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the tail -f style follower used by the viewer's follow mode.
+History : Added so a growing log file can be watched from the file viewer.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Follow.hpp"
+
+#include <vector>
+#include <cctype>
+#include <cstring>
+
+
+namespace {
+	// Bytes read at a time.
+	std::size_t const READ_SIZE = 1024 * 1024;
+
+	// Current size of an open file, which unlike the folder entry is up to date while a writer holds it open.
+	unsigned long long CurrentSize(HANDLE file) {
+		LARGE_INTEGER size;
+		return GetFileSizeEx(file, &size) ? static_cast<unsigned long long>(size.QuadPart) : 0;
+	}
+}
+
+
+// -------- CONSTRUCTOR/DESTRUCTOR --------
+
+// Watches the file's folder for names changing, which is how a rotation shows up. The folder's path is
+// everything up to the last separator.
+
+LogFollower::LogFollower(std::string const& path, std::size_t rows, std::size_t width) : path_(path), rows_(rows ? rows : 1), width_(width), id_(0), offset_(0), polls_(0),
+	dropLine_(false), cut_(false), skipped_(0), rotations_(0), truncations_(0), rateStart_(std::chrono::steady_clock::now()), rateBytes_(0), rate_(0) {
+	std::string::size_type slash = path.find_last_of("\\/");
+	std::string folder = slash == std::string::npos ? std::string(".") : path.substr(0, slash + 1);
+	watch_ = FindFirstChangeNotificationA(folder.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME);
+
+	Open(~0ull);
+}
+LogFollower::~LogFollower() {
+	if (IsWatched())
+		FindCloseChangeNotification(watch_);
+}
+
+// -------- OPERATIONS --------
+
+// Appends are picked up from the size of the open handle on every poll; that check is a single call and,
+// unlike a folder notification, is not delayed until the writer closes the file. The folder notification is
+// only used to decide when to check whether the name now points at another file. When the folder cannot be
+// watched, that check is made every IDENTITY_EVERY polls instead.
+
+LogFollower::Change LogFollower::Poll() {
+	Change change;
+	if (!IsOpen())
+	{
+		// The file could not be opened; keep trying in case it appears.
+		Open(0);
+		change.reset_ = IsOpen();
+		return change;
+	}
+
+	bool checkIdentity = false;
+	if (IsWatched())
+	{
+		if (WaitForSingleObject(watch_, 0) == WAIT_OBJECT_0)
+		{
+			checkIdentity = true;
+			FindNextChangeNotification(watch_);
+		}
+	}
+	else
+		checkIdentity = ++polls_ % IDENTITY_EVERY == 0;
+
+	unsigned long long size = CurrentSize(file_->GetHandle());
+
+	// Both cases start over from the top of the file now under the name.
+	if ((checkIdentity && Rotated()) || size < offset_)
+	{
+		if (size < offset_)
+			++truncations_;
+		else
+			++rotations_;
+
+		Open(0);
+		change.reset_ = true;
+		if (!IsOpen())
+			return change;
+
+		size = CurrentSize(file_->GetHandle());
+	}
+
+	if (size <= offset_)
+		return change;
+
+	rateBytes_ += size - offset_;
+	if (size - offset_ > BURST)
+	{
+		skipped_ += size - TAIL - offset_;
+		offset_ = size - TAIL;
+		partial_.clear();
+		cut_ = false;
+		dropLine_ = true;
+		change.reset_ = true;
+	}
+
+	change.added_ = ReadTo(size, change.partial_);
+
+	// Measure the append rate over windows of about a second.
+	auto now = std::chrono::steady_clock::now();
+	double elapsed = std::chrono::duration<double>(now - rateStart_).count();
+	if (elapsed >= 1.0)
+	{
+		rate_ = rateBytes_ / elapsed;
+		rateBytes_ = 0;
+		rateStart_ = now;
+	}
+
+	return change;
+}
+
+// Opening at ~0 means "the last TAIL bytes"; a new file that is already big is also started near its end.
+// Everything kept from the previous file is cleared.
+
+void LogFollower::Open(unsigned long long offset) {
+	file_.reset(new InputFile(path_, false));
+	lines_.clear();
+	partial_.clear();
+	cut_ = false;
+
+	if (!file_->IsOpen())
+	{
+		offset_ = 0;
+		return;
+	}
+
+	id_ = GetFileId(file_->GetHandle());
+
+	unsigned long long size = CurrentSize(file_->GetHandle());
+	if (offset == ~0ull)
+		offset = size > TAIL ? size - TAIL : 0;
+	else if (size - offset > BURST)
+	{
+		skipped_ += size - TAIL - offset;
+		offset = size - TAIL;
+	}
+
+	offset_ = offset;
+	dropLine_ = offset != 0;
+
+	bool partial = false;
+	ReadTo(size, partial);
+}
+
+// Newlines are found with memchr; only the last rows - 1 complete lines are kept. Each line is stored already
+// cut to the view's width with tabs expanded, so drawing it is a single write.
+
+std::size_t LogFollower::ReadTo(unsigned long long size, bool& partial) {
+	std::vector<char> buf(READ_SIZE);
+	std::size_t added = 0;
+
+	while (offset_ < size)
+	{
+		std::size_t const want = static_cast<std::size_t>(std::min<unsigned long long>(READ_SIZE, size - offset_));
+		std::size_t got = file_->ReadAt(offset_, buf.data(), want);
+		if (got == 0)
+			break;
+
+		offset_ += got;
+
+		char const* p = buf.data();
+		char const* end = p + got;
+		while (p < end)
+		{
+			char const* nl = static_cast<char const*>(memchr(p, '\n', end - p));
+			char const* stop = nl ? nl : end;
+
+			if (!dropLine_)
+			{
+				std::size_t const was = partial_.size();
+				for (; p < stop && !cut_; ++p)
+				{
+					unsigned char c = static_cast<unsigned char>(*p);
+					if (c == '\r')
+						continue;
+					else if (c == '\t')
+						partial_.append(4 - partial_.size() % 4, ' ');
+					else
+						partial_ += isprint(c) ? static_cast<char>(c) : '.';
+
+					if (partial_.size() >= width_)
+					{
+						partial_.resize(width_);
+						cut_ = true;
+					}
+				}
+				partial = partial || partial_.size() != was;
+			}
+
+			if (!nl)
+				break;
+
+			if (!dropLine_)
+			{
+				lines_.push_back(partial_);
+				if (lines_.size() >= rows_)
+					lines_.pop_front();
+				++added;
+			}
+
+			partial_.clear();
+			cut_ = false;
+			dropLine_ = false;
+			p = nl + 1;
+		}
+	}
+
+	return added;
+}
+
+// The name is opened afresh and its identity compared with the handle already open. If the name does not open,
+// the file was moved away and not yet replaced, so the old handle is kept.
+
+bool LogFollower::Rotated() {
+	InputFile probe(path_, false);
+	return probe.IsOpen() && GetFileId(probe.GetHandle()) != id_;
+}
+
+unsigned long long LogFollower::GetFileId(HANDLE file) {
+	BY_HANDLE_FILE_INFORMATION info;
+	if (!GetFileInformationByHandle(file, &info))
+		return 0;
+
+	unsigned long long index = (static_cast<unsigned long long>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+	return index ^ (static_cast<unsigned long long>(info.dwVolumeSerialNumber) * 0x9E3779B97F4A7C15ull);
+}
@@ -0,0 +1,131 @@
+/** @file : Follow.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the tail -f style follower used by the viewer's follow mode.
+History : Added so a growing log file can be watched from the file viewer.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __FOLLOW_GUARD__
+#define __FOLLOW_GUARD__
+
+#include "FileIO.hpp"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <chrono>
+
+
+// Keeps the last lines of a file that is being appended to. Each Poll reads only the bytes appended since the
+// last one, through a handle that stays open, so the file is never read twice. A burst too big to show line by
+// line is skipped down to its last TAIL bytes, since only the last screen of it could be seen anyway.
+// A file that shrinks is read again from the start; one replaced under the same name (log rotation) is
+// noticed by its file index changing and followed from the start of the new file.
+
+class LogFollower
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// What one Poll changed, so the caller can redraw only that.
+		struct Change
+		{
+			std::size_t	added_;		// complete lines added at the bottom
+			bool		partial_;	// the unfinished last line changed
+			bool		reset_;		// the file was truncated or rotated; redraw everything
+
+			Change() : added_(0), partial_(false), reset_(false) { };
+		};
+
+	// -------- CLASS MEMBERS --------
+	public:
+		// Bytes read from the end when opening, and when skipping a burst.
+		static std::size_t const TAIL = 64 * 1024;
+
+		// Appends bigger than this between two polls are skipped down to the last TAIL bytes.
+		static std::size_t const BURST = 4 * 1024 * 1024;
+
+		// Polls between file identity checks when the folder cannot be watched.
+		static unsigned const IDENTITY_EVERY = 20;
+
+	private:
+		std::string					path_;
+		std::size_t					rows_;
+		std::size_t					width_;
+
+		std::unique_ptr<InputFile>	file_;
+		unsigned long long			id_;
+		unsigned long long			offset_;
+		HANDLE						watch_;
+		unsigned					polls_;
+
+		std::deque<std::string>		lines_;
+		std::string					partial_;
+		bool						dropLine_;
+		bool						cut_;
+
+		unsigned long long			skipped_;
+		unsigned					rotations_;
+		unsigned					truncations_;
+
+		std::chrono::steady_clock::time_point	rateStart_;
+		unsigned long long						rateBytes_;
+		double									rate_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+
+		 // Opens the file and reads its last TAIL bytes. rows and width are the size of the view.
+
+		LogFollower(std::string const& path, std::size_t rows, std::size_t width);
+		~LogFollower();
+
+		// Add these so the handles cannot be closed twice.
+		LogFollower(LogFollower const&) = delete;
+		void operator=(LogFollower const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Reads whatever was appended since the last call and reports what changed.
+
+		Change Poll();
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsOpen() const { return file_ && file_->IsOpen(); }
+		bool IsWatched() const { return watch_ != INVALID_HANDLE_VALUE; }
+
+		// Complete lines, oldest first, at most rows - 1 of them; the unfinished line goes below them.
+		std::deque<std::string> const& GetLines() const { return lines_; }
+		std::string const& GetPartial() const { return partial_; }
+
+		unsigned long long GetOffset() const { return offset_; }
+		unsigned long long GetSkipped() const { return skipped_; }
+		unsigned GetRotations() const { return rotations_; }
+		unsigned GetTruncations() const { return truncations_; }
+
+		// Append rate over the last second or so, in bytes per second.
+		double GetRate() const { return rate_; }
+
+	private:
+
+		 // Opens path and starts reading at offset, dropping the first line if that is not the start of a line.
+
+		void Open(unsigned long long offset);
+
+		 // Reads from offset_ to size, splitting what it reads into lines.
+
+		std::size_t ReadTo(unsigned long long size, bool& partial);
+
+		 // Returns true if path now names a different file from the one open.
+
+		bool Rotated();
+
+		 // Volume serial number and file index of an open file, which stay the same across renames.
+
+		static unsigned long long GetFileId(HANDLE file);
+};
+
+#endif
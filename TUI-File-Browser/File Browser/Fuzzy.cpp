@@ -0,0 +1,278 @@
+/** @file : Fuzzy.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the fuzzy finder over the scanned paths.
+History : Added so a file can be found by typing parts of its path, without rescanning.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Fuzzy.hpp"
+#include "ThreadPool.hpp"
+#include "TopK.hpp"
+
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define FUZZY_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+namespace {
+	// Points for each matched character, and bonuses for where it matched.
+	int const MATCH = 16;
+	int const SEGMENT_START = 12;	// just after a path separator
+	int const WORD_START = 8;		// just after '_', '-', '.' or a space, or at a lower to upper case change
+	int const CONSECUTIVE = 6;		// right after the previous matched character
+	int const IN_NAME = 20;			// the whole match lies in the file name
+	int const GAP_START = 3;		// first character skipped in a gap
+	int const GAP = 1;				// each further character skipped
+
+	char Lower(char c) {
+		return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+	}
+
+	bool IsSeparator(char c) {
+		return c == '\\' || c == '/';
+	}
+
+#ifdef FUZZY_SSE2
+	unsigned LowestBit(unsigned mask) {
+#ifdef _MSC_VER
+		unsigned long bit;
+		_BitScanForward(&bit, mask);
+		return bit;
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+#endif
+
+	// Position of the first character at or after from that equals c in either case, or length if there is none.
+	// With SSE2, sixteen characters are compared against both cases at once.
+	std::size_t Find(char const* s, std::size_t from, std::size_t length, char c) {
+		char const upper = c >= 'a' && c <= 'z' ? static_cast<char>(c - ('a' - 'A')) : c;
+		std::size_t i = from;
+
+#ifdef FUZZY_SSE2
+		__m128i const lo = _mm_set1_epi8(c);
+		__m128i const up = _mm_set1_epi8(upper);
+		for (; i + 16 <= length; i += 16)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + i));
+			unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, lo), _mm_cmpeq_epi8(v, up)));
+			if (mask)
+				return i + LowestBit(mask);
+		}
+#endif
+
+		for (; i < length; ++i)
+			if (s[i] == c || s[i] == upper)
+				return i;
+		return length;
+	}
+
+	// Ranks hits best first; ties go to the shorter path, then to the earlier one.
+	struct RankHits
+	{
+		std::vector<std::size_t> const* starts_;
+
+		RankHits(std::vector<std::size_t> const* starts = nullptr) : starts_(starts) { };
+
+		bool operator()(FuzzyHit const& a, FuzzyHit const& b) const {
+			if (a.score_ != b.score_)
+				return a.score_ > b.score_;
+
+			std::size_t la = (*starts_)[a.item_ + 1] - (*starts_)[a.item_];
+			std::size_t lb = (*starts_)[b.item_ + 1] - (*starts_)[b.item_];
+			if (la != lb)
+				return la < lb;
+			return a.item_ < b.item_;
+		}
+	};
+}
+
+
+// -------- CONSTRUCTOR --------
+
+FuzzyFinder::FuzzyFinder(std::vector<FileEntry> const& files) : scored_(0), seconds_(0) {
+	std::size_t total = 0;
+	for (auto const& f : files)
+		total += f.path_.size();
+
+	arena_.reserve(total);
+	starts_.reserve(files.size() + 1);
+	masks_.reserve(files.size());
+	for (auto const& f : files)
+	{
+		starts_.push_back(arena_.size());
+		masks_.push_back(CharacterMask(f.path_.data(), f.path_.size()));
+		arena_.insert(arena_.end(), f.path_.begin(), f.path_.end());
+	}
+	starts_.push_back(arena_.size());
+}
+
+// -------- OPERATIONS --------
+
+// Drops the kept sets whose query is not a prefix of the new one, then scores only the paths in the deepest
+// set left (all paths if none is left). The work is split into batches on the thread pool; each batch keeps
+// its matches in their original order, so the new set comes out the same however the batches are scheduled,
+// and each worker keeps a bounded heap of its best hits, merged at the end.
+
+void FuzzyFinder::Search(std::string const& query) {
+	auto start = std::chrono::steady_clock::now();
+
+	std::string q(query);
+	std::transform(q.begin(), q.end(), q.begin(), Lower);
+
+	while (!levels_.empty() && q.compare(0, levels_.back().query_.size(), levels_.back().query_) != 0)
+		levels_.pop_back();
+
+	if (!levels_.empty() && levels_.back().query_ == q)
+	{
+		results_ = levels_.back().results_;
+		scored_ = 0;
+		seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return;
+	}
+
+	results_.clear();
+	scored_ = 0;
+	if (q.empty())
+		return;
+
+	std::vector<std::uint32_t> const* base = levels_.empty() ? nullptr : &levels_.back().survivors_;
+	std::size_t const count = base ? base->size() : starts_.size() - 1;
+	std::size_t const batches = (count + BATCH - 1) / BATCH;
+	std::uint64_t const mask = CharacterMask(q.data(), q.size());
+
+	ThreadPool pool;
+	std::vector<std::vector<std::uint32_t>> found(batches);
+	std::vector<std::unique_ptr<BoundedHeap<FuzzyHit, RankHits>>> best;
+	for (unsigned i = 0; i < pool.GetThreadCount(); ++i)
+		best.push_back(std::unique_ptr<BoundedHeap<FuzzyHit, RankHits>>(new BoundedHeap<FuzzyHit, RankHits>(MAX_RESULTS, RankHits(&starts_))));
+
+	pool.ParallelFor(batches, [&](unsigned worker, std::size_t batch) {
+		std::size_t const end = std::min(count, (batch + 1) * BATCH);
+		for (std::size_t i = batch * BATCH; i < end; ++i)
+		{
+			std::uint32_t const item = base ? (*base)[i] : static_cast<std::uint32_t>(i);
+			if (mask & ~masks_[item])
+				continue;
+
+			std::size_t const from = starts_[item];
+			int score = Score(&arena_[0] + from, starts_[item + 1] - from, q);
+			if (score == NO_MATCH)
+				continue;
+
+			found[batch].push_back(item);
+			best[worker]->Offer(FuzzyHit(item, score));
+		}
+	});
+
+	BoundedHeap<FuzzyHit, RankHits> merged(MAX_RESULTS, RankHits(&starts_));
+	for (auto const& b : best)
+		merged.Merge(*b);
+	results_ = merged.Sorted();
+
+	Level level;
+	level.query_ = q;
+	level.results_ = results_;
+	for (auto const& f : found)
+		level.survivors_.insert(level.survivors_.end(), f.begin(), f.end());
+	levels_.push_back(std::move(level));
+
+	scored_ = count;
+	seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Finds the leftmost match with the vectorised search, then walks back from its end to the latest start that
+// still matches, which gives the tightest window ending there. The window is then scored: each matched character
+// earns points, more at the start of a path segment or word and when it follows the previous match, and every
+// skipped character inside the window costs a little. A match entirely inside the file name scores extra.
+
+int FuzzyFinder::Score(char const* path, std::size_t length, std::string const& query) {
+	std::size_t const m = query.size();
+	if (m == 0)
+		return 0;
+
+	std::size_t pos = 0;
+	for (std::size_t j = 0; j < m; ++j)
+	{
+		pos = Find(path, pos, length, query[j]);
+		if (pos == length)
+			return NO_MATCH;
+		++pos;
+	}
+
+	std::size_t const end = pos;
+	std::size_t begin = end;
+	for (std::size_t j = m; j > 0;)
+	{
+		--begin;
+		if (Lower(path[begin]) == query[j - 1])
+			--j;
+	}
+
+	int score = 0;
+	std::size_t j = 0;
+	bool previousMatched = false;
+	bool inGap = false;
+	for (std::size_t i = begin; i < end && j < m; ++i)
+	{
+		if (Lower(path[i]) != query[j])
+		{
+			score -= inGap ? GAP : GAP_START;
+			inGap = true;
+			previousMatched = false;
+			continue;
+		}
+
+		int points = MATCH;
+		char const before = i ? path[i - 1] : '\\';
+		if (IsSeparator(before))
+			points += SEGMENT_START;
+		else if (before == '_' || before == '-' || before == '.' || before == ' ' || (before >= 'a' && before <= 'z' && path[i] >= 'A' && path[i] <= 'Z'))
+			points += WORD_START;
+		if (previousMatched)
+			points += CONSECUTIVE;
+
+		score += points;
+		previousMatched = true;
+		inGap = false;
+		++j;
+	}
+
+	std::size_t name = length;
+	while (name > 0 && !IsSeparator(path[name - 1]))
+		--name;
+	if (begin >= name)
+		score += IN_NAME;
+
+	return score;
+}
+
+// Letters fold to their lower case bit and digits get a bit each; everything else shares the remaining bits.
+
+std::uint64_t FuzzyFinder::CharacterMask(char const* text, std::size_t length) {
+	std::uint64_t mask = 0;
+	for (std::size_t i = 0; i < length; ++i)
+	{
+		unsigned char c = static_cast<unsigned char>(Lower(text[i]));
+		unsigned bit;
+		if (c >= 'a' && c <= 'z')
+			bit = c - 'a';
+		else if (c >= '0' && c <= '9')
+			bit = 26 + (c - '0');
+		else
+			bit = 36 + c % 28;
+		mask |= std::uint64_t(1) << bit;
+	}
+	return mask;
+}
@@ -0,0 +1,101 @@
+/** @file : Fuzzy.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the fuzzy finder over the scanned paths.
+History : Added so a file can be found by typing parts of its path, without rescanning.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __FUZZY_GUARD__
+#define __FUZZY_GUARD__
+
+#include "ScanEngine.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+// One path that matched the query, and how well.
+struct FuzzyHit
+{
+	std::uint32_t	item_;
+	int				score_;
+
+	FuzzyHit() : item_(0), score_(0) { };
+	FuzzyHit(std::uint32_t item, int score) : item_(item), score_(score) { };
+};
+
+// Ranks paths by how well a query matches them as a case-insensitive subsequence, fzf style. The paths are
+// copied into one contiguous block when the finder is made, so a pass over millions of them streams through
+// memory instead of chasing a pointer per path, and the set of characters in each path is kept beside it.
+// Narrowing is incremental: the paths that matched each query are kept, so typing another character only
+// re-scores the paths that matched before it, and deleting one goes straight back to the set kept for the
+// shorter query.
+
+class FuzzyFinder
+{
+	// -------- CLASS MEMBERS --------
+	public:
+		// Number of best matches kept, in order, for the listing.
+		static std::size_t const MAX_RESULTS = 1000;
+
+		// Paths scored by one pool task.
+		static std::size_t const BATCH = 16384;
+
+		// Returned by Score when the query is not a subsequence of the path.
+		static int const NO_MATCH = -0x7fffffff;
+
+	private:
+		// Paths that matched one query; an empty query matches everything and is not stored.
+		struct Level
+		{
+			std::string					query_;
+			std::vector<std::uint32_t>	survivors_;
+			std::vector<FuzzyHit>		results_;
+		};
+
+		std::vector<char>			arena_;
+		std::vector<std::size_t>	starts_;
+		std::vector<std::uint64_t>	masks_;
+		std::vector<Level>			levels_;
+
+		std::vector<FuzzyHit>		results_;
+		std::size_t					scored_;
+		double						seconds_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		FuzzyFinder(std::vector<FileEntry> const& files);
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Narrows the paths to those matching query and ranks the best MAX_RESULTS of them.
+
+		void Search(std::string const& query);
+
+		 // Scores path against query, which must already be lower case. Higher is better; NO_MATCH if the
+		 // query's characters do not all appear in the path in order.
+
+		static int Score(char const* path, std::size_t length, std::string const& query);
+
+		 // Set of the characters in text, folded to 64 bits. A path whose set lacks any of the query's
+		 // characters cannot match, which rejects most paths without looking at them again.
+
+		static std::uint64_t CharacterMask(char const* text, std::size_t length);
+
+	// -------- ACCESSORS --------
+	public:
+		std::vector<FuzzyHit> const& GetResults() const { return results_; }
+		std::string GetPath(std::uint32_t item) const { return std::string(&arena_[starts_[item]], starts_[item + 1] - starts_[item]); }
+
+		// Paths matching the last query, paths scored to find them, and the time that took.
+		std::size_t GetMatchCount() const { return levels_.empty() ? starts_.size() - 1 : levels_.back().survivors_.size(); }
+		std::size_t GetScored() const { return scored_; }
+		double GetSeconds() const { return seconds_; }
+		std::size_t GetPathCount() const { return starts_.size() - 1; }
+};
+
+#endif
@@ -0,0 +1,316 @@
+/** @file : Hashing.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the content hashes used to compare files.
+History : Added for the duplicate finder. SHA-256 and CRC32C added for checksum manifests.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Hashing.hpp"
+
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define HASHING_CRC32_INSTRUCTION
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+namespace {
+	std::uint64_t const C1 = 0x87c37b91114253d5ULL;
+	std::uint64_t const C2 = 0x4cf5ad432745937fULL;
+
+	inline std::uint64_t Rotl(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+	inline std::uint64_t Fmix(std::uint64_t k) {
+		k ^= k >> 33;
+		k *= 0xff51afd7ed558ccdULL;
+		k ^= k >> 33;
+		k *= 0xc4ceb9fe1a85ec53ULL;
+		k ^= k >> 33;
+		return k;
+	}
+
+	inline std::uint64_t Load64(unsigned char const* p) {
+		std::uint64_t v;
+		std::memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	std::uint32_t const K256[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+
+	inline std::uint32_t Rotr(std::uint32_t x, int r) { return (x >> r) | (x << (32 - r)); }
+
+	inline std::uint32_t LoadBig32(unsigned char const* p) {
+		return static_cast<std::uint32_t>(p[0]) << 24 | static_cast<std::uint32_t>(p[1]) << 16 | static_cast<std::uint32_t>(p[2]) << 8 | p[3];
+	}
+
+	// The reflected Castagnoli polynomial, and the tables for eight bytes at a time: Tables()[k][b] is the
+	// CRC of byte b followed by k zero bytes.
+	std::uint32_t const CASTAGNOLI = 0x82f63b78;
+
+	struct CrcTables
+	{
+		std::uint32_t t_[8][256];
+
+		CrcTables() {
+			for (std::uint32_t b = 0; b < 256; ++b)
+			{
+				std::uint32_t crc = b;
+				for (int bit = 0; bit < 8; ++bit)
+					crc = crc & 1 ? (crc >> 1) ^ CASTAGNOLI : crc >> 1;
+				t_[0][b] = crc;
+			}
+			for (std::uint32_t b = 0; b < 256; ++b)
+				for (int k = 1; k < 8; ++k)
+					t_[k][b] = (t_[k - 1][b] >> 8) ^ t_[0][t_[k - 1][b] & 0xff];
+		}
+	};
+
+	// Kept out of Tables(), where Visual Studio 2013 would build a static unguarded while other workers read it.
+	CrcTables const crcTables;
+
+	CrcTables const& Tables() {
+		return crcTables;
+	}
+
+	bool HasCrc32Instruction() {
+#if defined(HASHING_CRC32_INSTRUCTION) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		return (info[2] & (1 << 20)) != 0;
+#elif defined(HASHING_CRC32_INSTRUCTION)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// Kept out of IsHardware(), where Visual Studio 2013 would set a static unguarded while other workers read it.
+	bool const crcHardware = HasCrc32Instruction();
+}
+
+// -------- CONSTRUCTOR --------
+Hash128::Hash128(std::uint64_t seed) : h1_(seed), h2_(seed), length_(0), tailLength_(0) {
+}
+
+// -------- OPERATIONS --------
+
+// Mixes one 16 byte block into the state.
+
+void Hash128::Block(std::uint64_t k1, std::uint64_t k2) {
+	k1 *= C1; k1 = Rotl(k1, 31); k1 *= C2; h1_ ^= k1;
+	h1_ = Rotl(h1_, 27); h1_ += h2_; h1_ = h1_ * 5 + 0x52dce729;
+
+	k2 *= C2; k2 = Rotl(k2, 33); k2 *= C1; h2_ ^= k2;
+	h2_ = Rotl(h2_, 31); h2_ += h1_; h2_ = h2_ * 5 + 0x38495ab5;
+}
+
+// Tops up a partial block left by the previous call first, then mixes whole blocks straight from the
+// caller's buffer and keeps whatever is left over for next time.
+
+void Hash128::Update(void const* data, std::size_t length) {
+	unsigned char const* p = static_cast<unsigned char const*>(data);
+	length_ += length;
+
+	if (tailLength_ != 0)
+	{
+		std::size_t take = 16 - tailLength_ < length ? 16 - tailLength_ : length;
+		std::memcpy(tail_ + tailLength_, p, take);
+		tailLength_ += take;
+		p += take;
+		length -= take;
+
+		if (tailLength_ < 16)
+			return;
+
+		Block(Load64(tail_), Load64(tail_ + 8));
+		tailLength_ = 0;
+	}
+
+	for (; length >= 16; p += 16, length -= 16)
+		Block(Load64(p), Load64(p + 8));
+
+	std::memcpy(tail_, p, length);
+	tailLength_ = length;
+}
+
+// Mixes the left over bytes and the length, then runs the finalisation mix. Works on copies so the
+// hash can keep being updated afterwards.
+
+Hash128::Digest Hash128::Final() const {
+	std::uint64_t h1 = h1_;
+	std::uint64_t h2 = h2_;
+	std::uint64_t k1 = 0;
+	std::uint64_t k2 = 0;
+
+	for (std::size_t i = tailLength_; i > 8; --i)
+		k2 ^= static_cast<std::uint64_t>(tail_[i - 1]) << ((i - 9) * 8);
+	if (tailLength_ > 8)
+	{
+		k2 *= C2; k2 = Rotl(k2, 33); k2 *= C1; h2 ^= k2;
+	}
+
+	for (std::size_t i = tailLength_ < 8 ? tailLength_ : 8; i > 0; --i)
+		k1 ^= static_cast<std::uint64_t>(tail_[i - 1]) << ((i - 1) * 8);
+	if (tailLength_ > 0)
+	{
+		k1 *= C1; k1 = Rotl(k1, 31); k1 *= C2; h1 ^= k1;
+	}
+
+	h1 ^= length_;
+	h2 ^= length_;
+	h1 += h2;
+	h2 += h1;
+	h1 = Fmix(h1);
+	h2 = Fmix(h2);
+	h1 += h2;
+	h2 += h1;
+
+	Digest d = { h1, h2 };
+	return d;
+}
+
+// -------- SHA-256 --------
+
+Sha256::Sha256() : length_(0), tailLength_(0) {
+	std::uint32_t const initial[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+	std::memcpy(state_, initial, sizeof(state_));
+}
+
+// Compresses one 64 byte block into state.
+
+void Sha256::Block(std::uint32_t* state, unsigned char const* block) {
+	std::uint32_t w[64];
+	for (int i = 0; i < 16; ++i)
+		w[i] = LoadBig32(block + 4 * i);
+	for (int i = 16; i < 64; ++i)
+	{
+		std::uint32_t const s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+		std::uint32_t const s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+		w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+	}
+
+	std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+	for (int i = 0; i < 64; ++i)
+	{
+		std::uint32_t const t1 = h + (Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25)) + ((e & f) ^ (~e & g)) + K256[i] + w[i];
+		std::uint32_t const t2 = (Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+		h = g; g = f; f = e; e = d + t1;
+		d = c; c = b; b = a; a = t1 + t2;
+	}
+
+	state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+	state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+// As Hash128::Update, with 64 byte blocks.
+
+void Sha256::Update(void const* data, std::size_t length) {
+	unsigned char const* p = static_cast<unsigned char const*>(data);
+	length_ += length;
+
+	if (tailLength_ != 0)
+	{
+		std::size_t take = 64 - tailLength_ < length ? 64 - tailLength_ : length;
+		std::memcpy(tail_ + tailLength_, p, take);
+		tailLength_ += take;
+		p += take;
+		length -= take;
+
+		if (tailLength_ < 64)
+			return;
+
+		Block(state_, tail_);
+		tailLength_ = 0;
+	}
+
+	for (; length >= 64; p += 64, length -= 64)
+		Block(state_, p);
+
+	std::memcpy(tail_, p, length);
+	tailLength_ = length;
+}
+
+// Pads a copy of the last block with a one bit, zeros and the length in bits, so the hash can keep being
+// updated afterwards.
+
+Sha256::Digest Sha256::Final() const {
+	std::uint32_t state[8];
+	std::memcpy(state, state_, sizeof(state));
+
+	unsigned char last[128] = {};
+	std::memcpy(last, tail_, tailLength_);
+	last[tailLength_] = 0x80;
+	std::size_t const blocks = tailLength_ + 9 > 64 ? 2 : 1;
+
+	std::uint64_t const bits = length_ * 8;
+	for (int i = 0; i < 8; ++i)
+		last[blocks * 64 - 1 - i] = static_cast<unsigned char>(bits >> (8 * i));
+	for (std::size_t i = 0; i < blocks; ++i)
+		Block(state, last + 64 * i);
+
+	Digest d;
+	for (int i = 0; i < 8; ++i)
+		for (int j = 0; j < 4; ++j)
+			d.bytes_[4 * i + j] = static_cast<unsigned char>(state[i] >> (24 - 8 * j));
+	return d;
+}
+
+// -------- CRC-32C --------
+
+bool Crc32c::IsHardware() {
+	return crcHardware;
+}
+
+void Crc32c::Update(void const* data, std::size_t length) {
+	unsigned char const* p = static_cast<unsigned char const*>(data);
+	std::uint32_t crc = crc_;
+
+#ifdef HASHING_CRC32_INSTRUCTION
+	if (IsHardware())
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		std::uint64_t wide = crc;
+		for (; length >= 8; p += 8, length -= 8)
+			wide = _mm_crc32_u64(wide, Load64(p));
+		crc = static_cast<std::uint32_t>(wide);
+#else
+		for (; length >= 4; p += 4, length -= 4)
+		{
+			std::uint32_t word;
+			std::memcpy(&word, p, sizeof(word));
+			crc = _mm_crc32_u32(crc, word);
+		}
+#endif
+		for (; length > 0; ++p, --length)
+			crc = _mm_crc32_u8(crc, *p);
+		crc_ = crc;
+		return;
+	}
+#endif
+
+	CrcTables const& t = Tables();
+	for (; length >= 8; p += 8, length -= 8)
+	{
+		std::uint32_t const lo = crc ^ (static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8 | static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24);
+		crc = t.t_[7][lo & 0xff] ^ t.t_[6][(lo >> 8) & 0xff] ^ t.t_[5][(lo >> 16) & 0xff] ^ t.t_[4][lo >> 24]
+			^ t.t_[3][p[4]] ^ t.t_[2][p[5]] ^ t.t_[1][p[6]] ^ t.t_[0][p[7]];
+	}
+	for (; length > 0; ++p, --length)
+		crc = (crc >> 8) ^ t.t_[0][(crc ^ *p) & 0xff];
+	crc_ = crc;
+}
@@ -0,0 +1,129 @@
+/** @file : Hashing.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the content hashes used to compare files.
+History : Added for the duplicate finder. SHA-256 and CRC32C added for checksum manifests.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __HASHING_GUARD__
+#define __HASHING_GUARD__
+
+#include <cstdint>
+#include <cstddef>
+
+
+// Streaming 128-bit non-cryptographic hash (the MurmurHash3 x64 128-bit construction). Wide enough that
+// two different files of the same size colliding is not a practical concern, and fast enough that a
+// full-content pass is bound by the disk rather than the hash.
+
+class Hash128
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		struct Digest
+		{
+			std::uint64_t lo_;
+			std::uint64_t hi_;
+
+			bool operator==(Digest const& d) const { return lo_ == d.lo_ && hi_ == d.hi_; }
+			bool operator!=(Digest const& d) const { return !(*this == d); }
+			bool operator<(Digest const& d) const { return hi_ != d.hi_ ? hi_ < d.hi_ : lo_ < d.lo_; }
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::uint64_t	h1_;
+		std::uint64_t	h2_;
+		std::uint64_t	length_;
+		unsigned char	tail_[16];
+		std::size_t		tailLength_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		Hash128(std::uint64_t seed = 0);
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Adds bytes to the hash. May be called any number of times with any lengths.
+
+		void Update(void const* data, std::size_t length);
+
+		 // Returns the hash of everything added so far.
+
+		Digest Final() const;
+
+	private:
+		void Block(std::uint64_t k1, std::uint64_t k2);
+};
+
+// Streaming SHA-256 (FIPS 180-4), for manifests other tools must be able to check.
+
+class Sha256
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		struct Digest
+		{
+			unsigned char bytes_[32];
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::uint32_t	state_[8];
+		std::uint64_t	length_;
+		unsigned char	tail_[64];
+		std::size_t		tailLength_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		Sha256();
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Adds bytes to the hash. May be called any number of times with any lengths.
+
+		void Update(void const* data, std::size_t length);
+
+		 // Returns the hash of everything added so far.
+
+		Digest Final() const;
+
+	private:
+		static void Block(std::uint32_t* state, unsigned char const* block);
+};
+
+// Streaming CRC-32C (the Castagnoli polynomial, as iSCSI and ext4 use it). Computed with the SSE4.2 crc32
+// instruction where the processor has it, eight bytes at a time, and with tables eight bytes at a time where
+// it does not; both give the same value.
+
+class Crc32c
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		std::uint32_t	crc_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		Crc32c() : crc_(0xffffffff) { };
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Adds bytes to the checksum. May be called any number of times with any lengths.
+
+		void Update(void const* data, std::size_t length);
+
+		 // Returns the checksum of everything added so far.
+
+		std::uint32_t Final() const { return ~crc_; }
+
+		 // True if Update runs on the crc32 instruction.
+
+		static bool IsHardware();
+};
+
+#endif
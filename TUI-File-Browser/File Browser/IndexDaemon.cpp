@@ -0,0 +1,578 @@
+/** @file : IndexDaemon.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the index daemon, which keeps a scan in memory and answers browsers' queries over a pipe.
+History : Added so several people browsing the same big volumes share one scan instead of each running their own.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "IndexDaemon.hpp"
+#include "FileBrowser.hpp"
+#include "Trigram.hpp"
+
+#include <ctime>
+#include <regex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include <Sddl.h>
+
+
+char const* const IndexProtocol::PIPE_NAME = "\\\\.\\pipe\\TUIFileBrowser-index";
+
+namespace {
+	// The pipe's buffers, and the longest message either side reads before giving up on the other.
+	DWORD const PIPE_BUFFER = 64 * 1024;
+	std::size_t const MAX_MESSAGE = 64 * 1024 * 1024;
+
+	// How long a client waits for a free instance of the pipe, and the daemon before trying to open one again.
+	DWORD const CONNECT_MS = 250;
+	DWORD const RETRY_MS = 1000;
+
+	// Who may use the pipe: the system, administrators and the daemon's owner in full, and anyone signed in to
+	// this machine to read and write, so the browsers of other users can ask it too.
+	char const* const ACCESS = "D:(A;;GA;;;SY)(A;;GA;;;BA)(A;;GA;;;OW)(A;;GRGW;;;AU)";
+
+	// How often the daemon brings its result up to date.
+	std::chrono::seconds const REFRESH_INTERVAL(60);
+
+	// A folder holding less than one in this many of the files has its matches sorted; a bigger one has them
+	// read off the version's order, which costs a pass over all the files but no sort.
+	std::size_t const SORT_SHARE = 16;
+
+	void PutNumber(std::string& out, unsigned long long n) {
+		while (n >= 0x80)
+		{
+			out.push_back(static_cast<char>((n & 0x7f) | 0x80));
+			n >>= 7;
+		}
+		out.push_back(static_cast<char>(n));
+	}
+
+	void PutSigned(std::string& out, long long n) {
+		PutNumber(out, (static_cast<unsigned long long>(n) << 1) ^ static_cast<unsigned long long>(n >> 63));
+	}
+
+	void PutString(std::string& out, std::string const& text) {
+		PutNumber(out, text.size());
+		out += text;
+	}
+
+	// Reads a message from the front; every read fails once the message runs out.
+	struct Cursor
+	{
+		char const* at_;
+		char const* end_;
+
+		Cursor(std::string const& message) : at_(message.data()), end_(message.data() + message.size()) { };
+
+		bool GetByte(unsigned char& b) {
+			if (at_ == end_)
+				return false;
+			b = static_cast<unsigned char>(*at_++);
+			return true;
+		}
+
+		bool GetNumber(unsigned long long& n) {
+			n = 0;
+			for (unsigned shift = 0; shift < 64; shift += 7)
+			{
+				unsigned char b = 0;
+				if (!GetByte(b))
+					return false;
+				n |= static_cast<unsigned long long>(b & 0x7f) << shift;
+				if (!(b & 0x80))
+					return true;
+			}
+			return false;
+		}
+
+		bool GetSigned(long long& n) {
+			unsigned long long u = 0;
+			if (!GetNumber(u))
+				return false;
+			n = static_cast<long long>(u >> 1) ^ -static_cast<long long>(u & 1);
+			return true;
+		}
+
+		bool GetString(std::string& text) {
+			unsigned long long length = 0;
+			if (!GetNumber(length) || length > static_cast<unsigned long long>(end_ - at_))
+				return false;
+			text.assign(at_, static_cast<std::size_t>(length));
+			at_ += length;
+			return true;
+		}
+	};
+
+	// Reads one whole message, which arrives in as many reads as it takes to empty it.
+	bool Receive(HANDLE pipe, std::string& message) {
+		message.clear();
+		std::vector<char> buffer(PIPE_BUFFER);
+		for (;;)
+		{
+			DWORD read = 0;
+			BOOL const ok = ReadFile(pipe, buffer.data(), static_cast<DWORD>(buffer.size()), &read, nullptr);
+			message.append(buffer.data(), read);
+			if (ok)
+				return true;
+			if (GetLastError() != ERROR_MORE_DATA || message.size() > MAX_MESSAGE)
+				return false;
+		}
+	}
+
+	bool Send(HANDLE pipe, std::string const& message) {
+		DWORD written = 0;
+		return WriteFile(pipe, message.data(), static_cast<DWORD>(message.size()), &written, nullptr) && written == message.size();
+	}
+
+	// The security attributes for ACCESS, for as long as this lives; null, for the default, if they cannot be made.
+	struct Access
+	{
+		SECURITY_ATTRIBUTES		attributes_;
+		PSECURITY_DESCRIPTOR	descriptor_;
+
+		Access() : attributes_(), descriptor_(nullptr) {
+			attributes_.nLength = sizeof(attributes_);
+			if (ConvertStringSecurityDescriptorToSecurityDescriptorA(ACCESS, SDDL_REVISION_1, &descriptor_, nullptr))
+				attributes_.lpSecurityDescriptor = descriptor_;
+		}
+
+		~Access() {
+			if (descriptor_)
+				LocalFree(descriptor_);
+		}
+
+		SECURITY_ATTRIBUTES* Get() { return descriptor_ ? &attributes_ : nullptr; }
+	};
+
+	// An instance of the daemon's pipe. Only the first may be made with first set, which is how a second daemon
+	// finds the pipe taken.
+	HANDLE OpenInstance(bool first) {
+		Access access;
+		return CreateNamedPipeA(IndexProtocol::PIPE_NAME, PIPE_ACCESS_DUPLEX | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0),
+			PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, PIPE_UNLIMITED_INSTANCES, PIPE_BUFFER, PIPE_BUFFER, 0, access.Get());
+	}
+
+	// Orders file numbers as the largest/newest leaderboards order their files: largest or newest first, ties
+	// in path order, which is the order of the numbers.
+	struct RankIds
+	{
+		std::vector<FileEntry> const&	files_;
+		bool							byTime_;
+
+		RankIds(std::vector<FileEntry> const& files, bool byTime) : files_(files), byTime_(byTime) { };
+
+		bool operator()(std::uint32_t a, std::uint32_t b) const {
+			FileEntry const& x = files_[a];
+			FileEntry const& y = files_[b];
+			if (byTime_ && x.mtime_ != y.mtime_)
+				return x.mtime_ > y.mtime_;
+			if (!byTime_ && x.size_ != y.size_)
+				return x.size_ > y.size_;
+			return a < b;
+		}
+	};
+}
+
+
+// -------- SELECTION --------
+
+// Ascending sizes and times are the ranking read backwards, so their ties come in reverse path order.
+
+std::uint32_t IndexDaemon::Selection::At(unsigned long long i) const {
+	if (!direct_)
+		return ids_[static_cast<std::size_t>(i)];
+	if (sort_ == IndexProtocol::BY_PATH)
+		return static_cast<std::uint32_t>(descending_ ? end_ - 1 - i : first_ + i);
+
+	std::vector<std::uint32_t> const& order = sort_ == IndexProtocol::BY_SIZE ? version_->bySize_ : version_->byTime_;
+	return order[static_cast<std::size_t>(descending_ ? i : order.size() - 1 - i)];
+}
+
+// -------- CONSTRUCTOR --------
+
+IndexDaemon::IndexDaemon(std::string const& folder, std::string const& filter, unsigned processes) : folder_(folder), filter_(filter), processes_(processes), published_(0) {
+}
+
+// -------- OPERATIONS --------
+
+// The pipe is taken before the first scan, so clients that come while it runs are told to scan for themselves
+// rather than left waiting. The model refreshed is the daemon's own; a version gets a copy of it, made only when
+// a refresh changed the files, which is when it builds a new name index.
+
+int IndexDaemon::Run() {
+	std::regex r;
+	try
+	{
+		r = std::regex(filter_);
+	}
+	catch (std::regex_error const&)
+	{
+		std::cerr << "Not a valid filter: " << filter_ << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	HANDLE const first = OpenInstance(true);
+	if (first == INVALID_HANDLE_VALUE)
+	{
+		std::cerr << "Another index daemon is running." << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::thread(&IndexDaemon::Listen, this, first).detach();
+
+	FileModel model(folder_, filter_, true);
+	model.SetUseIndex(false);
+	model.SetProcesses(processes_);
+
+	std::cerr << "Scanning " << folder_ << std::endl;
+	model.Scan(std::tr2::sys::path(folder_), r, true);
+	Publish(std::make_shared<FileModel const>(model));
+	std::cerr << model.GetMatchedFiles() << " files indexed; " << model.GetStatus() << std::endl;
+
+	for (;;)
+	{
+		std::this_thread::sleep_for(REFRESH_INTERVAL);
+
+		auto const names = model.GetNameIndex();
+		if (model.Refresh() && model.GetNameIndex() != names)
+		{
+			Publish(std::make_shared<FileModel const>(model));
+			std::cerr << model.GetStatus() << std::endl;
+		}
+	}
+}
+
+// The two orders are sorted at once, each on its own thread. Each extension is numbered as it is first met.
+
+void IndexDaemon::Publish(std::shared_ptr<FileModel const> const& model) {
+	auto version = std::make_shared<Version>();
+	version->model_ = model;
+	version->names_ = model->GetNameIndex();
+
+	std::vector<FileEntry> const& files = model->GetFiles();
+	std::unordered_map<std::string, std::uint32_t> numbers;
+	version->extension_.resize(files.size());
+	for (std::size_t i = 0; i < files.size(); ++i)
+	{
+		std::string const ext = std::tr2::sys::path(files[i].path_).extension();
+		auto added = numbers.emplace(ext, static_cast<std::uint32_t>(numbers.size()));
+		if (added.second)
+			version->extensions_.push_back(ext);
+		version->extension_[i] = added.first->second;
+	}
+
+	version->bySize_.resize(files.size());
+	std::iota(version->bySize_.begin(), version->bySize_.end(), 0u);
+	version->byTime_ = version->bySize_;
+	std::thread byTime([&] { std::sort(version->byTime_.begin(), version->byTime_.end(), RankIds(files, true)); });
+	std::sort(version->bySize_.begin(), version->bySize_.end(), RankIds(files, false));
+	byTime.join();
+
+	version->number_ = ++published_;
+	version->builtAt_ = static_cast<long long>(std::time(nullptr));
+	std::atomic_store(&version_, version);
+
+	if (!segment_.IsOpen() || !segment_.Publish(files, folder_, filter_, model->GetSearchedFiles()))
+		std::cerr << "Could not publish the shared segment; browsers will ask for their rows instead." << std::endl;
+}
+
+void IndexDaemon::Listen(HANDLE first) {
+	HANDLE pipe = first;
+	for (;;)
+	{
+		if (pipe == INVALID_HANDLE_VALUE)
+		{
+			Sleep(RETRY_MS);
+			pipe = OpenInstance(false);
+			continue;
+		}
+
+		if (ConnectNamedPipe(pipe, nullptr) || GetLastError() == ERROR_PIPE_CONNECTED)
+			std::thread(&IndexDaemon::Serve, this, pipe).detach();
+		else
+			CloseHandle(pipe);
+		pipe = OpenInstance(false);
+	}
+}
+
+void IndexDaemon::Serve(HANDLE pipe) {
+	Selection selection;
+	std::string request;
+	while (Receive(pipe, request) && Send(pipe, Answer(request, selection)))
+		;
+
+	DisconnectNamedPipe(pipe);
+	CloseHandle(pipe);
+}
+
+// A reply starts with its status, and carries nothing else unless the status is OK.
+
+std::string IndexDaemon::Answer(std::string const& request, Selection& selection) {
+	using namespace IndexProtocol;
+	auto fail = [](Reply reply) { return std::string(1, static_cast<char>(reply)); };
+
+	Cursor in(request);
+	unsigned char op = 0, sort = BY_PATH, descending = 0;
+	std::string folder, filter, name;
+	unsigned long long offset = 0, count = 0;
+	if (!in.GetByte(op) || (op != QUERY && op != STATS) || !in.GetString(folder) || !in.GetString(filter))
+		return fail(BAD_QUERY);
+	if (op == QUERY && (!in.GetString(name) || !in.GetByte(sort) || sort > BY_TIME || !in.GetByte(descending) || !in.GetNumber(offset) || !in.GetNumber(count)))
+		return fail(BAD_QUERY);
+
+	std::shared_ptr<Version> const version = std::atomic_load(&version_);
+	if (!version)
+		return fail(NOT_READY);
+
+	Reply const status = Select(version, folder, filter, name, static_cast<Sort>(sort), descending != 0, selection);
+	if (status != OK)
+		return fail(status);
+
+	FileModel const& model = *version->model_;
+	std::string reply(1, static_cast<char>(OK));
+	if (op == STATS)
+	{
+		PutString(reply, folder_);
+		PutString(reply, filter_);
+		PutNumber(reply, model.GetFiles().size());
+		PutNumber(reply, selection.total_);
+		PutNumber(reply, selection.bytes_);
+		PutNumber(reply, version->number_);
+		PutSigned(reply, version->builtAt_);
+		return reply;
+	}
+
+	unsigned long long const from = std::min(offset, selection.total_);
+	unsigned long long const rows = std::min(std::min(count, static_cast<unsigned long long>(MAX_ROWS)), selection.total_ - from);
+	PutNumber(reply, selection.total_);
+	PutNumber(reply, selection.bytes_);
+	PutNumber(reply, model.GetSearchedFiles());
+	PutNumber(reply, rows);
+
+	std::vector<FileEntry> const& files = model.GetFiles();
+	std::string const* previous = nullptr;
+	for (unsigned long long i = 0; i < rows; ++i)
+	{
+		FileEntry const& f = files[selection.At(from + i)];
+		std::size_t shared = 0;
+		if (previous)
+			shared = std::mismatch(f.path_.begin(), f.path_.begin() + std::min(f.path_.size(), previous->size()), previous->begin()).first - f.path_.begin();
+
+		PutNumber(reply, shared);
+		PutNumber(reply, f.path_.size() - shared);
+		reply.append(f.path_, shared, std::string::npos);
+		PutNumber(reply, f.size_);
+		PutSigned(reply, f.mtime_);
+		previous = &f.path_;
+	}
+	return reply;
+}
+
+// The folder's files are a range of the version's, found in its folder tree. A query that keeps every file of
+// the range needs nothing worked out when it is in path order, or when the range is every file; its size is
+// the folder's, from the tree.
+
+IndexProtocol::Reply IndexDaemon::Select(std::shared_ptr<Version> const& version, std::string const& folder, std::string const& filter, std::string const& name, IndexProtocol::Sort sort, bool descending, Selection& selection) {
+	using namespace IndexProtocol;
+
+	std::string const key = folder + '\n' + filter + '\n' + name + '\n' + static_cast<char>('0' + sort) + (descending ? '-' : '+');
+	if (selection.version_ == version && selection.key_ == key)
+		return OK;
+
+	FileModel const& model = *version->model_;
+	std::vector<FileEntry> const& files = model.GetFiles();
+	Selection s;
+	s.version_ = version;
+	s.key_ = key;
+	s.sort_ = sort;
+	s.descending_ = descending;
+
+	unsigned long long folderBytes = 0;
+	if (!model.FindRange(folder, s.first_, s.end_, folderBytes))
+		return NOT_COVERED;
+
+	// Which extensions pass the filter. With the daemon's own filter, every file it kept does; any other can
+	// only be answered by a daemon that kept every file, and is tried once on each extension.
+	std::vector<char> pass(version->extensions_.size(), 1);
+	bool every = filter == filter_;
+	if (!every)
+	{
+		if (filter_ != ".*")
+			return NOT_COVERED;
+
+		std::regex r;
+		try
+		{
+			r = std::regex(filter);
+		}
+		catch (std::regex_error const&)
+		{
+			return BAD_QUERY;
+		}
+		every = true;
+		for (std::size_t e = 0; e < pass.size(); ++e)
+		{
+			pass[e] = std::regex_match(version->extensions_[e], r) ? 1 : 0;
+			every = every && pass[e];
+		}
+	}
+
+	if (every && name.empty() && (sort == BY_PATH || (s.first_ == 0 && s.end_ == files.size())))
+	{
+		s.direct_ = true;
+		s.total_ = s.end_ - s.first_;
+		s.bytes_ = folderBytes;
+		selection = std::move(s);
+		return OK;
+	}
+
+	auto matches = [&](std::uint32_t id) { return id >= s.first_ && id < s.end_ && pass[version->extension_[id]]; };
+	RankIds const rank(files, sort == BY_TIME);
+	if (!name.empty())
+	{
+		std::vector<std::uint32_t> hits;
+		if (version->names_)
+		{
+			std::lock_guard<std::mutex> lk(version->namesLock_);
+			hits = version->names_->Find(name);
+		}
+		for (auto id : hits)
+			if (matches(id))
+				s.ids_.push_back(id);
+		if (sort != BY_PATH)
+			std::sort(s.ids_.begin(), s.ids_.end(), rank);
+	}
+	else if (sort == BY_PATH || (s.end_ - s.first_) * SORT_SHARE < files.size())
+	{
+		for (std::size_t id = s.first_; id < s.end_; ++id)
+			if (pass[version->extension_[id]])
+				s.ids_.push_back(static_cast<std::uint32_t>(id));
+		if (sort != BY_PATH)
+			std::sort(s.ids_.begin(), s.ids_.end(), rank);
+	}
+	else
+	{
+		for (auto id : sort == BY_SIZE ? version->bySize_ : version->byTime_)
+			if (matches(id))
+				s.ids_.push_back(id);
+	}
+
+	if (sort == BY_PATH ? descending : !descending)
+		std::reverse(s.ids_.begin(), s.ids_.end());
+
+	s.total_ = s.ids_.size();
+	for (auto id : s.ids_)
+		s.bytes_ += files[id].size_;
+	selection = std::move(s);
+	return OK;
+}
+
+// -------- CLIENT --------
+
+IndexClient::IndexClient() : pipe_(INVALID_HANDLE_VALUE), pageAt_(0) {
+}
+
+IndexClient::~IndexClient() {
+	if (pipe_ != INVALID_HANDLE_VALUE)
+		CloseHandle(pipe_);
+}
+
+// With every instance busy, the daemon opens another as soon as it hands one on, so it is waited for briefly.
+
+bool IndexClient::Connect() {
+	for (int attempt = 0; attempt < 2 && pipe_ == INVALID_HANDLE_VALUE; ++attempt)
+	{
+		pipe_ = CreateFileA(IndexProtocol::PIPE_NAME, GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+		if (pipe_ == INVALID_HANDLE_VALUE && (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeA(IndexProtocol::PIPE_NAME, CONNECT_MS)))
+			return false;
+	}
+	if (pipe_ == INVALID_HANDLE_VALUE)
+		return false;
+
+	DWORD mode = PIPE_READMODE_MESSAGE;
+	return SetNamedPipeHandleState(pipe_, &mode, nullptr, nullptr) != FALSE;
+}
+
+bool IndexClient::Run(Query const& query, Result& result) const {
+	std::string request(1, static_cast<char>(IndexProtocol::QUERY));
+	PutString(request, query.folder_);
+	PutString(request, query.filter_);
+	PutString(request, query.name_);
+	request.push_back(static_cast<char>(query.sort_));
+	request.push_back(query.descending_ ? 1 : 0);
+	PutNumber(request, query.offset_);
+	PutNumber(request, query.count_);
+
+	std::string reply;
+	if (!Call(request, reply))
+		return false;
+
+	Cursor in(reply);
+	unsigned char status = 0;
+	unsigned long long rows = 0;
+	if (!in.GetByte(status) || status != IndexProtocol::OK || !in.GetNumber(result.total_) || !in.GetNumber(result.bytes_) || !in.GetNumber(result.searched_)
+		|| !in.GetNumber(rows) || rows > IndexProtocol::MAX_ROWS)
+		return false;
+
+	result.rows_.clear();
+	result.rows_.reserve(static_cast<std::size_t>(rows));
+	std::string path, rest;
+	for (unsigned long long i = 0; i < rows; ++i)
+	{
+		unsigned long long shared = 0;
+		FileEntry f;
+		if (!in.GetNumber(shared) || shared > path.size() || !in.GetString(rest) || !in.GetNumber(f.size_) || !in.GetSigned(f.mtime_))
+			return false;
+		path.resize(static_cast<std::size_t>(shared));
+		path += rest;
+		f.path_ = path;
+		result.rows_.push_back(f);
+	}
+	return true;
+}
+
+bool IndexClient::GetStats(std::string const& folder, std::string const& filter, Stats& stats) const {
+	std::string request(1, static_cast<char>(IndexProtocol::STATS));
+	PutString(request, folder);
+	PutString(request, filter);
+
+	std::string reply;
+	if (!Call(request, reply))
+		return false;
+
+	Cursor in(reply);
+	unsigned char status = 0;
+	return in.GetByte(status) && status == IndexProtocol::OK && in.GetString(stats.roots_) && in.GetString(stats.filter_) && in.GetNumber(stats.files_)
+		&& in.GetNumber(stats.matched_) && in.GetNumber(stats.bytes_) && in.GetNumber(stats.version_) && in.GetSigned(stats.builtAt_);
+}
+
+void IndexClient::Browse(Query const& query, Result const& result) {
+	browsing_ = query;
+	page_ = result.rows_;
+	pageAt_ = query.offset_;
+}
+
+FileEntry const& IndexClient::Get(unsigned long long i) const {
+	if (i < pageAt_ || i - pageAt_ >= page_.size())
+	{
+		Query query = browsing_;
+		query.offset_ = i - i % PAGE_ROWS;
+		query.count_ = PAGE_ROWS;
+
+		Result result;
+		page_.clear();
+		pageAt_ = query.offset_;
+		if (Run(query, result))
+			page_.swap(result.rows_);
+	}
+	return i - pageAt_ < page_.size() ? page_[static_cast<std::size_t>(i - pageAt_)] : missing_;
+}
+
+bool IndexClient::Call(std::string const& request, std::string& reply) const {
+	return pipe_ != INVALID_HANDLE_VALUE && Send(pipe_, request) && Receive(pipe_, reply);
+}
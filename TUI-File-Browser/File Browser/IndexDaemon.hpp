@@ -0,0 +1,270 @@
+/** @file : IndexDaemon.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the index daemon, which keeps a scan in memory and answers browsers' queries over a pipe.
+History : Added so several people browsing the same big volumes share one scan instead of each running their own.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __INDEX_DAEMON_GUARD__
+#define __INDEX_DAEMON_GUARD__
+
+#include "ScanEngine.hpp"
+#include "Segment.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <Windows.h>
+
+class FileModel;
+class TrigramIndex;
+
+
+// The messages the daemon and its clients exchange over the pipe. Each request and each reply is one pipe
+// message. Numbers are sent seven bits to a byte, low bits first, with the top bit set on every byte but the
+// last, so the counts and sizes that make up most of a reply take a byte or two each; a time, which may be
+// negative, is first folded so that small magnitudes stay small. A string is its length and then its bytes.
+//
+// A query names a folder and a filter, as a scan does, and optionally part of a file name; a sort, a direction,
+// and the rows wanted, as an offset and a count. The reply carries the number of files that matched, their
+// size, and the rows asked for: each path is sent as the length it shares with the path before it and the rest
+// of it, which for files of the same folder is most of it.
+
+namespace IndexProtocol
+{
+	// The daemon's pipe, local to the machine.
+	extern char const* const PIPE_NAME;
+
+	// Rows one reply may carry.
+	unsigned const MAX_ROWS = 4096;
+
+	enum Request : unsigned char
+	{
+		QUERY,		// folder, filter, name, sort, descending, offset, count
+		STATS		// folder, filter
+	};
+
+	enum Reply : unsigned char
+	{
+		OK,
+		NOT_READY,		// the daemon's first scan is still running
+		NOT_COVERED,	// the folder is not under the daemon's roots, or its filter is narrower
+		BAD_QUERY		// the request could not be read, or its filter is not a valid expression
+	};
+
+	enum Sort : unsigned char
+	{
+		BY_PATH,
+		BY_SIZE,
+		BY_TIME
+	};
+}
+
+
+// The daemon: scans its roots recursively once, then keeps the result in memory and brings it up to date every
+// REFRESH_INTERVAL with FileModel::Refresh, which lists again only the folders whose stamp moved. Each result is
+// published as a read-only version with what queries need built over it: the files ordered by size and by time,
+// and each file's extension as a number, so a filter is matched once per extension rather than once per file.
+// A query takes the version published when it starts, so a refresh never changes a result under it. Each version
+// is also published as a shared segment, which a browser showing the file listing maps instead of asking for pages.
+//
+// A folder's files sit next to each other in path order, so a query of the file listing in path order reads its
+// rows straight off the version. Other queries work out the files they match, in the order asked for, once, and
+// the connection keeps them, so the next page of the same query costs only its rows.
+
+class IndexDaemon
+{
+	// -------- DEPENDENCY CLASSES --------
+	private:
+		// One published result and what is built over it for queries.
+		struct Version
+		{
+			std::shared_ptr<FileModel const>	model_;
+			std::shared_ptr<TrigramIndex>		names_;
+			std::mutex							namesLock_;		// Find keeps statistics
+			std::vector<std::uint32_t>			bySize_;		// largest first, and newest first; ties in path order
+			std::vector<std::uint32_t>			byTime_;
+			std::vector<std::uint32_t>			extension_;		// of each file, in extensions_
+			std::vector<std::string>			extensions_;
+			unsigned long long					number_;
+			long long							builtAt_;
+		};
+
+		// The files one query matched, in the order it asked for, kept for its connection. When direct_ is set,
+		// a range of the version's files or one of its orders stands for them, and ids_ is empty.
+		struct Selection
+		{
+			std::shared_ptr<Version>		version_;
+			std::string						key_;
+			std::vector<std::uint32_t>		ids_;
+			bool							direct_;
+			std::size_t						first_;
+			std::size_t						end_;
+			IndexProtocol::Sort				sort_;
+			bool							descending_;
+			unsigned long long				total_;
+			unsigned long long				bytes_;
+
+			Selection() : direct_(false), first_(0), end_(0), sort_(IndexProtocol::BY_PATH), descending_(false), total_(0), bytes_(0) { };
+
+			 // Number in the version's files of match i.
+
+			std::uint32_t At(unsigned long long i) const;
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::string		folder_;
+		std::string		filter_;
+		unsigned		processes_;
+
+		std::shared_ptr<Version>	version_;	// read and replaced with the atomic shared_ptr functions
+		unsigned long long			published_;
+		SegmentWriter				segment_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Sets up a daemon for folder, which may be several separated by ';', keeping the files whose extension
+		 // matches filter. With processes set, its scans are spread over that many worker processes.
+
+		IndexDaemon(std::string const& folder, std::string const& filter, unsigned processes = 0);
+
+		IndexDaemon(IndexDaemon const&) = delete;
+		void operator=(IndexDaemon const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Scans the roots, then answers queries until the process is stopped, refreshing the result as it goes.
+		 // Returns the process's exit code if it cannot start: another daemon holds the pipe, or the filter is
+		 // not a valid expression.
+
+		int Run();
+
+	private:
+
+		 // Builds the version of model and makes it the one new queries read, then publishes it as a segment.
+
+		void Publish(std::shared_ptr<FileModel const> const& model);
+
+		 // Waits for clients on the pipe, starting with the instance first, and serves each on its own thread.
+
+		void Listen(HANDLE first);
+
+		 // Answers the requests of one client until it goes away.
+
+		void Serve(HANDLE pipe);
+
+		 // The reply to request; selection is the connection's last query, which it reuses or replaces.
+
+		std::string Answer(std::string const& request, Selection& selection);
+
+		 // Works out the files of folder whose extension matches filter and, if name is given, whose name holds
+		 // it, in the order asked for. Returns the reply to send if they cannot be worked out, or OK.
+
+		IndexProtocol::Reply Select(std::shared_ptr<Version> const& version, std::string const& folder, std::string const& filter, std::string const& name, IndexProtocol::Sort sort, bool descending, Selection& selection);
+};
+
+
+// A browser's connection to the daemon. A query's reply is read a page at a time as rows are asked for, so
+// the viewer holds a page of the listing however many files match.
+
+class IndexClient
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// Rows asked for at a time while browsing.
+		static unsigned const PAGE_ROWS = 256;
+
+		struct Query
+		{
+			std::string				folder_;
+			std::string				filter_;
+			std::string				name_;
+			IndexProtocol::Sort		sort_;
+			bool					descending_;
+			unsigned long long		offset_;
+			unsigned				count_;
+
+			Query() : sort_(IndexProtocol::BY_PATH), descending_(false), offset_(0), count_(PAGE_ROWS) { };
+		};
+
+		struct Result
+		{
+			unsigned long long		total_;		// files that matched
+			unsigned long long		bytes_;
+			unsigned long long		searched_;	// entries the daemon's scan looked at
+			std::vector<FileEntry>	rows_;		// from the query's offset
+
+			Result() : total_(0), bytes_(0), searched_(0) { };
+		};
+
+		struct Stats
+		{
+			std::string				roots_;
+			std::string				filter_;
+			unsigned long long		files_;		// in the daemon's result, and under the folder asked about
+			unsigned long long		matched_;
+			unsigned long long		bytes_;
+			unsigned long long		version_;
+			long long				builtAt_;
+
+			Stats() : files_(0), matched_(0), bytes_(0), version_(0), builtAt_(0) { };
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		HANDLE		pipe_;
+
+		// The query being browsed, and the page of it last read.
+		Query								browsing_;
+		mutable std::vector<FileEntry>		page_;
+		mutable unsigned long long			pageAt_;
+		FileEntry							missing_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+		IndexClient();
+		~IndexClient();
+
+		IndexClient(IndexClient const&) = delete;
+		void operator=(IndexClient const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Connects to the daemon. Returns false at once if none is running.
+
+		bool Connect();
+
+		 // Sends query and reads its reply into result. Returns false if the daemon is gone or does not cover
+		 // the query, in which case the browser scans for itself.
+
+		bool Run(Query const& query, Result& result) const;
+
+		 // What the daemon holds, and how much of it is under folder with filter. Returns false as Run does.
+
+		bool GetStats(std::string const& folder, std::string const& filter, Stats& stats) const;
+
+		 // Browses query, of which result is the reply to its first page.
+
+		void Browse(Query const& query, Result const& result);
+
+		 // Row i of the query browsed, read with its page if it is not the page last read. An empty entry if the
+		 // daemon has gone away since.
+
+		FileEntry const& Get(unsigned long long i) const;
+
+	private:
+
+		 // Sends request and waits for the reply. Returns false if the pipe is broken.
+
+		bool Call(std::string const& request, std::string& reply) const;
+};
+
+#endif
@@ -0,0 +1,561 @@
+/** @file : LineIndex.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the sparse line index and the text pager built on it.
+History : Added so the text viewer can jump to any line of a very large file without reading it from the start.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "LineIndex.hpp"
+#include "Hashing.hpp"
+
+#include <cstring>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define LINE_INDEX_SSE2
+#endif
+
+
+namespace {
+	// Identifies a saved index, and the layout it was saved with.
+	char const MAGIC[4] = { 'T', 'L', 'I', 'X' };
+	unsigned const VERSION = 1;
+
+	// Bytes read at a time by the pager.
+	std::size_t const BLOCK = 64 * 1024;
+
+	// Longest stretch the pager reads looking for the ends of the lines on one page.
+	std::size_t const PAGE_LIMIT = 1024 * 1024;
+
+	// Counts lines in a mapped chunk. A mapped page that cannot be read raises an in-page error rather than
+	// failing a read, so it is caught here and the build stops.
+	bool CountMapped(char const* data, std::size_t length, unsigned long long base, unsigned long long& lines, std::vector<unsigned long long>& marks) {
+#ifdef _MSC_VER
+		__try
+		{
+			LineIndex::CountLines(data, length, base, lines, marks);
+		}
+		__except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+		{
+			return false;
+		}
+#else
+		LineIndex::CountLines(data, length, base, lines, marks);
+#endif
+		return true;
+	}
+
+	// Formats a count with thousands separators, which makes big line numbers readable at a glance.
+	std::string Group(unsigned long long n) {
+		std::string digits = std::to_string(n);
+		for (int i = static_cast<int>(digits.size()) - 3; i > 0; i -= 3)
+			digits.insert(i, ",");
+		return digits;
+	}
+}
+
+
+// -------- LINE INDEX --------
+
+LineIndex::LineIndex(std::string const& path) : path_(path), size_(0), mtime_(0), indexed_(0), lines_(0), complete_(false), stop_(false), loaded_(false) {
+	marks_.push_back(0);
+
+	WIN32_FILE_ATTRIBUTE_DATA info;
+	if (GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &info))
+	{
+		size_ = (static_cast<unsigned long long>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+		mtime_ = static_cast<long long>((static_cast<unsigned long long>(info.ftLastWriteTime.dwHighDateTime) << 32) | info.ftLastWriteTime.dwLowDateTime);
+	}
+
+	if (size_ == 0)
+		complete_ = true;
+	else if (Load())
+		loaded_ = true;
+	else
+		worker_ = std::thread(&LineIndex::Build, this);
+}
+LineIndex::~LineIndex() {
+	stop_ = true;
+	if (worker_.joinable())
+		worker_.join();
+}
+
+// -------- OPERATIONS --------
+
+// Any recorded line is a good start, even one near the end of the part indexed so far, since the caller reads
+// forward from it. Past the last recorded line of an unfinished index, the offset is extrapolated from the
+// average line length seen so far.
+
+bool LineIndex::FindLine(unsigned long long line, unsigned long long& offset, unsigned long long& atLine) const {
+	std::lock_guard<std::mutex> lk(lock_);
+
+	std::size_t mark = static_cast<std::size_t>(line / STRIDE);
+	if (mark < marks_.size() || complete_)
+	{
+		mark = std::min(mark, marks_.size() - 1);
+		offset = marks_[mark];
+		atLine = static_cast<unsigned long long>(mark) * STRIDE;
+		return true;
+	}
+
+	unsigned long long const lines = std::max<unsigned long long>(lines_, 1);
+	double const perLine = static_cast<double>(indexed_) / lines;
+	offset = std::min(size_, indexed_ + static_cast<unsigned long long>((line - lines) * perLine));
+	atLine = line;
+	return false;
+}
+
+bool LineIndex::FindOffset(unsigned long long offset, unsigned long long& atOffset, unsigned long long& atLine) const {
+	std::lock_guard<std::mutex> lk(lock_);
+
+	if (offset < indexed_ || complete_)
+	{
+		std::size_t mark = std::upper_bound(marks_.begin(), marks_.end(), offset) - marks_.begin() - 1;
+		atOffset = marks_[mark];
+		atLine = static_cast<unsigned long long>(mark) * STRIDE;
+		return true;
+	}
+
+	unsigned long long const indexed = std::max<unsigned long long>(indexed_, 1);
+	atOffset = offset;
+	atLine = lines_ + static_cast<unsigned long long>((offset - indexed_) * (static_cast<double>(lines_) / indexed));
+	return false;
+}
+
+// With SSE2, newlines are counted 16 bytes at a time: each compare yields 0xff per newline, and subtracting
+// that from a byte accumulator adds one per lane. Up to 255 blocks are summed before the lanes can overflow,
+// then folded with a sum of absolute differences. Only a run of blocks that crosses the next STRIDE-th line
+// is walked byte by byte to find where that line starts. The tail, and builds without SSE2, use memchr.
+
+void LineIndex::CountLines(char const* data, std::size_t length, unsigned long long base, unsigned long long& lines, std::vector<unsigned long long>& marks) {
+	std::size_t i = 0;
+
+	auto walk = [&](std::size_t end) {
+		while (i < end)
+		{
+			char const* nl = static_cast<char const*>(memchr(data + i, '\n', end - i));
+			if (!nl)
+			{
+				i = end;
+				break;
+			}
+
+			i = nl - data + 1;
+			if (++lines % STRIDE == 0)
+				marks.push_back(base + i);
+		}
+	};
+
+#ifdef LINE_INDEX_SSE2
+	__m128i const newline = _mm_set1_epi8('\n');
+	__m128i const zero = _mm_setzero_si128();
+
+	while (length - i >= 16)
+	{
+		std::size_t const blocks = std::min<std::size_t>((length - i) / 16, 255);
+
+		__m128i sum = zero;
+		for (std::size_t b = 0; b < blocks; ++b)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i + b * 16));
+			sum = _mm_sub_epi8(sum, _mm_cmpeq_epi8(v, newline));
+		}
+
+		__m128i folded = _mm_sad_epu8(sum, zero);
+		unsigned long long const count = static_cast<unsigned>(_mm_cvtsi128_si32(folded)) + static_cast<unsigned>(_mm_cvtsi128_si32(_mm_srli_si128(folded, 8)));
+
+		// Next line number that needs recording.
+		unsigned long long const next = (lines / STRIDE + 1) * STRIDE;
+		if (lines + count < next)
+		{
+			lines += count;
+			i += blocks * 16;
+		}
+		else
+			walk(i + blocks * 16);
+	}
+#endif
+
+	walk(length);
+}
+
+// Maps the file a chunk at a time. After each chunk the new line starts are published under the lock and the
+// progress counters are moved on, so lookups see the index grow. A build that is stopped, or that hits a page
+// it cannot read, is not saved.
+
+void LineIndex::Build() {
+	MappedFile file(path_);
+	unsigned long long lines = 0;
+	bool endsWithNewline = true;
+	std::vector<unsigned long long> marks;
+
+	for (unsigned long long offset = 0; offset < size_; offset += CHUNK)
+	{
+		if (stop_)
+			return;
+
+		std::size_t const length = static_cast<std::size_t>(std::min<unsigned long long>(CHUNK, size_ - offset));
+		char const* data = file.Map(offset, length);
+		if (!data)
+			return;
+
+		marks.clear();
+		if (!CountMapped(data, length, offset, lines, marks))
+			return;
+
+		endsWithNewline = data[length - 1] == '\n';
+
+		std::lock_guard<std::mutex> lk(lock_);
+		marks_.insert(marks_.end(), marks.begin(), marks.end());
+		lines_ = lines;
+		indexed_ = offset + length;
+	}
+
+	// A last line without a newline is still a line.
+	if (!endsWithNewline)
+		lines_ = lines + 1;
+
+	complete_ = true;
+	Save();
+}
+
+// Named after a hash of the file's path, so each file has one saved index.
+
+std::string LineIndex::GetCachePath() const {
+	std::string folder = GetCacheFolder();
+	if (folder.empty())
+		return folder;
+
+	Hash128 hash;
+	hash.Update(path_.data(), path_.size());
+	Hash128::Digest d = hash.Final();
+
+	std::ostringstream name;
+	name << std::hex << std::setfill('0') << std::setw(16) << static_cast<unsigned long long>(d.hi_) << std::setw(16) << static_cast<unsigned long long>(d.lo_);
+	return folder + name.str() + ".lines";
+}
+
+// Only an index saved with the same layout, for a file of the same size and last write time, is used.
+
+bool LineIndex::Load() {
+	std::string cache = GetCachePath();
+	if (cache.empty())
+		return false;
+
+	std::ifstream in(cache, std::ios::binary);
+	char magic[4];
+	unsigned version = 0, stride = 0;
+	unsigned long long size = 0, lines = 0, count = 0;
+	long long mtime = 0;
+
+	in.read(magic, sizeof(magic));
+	in.read(reinterpret_cast<char*>(&version), sizeof(version));
+	in.read(reinterpret_cast<char*>(&stride), sizeof(stride));
+	in.read(reinterpret_cast<char*>(&size), sizeof(size));
+	in.read(reinterpret_cast<char*>(&mtime), sizeof(mtime));
+	in.read(reinterpret_cast<char*>(&lines), sizeof(lines));
+	in.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+	if (!in || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION || stride != STRIDE || size != size_ || mtime != mtime_)
+		return false;
+	if (count == 0 || count > lines / STRIDE + 1)
+		return false;
+
+	std::vector<unsigned long long> marks(static_cast<std::size_t>(count));
+	in.read(reinterpret_cast<char*>(marks.data()), marks.size() * sizeof(unsigned long long));
+	if (!in || marks[0] != 0)
+		return false;
+
+	std::lock_guard<std::mutex> lk(lock_);
+	marks_.swap(marks);
+	lines_ = lines;
+	indexed_ = size_;
+	complete_ = true;
+	return true;
+}
+
+// Written to a temporary file first and moved into place, so a reader never sees half an index.
+
+void LineIndex::Save() const {
+	std::string cache = GetCachePath();
+	if (cache.empty())
+		return;
+
+	std::string temp = cache + ".tmp";
+	{
+		std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+		unsigned const stride = STRIDE;
+		unsigned long long const size = size_, lines = lines_, count = marks_.size();
+
+		out.write(MAGIC, sizeof(MAGIC));
+		out.write(reinterpret_cast<char const*>(&VERSION), sizeof(VERSION));
+		out.write(reinterpret_cast<char const*>(&stride), sizeof(stride));
+		out.write(reinterpret_cast<char const*>(&size), sizeof(size));
+		out.write(reinterpret_cast<char const*>(&mtime_), sizeof(mtime_));
+		out.write(reinterpret_cast<char const*>(&lines), sizeof(lines));
+		out.write(reinterpret_cast<char const*>(&count), sizeof(count));
+		out.write(reinterpret_cast<char const*>(marks_.data()), marks_.size() * sizeof(unsigned long long));
+
+		if (!out)
+			return;
+	}
+
+	MoveFileExA(temp.c_str(), cache.c_str(), MOVEFILE_REPLACE_EXISTING);
+}
+
+
+// -------- TEXT PAGER --------
+
+TextPager::TextPager(std::string const& path) : file_(path, false), index_(path), top_(0), topLine_(0), exact_(true), pendingLine_(0), pending_(false) {
+}
+
+// Reads forward from the top of the window a block at a time, cutting each line at width. Lines longer than
+// the pane are still read to their end, up to PAGE_LIMIT bytes for the whole page.
+
+std::vector<std::string> TextPager::Page(std::size_t width, std::size_t rows) {
+	std::vector<std::string> lines;
+	std::string line;
+	std::vector<char> buf(BLOCK);
+
+	unsigned long long offset = top_;
+	while (lines.size() < rows && offset - top_ < PAGE_LIMIT)
+	{
+		std::size_t got = file_.ReadAt(offset, buf.data(), buf.size());
+		if (got == 0)
+			break;
+
+		for (std::size_t i = 0; i < got && lines.size() < rows; ++i)
+		{
+			unsigned char c = static_cast<unsigned char>(buf[i]);
+			if (c == '\n')
+			{
+				lines.push_back(line);
+				line.clear();
+			}
+			else if (line.size() >= width || c == '\r')
+				continue;
+			else if (c == '\t')
+				line.append(4 - line.size() % 4, ' ');
+			else
+				line += isprint(c) ? static_cast<char>(c) : '.';
+		}
+		offset += got;
+	}
+
+	if (!line.empty() && lines.size() < rows)
+		lines.push_back(line);
+
+	for (auto& l : lines)
+		if (l.size() > width)
+			l.resize(width);
+
+	return lines;
+}
+
+void TextPager::Down(unsigned long long n) {
+	unsigned long long skipped = 0;
+	top_ = SkipForward(top_, n, skipped);
+	topLine_ += skipped;
+	pending_ = false;
+}
+
+void TextPager::Up(unsigned long long n) {
+	unsigned long long skipped = 0;
+	top_ = SkipBack(top_, n, skipped);
+	topLine_ = topLine_ > skipped ? topLine_ - skipped : 0;
+	pending_ = false;
+
+	if (top_ == 0)
+	{
+		topLine_ = 0;
+		exact_ = true;
+	}
+}
+
+// Starts from the nearest recorded line and reads forward the rest of the way. When the index has not reached
+// the line yet, the window moves to the estimated offset straight away and the jump is remembered so Refine
+// can redo it exactly later.
+
+void TextPager::GoToLine(unsigned long long line) {
+	line = line ? line - 1 : 0;
+
+	unsigned long long offset = 0, atLine = 0, skipped = 0;
+	if (index_.FindLine(line, offset, atLine))
+	{
+		top_ = SkipForward(offset, line - atLine, skipped);
+		topLine_ = atLine + skipped;
+		exact_ = true;
+		pending_ = false;
+		return;
+	}
+
+	// Move to the start of the line the estimate falls in.
+	top_ = offset ? SkipForward(offset - 1, 1, skipped) : 0;
+	topLine_ = line;
+	exact_ = false;
+	pendingLine_ = line;
+	pending_ = true;
+}
+
+void TextPager::GoToPercent(double percent) {
+	unsigned long long const size = index_.GetSize();
+	unsigned long long offset = static_cast<unsigned long long>(size * std::max(0.0, std::min(percent, 100.0)) / 100);
+	unsigned long long skipped = 0;
+
+	if (offset >= size)
+		offset = size ? size - 1 : 0;
+
+	top_ = offset ? SkipForward(offset - 1, 1, skipped) : 0;
+
+	// Near the end there may be no line start after the offset; use the start of the line it is in.
+	if (offset && skipped == 0)
+		top_ = SkipBack(offset, 0, skipped);
+
+	pending_ = false;
+	LocateTop();
+}
+
+bool TextPager::Refine() {
+	unsigned long long offset = 0, atLine = 0;
+
+	if (pending_ && index_.FindLine(pendingLine_, offset, atLine))
+	{
+		GoToLine(pendingLine_ + 1);
+		return true;
+	}
+
+	if (!exact_ && !pending_ && index_.FindOffset(top_, offset, atLine))
+	{
+		LocateTop();
+		return true;
+	}
+
+	return false;
+}
+
+// Line numbers and totals that are still estimates are marked with a tilde.
+
+std::string TextPager::Describe() const {
+	std::ostringstream os;
+	os << "Line " << (exact_ ? "" : "~") << Group(topLine_ + 1) << " of ";
+
+	if (index_.IsComplete())
+		os << Group(index_.GetLineCount());
+	else
+	{
+		unsigned long long const indexed = index_.GetIndexedBytes();
+		if (indexed == 0)
+			os << "?";
+		else
+			os << "~" << Group(static_cast<unsigned long long>(index_.GetSize() * (static_cast<double>(index_.GetLineCount()) / indexed)));
+		os << "  (indexing " << std::fixed << std::setprecision(0) << 100.0 * index_.GetIndexedBytes() / index_.GetSize() << "%)";
+	}
+
+	if (index_.WasLoaded())
+		os << "  (index from cache)";
+
+	return os.str();
+}
+
+// A line start is the byte after a newline. When the file ends in a newline, the empty "line" after it is not a
+// real line, so the window stops at the last real one instead.
+
+unsigned long long TextPager::SkipForward(unsigned long long offset, unsigned long long n, unsigned long long& skipped) {
+	std::vector<char> buf(BLOCK);
+	unsigned long long start = offset, previous = offset;
+	unsigned long long pos = offset;
+	skipped = 0;
+
+	while (skipped < n)
+	{
+		std::size_t got = file_.ReadAt(pos, buf.data(), buf.size());
+		if (got == 0)
+			break;
+
+		char const* p = buf.data();
+		char const* end = buf.data() + got;
+		while (skipped < n)
+		{
+			char const* nl = static_cast<char const*>(memchr(p, '\n', end - p));
+			if (!nl)
+				break;
+
+			previous = start;
+			start = pos + (nl - buf.data()) + 1;
+			++skipped;
+			p = nl + 1;
+		}
+		pos += got;
+	}
+
+	if (skipped != 0 && start >= file_.GetSize())
+	{
+		start = previous;
+		--skipped;
+	}
+
+	return start;
+}
+
+// Walks backwards a block at a time. The newline just before offset ends the line above, so the line n lines
+// up starts after the (n + 1)-th newline found.
+
+unsigned long long TextPager::SkipBack(unsigned long long offset, unsigned long long n, unsigned long long& skipped) {
+	std::vector<char> buf(BLOCK);
+	unsigned long long found = 0;
+	unsigned long long pos = offset;
+
+	while (pos > 0)
+	{
+		std::size_t const length = static_cast<std::size_t>(std::min<unsigned long long>(BLOCK, pos));
+		std::size_t got = file_.ReadAt(pos - length, buf.data(), length);
+		if (got != length)
+			break;
+
+		for (std::size_t i = length; i-- > 0;)
+		{
+			if (buf[i] == '\n' && ++found == n + 1)
+			{
+				skipped = n;
+				return pos - length + i + 1;
+			}
+		}
+		pos -= length;
+	}
+
+	skipped = std::min(found, n);
+	return 0;
+}
+
+// Counts the newlines between the nearest recorded line and the top of the window, which is at most STRIDE lines.
+
+void TextPager::LocateTop() {
+	unsigned long long atOffset = 0, atLine = 0;
+	exact_ = index_.FindOffset(top_, atOffset, atLine);
+	if (!exact_)
+	{
+		topLine_ = atLine;
+		return;
+	}
+
+	std::vector<char> buf(BLOCK);
+	unsigned long long pos = atOffset;
+	while (pos < top_)
+	{
+		std::size_t const length = static_cast<std::size_t>(std::min<unsigned long long>(BLOCK, top_ - pos));
+		std::size_t got = file_.ReadAt(pos, buf.data(), length);
+		if (got == 0)
+			break;
+
+		atLine += std::count(buf.begin(), buf.begin() + got, '\n');
+		pos += got;
+	}
+
+	topLine_ = atLine;
+}
@@ -0,0 +1,177 @@
+/** @file : LineIndex.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the sparse line index and the text pager built on it.
+History : Added so the text viewer can jump to any line of a very large file without reading it from the start.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __LINE_INDEX_GUARD__
+#define __LINE_INDEX_GUARD__
+
+#include "FileIO.hpp"
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+
+// Offsets of the start of every STRIDE-th line of a file, built on a worker thread over mapped chunks of the file.
+// While the build runs, positions past the part indexed so far are estimated from the average line length seen,
+// so lookups never wait. A finished index is saved in the cache folder and reused as long as the file's size and
+// last write time have not changed.
+
+class LineIndex
+{
+	// -------- CLASS MEMBERS --------
+	public:
+		// Lines between two recorded offsets. Finding an exact line reads at most this many lines past the offset.
+		static unsigned const STRIDE = 4096;
+
+		// Bytes of the file mapped at a time while counting.
+		static std::size_t const CHUNK = 16 * 1024 * 1024;
+
+	private:
+		std::string			path_;
+		unsigned long long	size_;
+		long long			mtime_;
+
+		mutable std::mutex					lock_;
+		std::vector<unsigned long long>		marks_;
+		std::atomic<unsigned long long>		indexed_;
+		std::atomic<unsigned long long>		lines_;
+		std::atomic<bool>					complete_;
+		std::atomic<bool>					stop_;
+		bool								loaded_;
+		std::thread							worker_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+
+		 // Loads the saved index for the file if it is still current, otherwise starts building one.
+
+		LineIndex(std::string const& path);
+		~LineIndex();
+
+		// Add these so the worker thread has a single owner.
+		LineIndex(LineIndex const&) = delete;
+		void operator=(LineIndex const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Finds where to start looking for line. Returns true with the offset and number of the nearest
+		 // recorded line at or before it when that part of the file is indexed. Otherwise returns false
+		 // with an estimated offset and atLine set to line.
+
+		bool FindLine(unsigned long long line, unsigned long long& offset, unsigned long long& atLine) const;
+
+		 // Finds the nearest recorded line at or before offset. Returns false, with an estimated line number
+		 // at offset itself, when that part of the file is not indexed yet.
+
+		bool FindOffset(unsigned long long offset, unsigned long long& atOffset, unsigned long long& atLine) const;
+
+		 // Counts the newlines in data with SSE2 when it is available, adding every STRIDE-th line start
+		 // (as an offset from base) to marks. lines is the running count and is updated.
+
+		static void CountLines(char const* data, std::size_t length, unsigned long long base, unsigned long long& lines, std::vector<unsigned long long>& marks);
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsComplete() const { return complete_; }
+		bool WasLoaded() const { return loaded_; }
+		unsigned long long GetSize() const { return size_; }
+		unsigned long long GetIndexedBytes() const { return indexed_; }
+
+		// Lines counted so far; the number of lines in the file once complete.
+		unsigned long long GetLineCount() const { return lines_; }
+
+	private:
+
+		 // Body of the worker thread: maps the file a chunk at a time and counts its lines, then saves the index.
+
+		void Build();
+
+		 // Path of the saved index for this file in the cache folder.
+
+		std::string GetCachePath() const;
+
+		bool Load();
+		void Save() const;
+};
+
+// A window of lines onto a text file, positioned by byte offset. Moving by a few lines reads only the bytes
+// around the window; jumps go through the line index so they cost at most STRIDE lines of reading.
+
+class TextPager
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		InputFile			file_;
+		LineIndex			index_;
+
+		unsigned long long	top_;
+		unsigned long long	topLine_;
+		bool				exact_;
+
+		// A jump that had to be estimated, retried once the index reaches it.
+		unsigned long long	pendingLine_;
+		bool				pending_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		TextPager(std::string const& path);
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Returns rows lines from the top of the window, cut at width with tabs expanded.
+
+		std::vector<std::string> Page(std::size_t width, std::size_t rows);
+
+		 // Moves the window down or up by n lines, stopping at the ends of the file.
+
+		void Down(unsigned long long n);
+		void Up(unsigned long long n);
+
+		 // Moves the window to line (counted from 1).
+
+		void GoToLine(unsigned long long line);
+
+		 // Moves the window to the first line starting at or after percent of the way through the file.
+
+		void GoToPercent(double percent);
+
+		 // Retries an estimated jump once the index covers it. Returns true if the window moved.
+
+		bool Refine();
+
+		 // One line summary of the position and the state of the index, for the status line.
+
+		std::string Describe() const;
+
+	private:
+
+		 // Offset of the start of the line n lines after the one starting at offset; sets skipped to the lines passed.
+
+		unsigned long long SkipForward(unsigned long long offset, unsigned long long n, unsigned long long& skipped);
+
+		 // Offset of the start of the line n lines before the one starting at offset; sets skipped to the lines passed.
+
+		unsigned long long SkipBack(unsigned long long offset, unsigned long long n, unsigned long long& skipped);
+
+		 // Works out the number of the line at the top of the window from the index, estimating it when
+		 // that part of the file is not indexed yet.
+
+		void LocateTop();
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsOpen() const { return file_.IsOpen(); }
+		bool IsIndexing() const { return !index_.IsComplete(); }
+};
+
+#endif
@@ -8,6 +8,9 @@ version: 1.0
 
 #include "ConsoleApp.h"
 #include "FileBrowser.hpp"
+#include "BatchScan.hpp"
+#include "ProcessScan.hpp"
+#include "IndexDaemon.hpp"
 #include <vector>
 #include <sstream>
 #include <regex>
@@ -22,7 +25,13 @@ Framework mvc = Framework();
 
 void ProcessEvents(FileView& view, FileModel& model) {
 	while (!view.GetQuitState()) {
-	
+
+		// Wait briefly for input so work finished in the background, such as a preview, can be shown between events.
+		if (!mvc.WaitForEvent(50)) {
+			view.ProcessIdle(model);
+			continue;
+		}
+
 		auto e = mvc.GetEvent();
 		switch (e.GetType())
 		{
@@ -41,6 +50,10 @@ class MyApp : public App {
 
 
 
+		// A copy of the browser started by a scan to list folders for it runs only that and exits.
+		if (argc == 4 && string(argv[1]) == "--scan-worker")
+			return ProcessScan::Serve(argv[2], static_cast<unsigned>(strtoul(argv[3], nullptr, 10)));
+
 		_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);  //detects memory leak
 		// Create variables to hold the arguments passed in.
 		bool recursive = false;
@@ -53,40 +66,82 @@ class MyApp : public App {
 		for (int i = 0; i < argc; ++i)
 			args.push_back(argv[i]);
 
-		// Parse the arguments and assign to the approprite variables.
-		for (unsigned i = 0; i < args.size(); ++i)
+		// Parse the arguments and assign to the approprite variables. --batch, --print0 and --ndjson run the scan
+		// without the console screen and write the matching files to standard output instead. --memory followed
+		// by a number of MB caps the memory a scan's file listing may take before it is moved to disk. --processes
+		// followed by a count spreads each scan over that many worker processes. --daemon runs the index daemon for
+		// the folders given, which other browsers on the machine then read their listings from. --crc32c makes F10
+		// write CRC-32C manifests instead of SHA-256 ones.
+		bool batch = false;
+		bool daemon = false;
+		bool pathGiven = false;
+		BatchScan::Format format = BatchScan::LINES;
+		for (unsigned i = 1; i < args.size(); ++i)
 		{
-			if (i != 0)
+			if (args[i] == "-r" && recursive == false)
+				recursive = true;
+			else if (args[i] == "--batch")
+				batch = true;
+			else if (args[i] == "--print0")
 			{
-				if (args[i] == "-r" && recursive == false)
-					recursive = true;
-				else if (regex_search(args[i], regex("^[a-z]|[A-Z]")))
-					startPath = args[i];
-				else
-					regexFilter = args[i];
+				batch = true;
+				format = BatchScan::NUL;
 			}
-
-			try
+			else if (args[i] == "--ndjson")
 			{
-				// Create application.
-				FileView view(startPath, regexFilter, recursive);
-				FileModel model(startPath, regexFilter, recursive);
-				FileController controller(model, view);
-
-				// Attach.
-				model.Attach(&controller);
-				view.Attach(&controller);
-
-				// Notify the controller that the state has changed to start the application.
-				model.Notify();
-
-				// Start looking for processing events.
-				ProcessEvents(view, controller.GetModel());
+				batch = true;
+				format = BatchScan::NDJSON;
 			}
-			catch (ConsoleAPI::XError& e)
+			else if (args[i] == "--memory" && i + 1 < args.size())
+				FileView::SetMemoryBudget(strtoull(args[++i].c_str(), nullptr, 10) * 1024 * 1024);
+			else if (args[i] == "--daemon")
+				daemon = true;
+			else if (args[i] == "--crc32c")
+				FileView::SetChecksum(ChecksumManifest::CRC32C);
+			else if (args[i] == "--processes" && i + 1 < args.size())
+				FileView::SetProcesses(static_cast<unsigned>(strtoul(args[++i].c_str(), nullptr, 10)));
+			else if (regex_search(args[i], regex("^[a-z]|[A-Z]")))
 			{
-				MessageBoxA(NULL, e.GetFile(), "Runtime Error", MB_OK);
+				// Each further folder is another root of the same search.
+				startPath = pathGiven ? startPath + ";" + args[i] : args[i];
+				pathGiven = true;
 			}
+			else
+				regexFilter = args[i];
+		}
+
+		if (daemon)
+		{
+			IndexDaemon server(startPath, regexFilter, FileView::GetProcesses());
+			return server.Run();
+		}
+
+		if (batch)
+		{
+			BatchScan scan(startPath, regexFilter, recursive, format);
+			return scan.Run();
+		}
+
+		try
+		{
+			// Create application.
+			FileView view(startPath, regexFilter, recursive);
+			FileModel model(startPath, regexFilter, recursive);
+			FileController controller(model, view);
+
+			// Attach.
+			model.Attach(&controller);
+			view.Attach(&controller);
+
+			// Notify the controller that the state has changed to start the application.
+			model.Notify();
+
+			// Start looking for processing events.
+			ProcessEvents(view, controller.GetModel());
+		}
+		catch (ConsoleAPI::XError& e)
+		{
+			MessageBoxA(NULL, e.GetFile(), "Runtime Error", MB_OK);
 		}
 
 		return EXIT_SUCCESS;
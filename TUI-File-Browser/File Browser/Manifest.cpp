@@ -0,0 +1,386 @@
+/** @file : Manifest.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for writing and verifying checksum manifests of a scan's files.
+History : Added so a data drop can be certified from the browser instead of by a tool that walks the tree again.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Manifest.hpp"
+#include "Hashing.hpp"
+#include "ThreadPool.hpp"
+#include "FileIO.hpp"
+
+#include <memory>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <Windows.h>
+
+
+char const* const ChecksumManifest::SHA256_NAME = "SHA256SUMS";
+char const* const ChecksumManifest::CRC32C_NAME = "CRC32CSUMS";
+
+namespace {
+	// Bytes buffered when the manifest is written or read.
+	std::size_t const MANIFEST_BUFFER = 1 << 20;
+
+	char const HEX[] = "0123456789abcdef";
+
+	std::string Lower(std::string text) {
+		for (auto& c : text)
+			c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+		return text;
+	}
+
+	// path relative to folder, with '/' separators, as sha256sum writes it; a path not under folder is kept whole.
+	std::string Relative(std::string const& path, std::string const& folder) {
+		std::string under = folder;
+		if (!under.empty() && under.back() != '\\' && under.back() != '/')
+			under += '\\';
+
+		std::string relative = path.size() > under.size() && Lower(path.substr(0, under.size())) == Lower(under) ? path.substr(under.size()) : path;
+		std::replace(relative.begin(), relative.end(), '\\', '/');
+		return relative;
+	}
+
+	// A manifest line's path against the folder the manifest is in; one with a drive or a leading separator is
+	// taken as it is.
+	std::string Resolve(std::string path, std::string const& folder) {
+		std::replace(path.begin(), path.end(), '/', '\\');
+		if ((path.size() > 1 && path[1] == ':') || (!path.empty() && path[0] == '\\'))
+			return path;
+		return folder + path;
+	}
+
+	bool IsHex(std::string const& text) {
+		return !text.empty() && text.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos;
+	}
+}
+
+
+// One worker's buffers, page-aligned as reads past the cache need them, and an event for each buffer's read.
+
+struct ChecksumManifest::Reader
+{
+	char*	buffers_[DEPTH];
+	HANDLE	events_[DEPTH];
+
+	Reader() {
+		for (unsigned i = 0; i < DEPTH; ++i)
+		{
+			buffers_[i] = static_cast<char*>(VirtualAlloc(nullptr, CHUNK, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+			events_[i] = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+		}
+	}
+
+	~Reader() {
+		for (unsigned i = 0; i < DEPTH; ++i)
+		{
+			if (buffers_[i])
+				VirtualFree(buffers_[i], 0, MEM_RELEASE);
+			if (events_[i])
+				CloseHandle(events_[i]);
+		}
+	}
+
+	bool IsReady() const {
+		for (unsigned i = 0; i < DEPTH; ++i)
+			if (!buffers_[i] || !events_[i])
+				return false;
+		return true;
+	}
+};
+
+// -------- CONSTRUCTOR --------
+
+ChecksumManifest::ChecksumManifest(Algorithm algorithm) : algorithm_(algorithm), cancel_(false),
+	files_(0), bytes_(0), failed_(0), missing_(0), unreadable_(0), malformed_(0), seconds_(0) {
+}
+
+// -------- OPERATIONS --------
+
+// The digests are kept in the order of files and written once every file is hashed, so the manifest does not
+// depend on which worker finished first. It is written aside and moved into place.
+
+bool ChecksumManifest::Write(std::vector<FileEntry> const& files, std::string const& folder, std::string const& path, std::function<void()> const& tick) {
+	auto start = std::chrono::steady_clock::now();
+	ThreadPool pool;
+	std::vector<std::unique_ptr<Reader>> readers(pool.GetThreadCount());
+	std::vector<std::string> digests(files.size());
+	std::string const self = Lower(path);
+
+	pool.ParallelFor(files.size(), [&](unsigned worker, std::size_t i) {
+		if (Lower(files[i].path_) == self)
+			return;
+		if (!readers[worker])
+			readers[worker].reset(new Reader);
+
+		if (HashFile(files[i].path_, files[i].size_, algorithm_, *readers[worker], digests[i]))
+			files_.fetch_add(1, std::memory_order_relaxed);
+		else if (!cancel_)
+		{
+			unreadable_.fetch_add(1, std::memory_order_relaxed);
+			Report(files[i].path_, UNREADABLE);
+		}
+	}, tick, &cancel_);
+	seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (cancel_)
+		return false;
+
+	std::string const temp = path + ".tmp";
+	{
+		std::vector<char> buffer(MANIFEST_BUFFER);
+		std::ofstream out;
+		out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+		out.open(temp, std::ios::binary | std::ios::trunc);
+		for (std::size_t i = 0; i < files.size(); ++i)
+			if (!digests[i].empty())
+				out << digests[i] << "  " << Relative(files[i].path_, folder) << '\n';
+		out.close();
+		if (out.fail())
+		{
+			DeleteFileA(temp.c_str());
+			return false;
+		}
+	}
+	return MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+}
+
+// Lines are read as sha256sum -c reads them: a leading '\' means the path has '\\' and '\n' escapes in it, and
+// the digest is followed by a space and then a space or a '*'.
+
+bool ChecksumManifest::Verify(std::string const& path, std::function<void()> const& tick) {
+	struct Line
+	{
+		std::string		digest_;
+		std::string		path_;
+		std::string		shown_;		// the path as the manifest has it
+	};
+
+	std::string const slash = path.substr(0, path.find_last_of("\\/") + 1);
+	std::vector<Line> lines;
+	{
+		std::vector<char> buffer(MANIFEST_BUFFER);
+		std::ifstream in;
+		in.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+		in.open(path, std::ios::binary);
+		if (!in)
+			return false;
+
+		std::string text;
+		while (std::getline(in, text))
+		{
+			if (!text.empty() && text.back() == '\r')
+				text.pop_back();
+			if (text.empty())
+				continue;
+
+			bool const escaped = text[0] == '\\';
+			std::string::size_type const space = text.find(' ', escaped ? 1 : 0);
+			Line line;
+			if (space != std::string::npos)
+				line.digest_ = Lower(text.substr(escaped ? 1 : 0, space - (escaped ? 1 : 0)));
+			if (space == std::string::npos || space + 2 > text.size() || (text[space + 1] != ' ' && text[space + 1] != '*')
+				|| !IsHex(line.digest_) || (line.digest_.size() != 64 && line.digest_.size() != 8))
+			{
+				++malformed_;
+				continue;
+			}
+
+			std::string name = text.substr(space + 2);
+			if (escaped)
+			{
+				std::string plain;
+				for (std::size_t i = 0; i < name.size(); ++i)
+				{
+					if (name[i] == '\\' && i + 1 < name.size())
+						plain += name[++i] == 'n' ? '\n' : name[i];
+					else
+						plain += name[i];
+				}
+				name.swap(plain);
+			}
+			line.shown_ = name;
+			line.path_ = Resolve(name, slash);
+			lines.push_back(line);
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	ThreadPool pool;
+	std::vector<std::unique_ptr<Reader>> readers(pool.GetThreadCount());
+	pool.ParallelFor(lines.size(), [&](unsigned worker, std::size_t i) {
+		Line const& line = lines[i];
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if (!GetFileAttributesExA(line.path_.c_str(), GetFileExInfoStandard, &data) || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		{
+			missing_.fetch_add(1, std::memory_order_relaxed);
+			Report(line.path_, MISSING);
+			return;
+		}
+		if (!readers[worker])
+			readers[worker].reset(new Reader);
+
+		unsigned long long const size = static_cast<unsigned long long>(data.nFileSizeHigh) << 32 | data.nFileSizeLow;
+		std::string digest;
+		if (!HashFile(line.path_, size, line.digest_.size() == 8 ? CRC32C : SHA256, *readers[worker], digest))
+		{
+			if (!cancel_)
+			{
+				unreadable_.fetch_add(1, std::memory_order_relaxed);
+				Report(line.path_, UNREADABLE);
+			}
+			return;
+		}
+
+		files_.fetch_add(1, std::memory_order_relaxed);
+		if (digest != line.digest_)
+		{
+			failed_.fetch_add(1, std::memory_order_relaxed);
+			Report(line.path_, FAILED);
+		}
+	}, tick, &cancel_);
+	seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+std::vector<ChecksumManifest::Problem> ChecksumManifest::TakeProblems() {
+	std::lock_guard<std::mutex> lk(lock_);
+	std::vector<Problem> problems;
+	problems.swap(problems_);
+	return problems;
+}
+
+// Small files are read through the cache with InputFile. Larger ones are read with up to DEPTH reads in flight,
+// in order, one to a buffer; each is hashed as it completes and its buffer goes straight back out for the read
+// DEPTH chunks on. Reads are issued up to the size the scan saw, and then one at a time while they keep coming
+// back full, so a file that grew since is still read to its end. Every read issued is waited for before the
+// buffers are let go, whether the file ends, fails or the pass is cancelled.
+
+bool ChecksumManifest::HashFile(std::string const& path, unsigned long long size, Algorithm algorithm, Reader& reader, std::string& digest) {
+	if (!reader.IsReady())
+		return false;
+
+	Sha256 sha;
+	Crc32c crc;
+	auto add = [&](char const* data, std::size_t length) {
+		if (algorithm == SHA256)
+			sha.Update(data, length);
+		else
+			crc.Update(data, length);
+		bytes_.fetch_add(length, std::memory_order_relaxed);
+	};
+
+	if (size < UNBUFFERED_MIN)
+	{
+		InputFile file(path);
+		if (!file.IsOpen())
+			return false;
+		for (std::size_t got; (got = file.Read(reader.buffers_[0], CHUNK)) != 0; )
+		{
+			if (cancel_)
+				return false;
+			add(reader.buffers_[0], got);
+		}
+	}
+	else
+	{
+		// Some file systems cannot be read past the cache; those are read through it.
+		DWORD const share = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, share, nullptr, OPEN_EXISTING, FILE_FLAG_OVERLAPPED | FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			file = CreateFileA(path.c_str(), GENERIC_READ, share, nullptr, OPEN_EXISTING, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		OVERLAPPED reads[DEPTH];
+		unsigned long long issued = 0, completed = 0;
+		bool ended = false, failed = false;
+		for (;;)
+		{
+			while (!ended && !failed && issued - completed < DEPTH && (issued * CHUNK < size || issued == completed))
+			{
+				unsigned const slot = static_cast<unsigned>(issued % DEPTH);
+				unsigned long long const offset = issued * CHUNK;
+				reads[slot] = OVERLAPPED();
+				reads[slot].Offset = static_cast<DWORD>(offset);
+				reads[slot].OffsetHigh = static_cast<DWORD>(offset >> 32);
+				reads[slot].hEvent = reader.events_[slot];
+				if (!ReadFile(file, reader.buffers_[slot], static_cast<DWORD>(CHUNK), nullptr, &reads[slot]) && GetLastError() != ERROR_IO_PENDING)
+				{
+					if (GetLastError() == ERROR_HANDLE_EOF)
+						ended = true;
+					else
+						failed = true;
+					break;
+				}
+				++issued;
+			}
+			if (completed == issued)
+				break;
+
+			unsigned const slot = static_cast<unsigned>(completed % DEPTH);
+			DWORD got = 0;
+			if (!GetOverlappedResult(file, &reads[slot], &got, TRUE))
+			{
+				got = 0;
+				if (GetLastError() == ERROR_HANDLE_EOF)
+					ended = true;
+				else
+					failed = true;
+			}
+			++completed;
+
+			if (!failed && !ended && got)
+				add(reader.buffers_[slot], got);
+			if (got < CHUNK)
+				ended = true;
+			if (cancel_)
+				failed = true;
+		}
+		CloseHandle(file);
+		if (failed)
+			return false;
+	}
+
+	if (algorithm == SHA256)
+	{
+		Sha256::Digest const d = sha.Final();
+		digest.resize(2 * sizeof(d.bytes_));
+		for (std::size_t i = 0; i < sizeof(d.bytes_); ++i)
+		{
+			digest[2 * i] = HEX[d.bytes_[i] >> 4];
+			digest[2 * i + 1] = HEX[d.bytes_[i] & 15];
+		}
+	}
+	else
+	{
+		std::uint32_t const c = crc.Final();
+		digest.resize(8);
+		for (int i = 0; i < 8; ++i)
+			digest[i] = HEX[(c >> (28 - 4 * i)) & 15];
+	}
+	return true;
+}
+
+void ChecksumManifest::Report(std::string const& path, Outcome outcome) {
+	Problem problem = { path, outcome };
+	std::lock_guard<std::mutex> lk(lock_);
+	problems_.push_back(problem);
+}
+
+// -------- ACCESSORS --------
+
+ChecksumManifest::Stats ChecksumManifest::GetStats() const {
+	Stats s;
+	s.files_ = files_;
+	s.bytes_ = bytes_;
+	s.failed_ = failed_;
+	s.missing_ = missing_;
+	s.unreadable_ = unreadable_;
+	s.malformed_ = malformed_;
+	s.seconds_ = seconds_;
+	s.cancelled_ = cancel_;
+	return s;
+}
@@ -0,0 +1,150 @@
+/** @file : Manifest.hpp
+Name : Fayomi Augustine
+Purpose: Header file for writing and verifying checksum manifests of a scan's files.
+History : Added so a data drop can be certified from the browser instead of by a tool that walks the tree again.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __MANIFEST_GUARD__
+#define __MANIFEST_GUARD__
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include "ScanEngine.hpp"
+
+
+// A checksum manifest in the format sha256sum writes and checks: one line per file, its digest in lower case
+// hex, two spaces and its path, relative to the manifest's folder and with '/' separators. A CRC-32C manifest
+// has the same lines with eight digit checksums; the kind of each line is told from its length when verifying,
+// and a '*' before the path, as sha256sum -b writes, is taken as well.
+//
+// Files are hashed on the thread pool, one file to a worker at a time. Each worker reads with DEPTH reads of
+// CHUNK bytes in flight into its own page-aligned buffers and hashes each as it lands while the next are read,
+// so the disk never waits for the hash. Files of UNBUFFERED_MIN and up are read past the system cache, which a
+// one-off pass over a whole drop would only flush; smaller ones are read through it with the sequential hint.
+
+class ChecksumManifest
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		enum Algorithm
+		{
+			SHA256,
+			CRC32C
+		};
+
+		// What verifying found for one file.
+		enum Outcome
+		{
+			GOOD,
+			FAILED,			// read in full, and its digest differs
+			MISSING,
+			UNREADABLE		// there, but could not be read to the end
+		};
+
+		struct Problem
+		{
+			std::string		path_;
+			Outcome			outcome_;
+		};
+
+		struct Stats
+		{
+			unsigned long long	files_;			// files hashed in full, or, verifying, checked
+			unsigned long long	bytes_;			// bytes read
+			unsigned long long	failed_;
+			unsigned long long	missing_;
+			unsigned long long	unreadable_;
+			unsigned long long	malformed_;		// manifest lines that could not be read
+			double				seconds_;
+			bool				cancelled_;
+		};
+
+		// Size of each read, and the reads a worker keeps in flight.
+		static std::size_t const CHUNK = 4 << 20;
+		static unsigned const DEPTH = 3;
+
+		// Files this size and up are read past the system cache.
+		static unsigned long long const UNBUFFERED_MIN = 8 << 20;
+
+		// Names the manifests are written under in the folder they cover.
+		static char const* const SHA256_NAME;
+		static char const* const CRC32C_NAME;
+
+	private:
+		// One worker's read buffers and the events their reads signal.
+		struct Reader;
+
+	// -------- CLASS MEMBERS --------
+	private:
+		Algorithm			algorithm_;
+		std::atomic<bool>	cancel_;
+
+		std::mutex				lock_;
+		std::vector<Problem>	problems_;
+
+		std::atomic<unsigned long long>	files_;
+		std::atomic<unsigned long long>	bytes_;
+		std::atomic<unsigned long long>	failed_;
+		std::atomic<unsigned long long>	missing_;
+		std::atomic<unsigned long long>	unreadable_;
+		unsigned long long				malformed_;
+		double							seconds_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Sets up a manifest of algorithm's digests; verifying takes every kind whatever it is.
+
+		ChecksumManifest(Algorithm algorithm = SHA256);
+
+		ChecksumManifest(ChecksumManifest const&) = delete;
+		void operator=(ChecksumManifest const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Hashes files and writes their manifest to path, in the order of files, with paths relative to folder;
+		 // files not under folder keep their whole path, and path itself is left out. Files that cannot be read
+		 // are left out and counted. tick is called on this thread at a fixed interval. Returns false if the
+		 // manifest cannot be written or the pass was cancelled, in which case no manifest is left at path.
+
+		bool Write(std::vector<FileEntry> const& files, std::string const& folder, std::string const& path, std::function<void()> const& tick = std::function<void()>());
+
+		 // Hashes every file the manifest at path names, relative to the manifest's folder, and compares. Every
+		 // file that is not good is kept as a problem. Returns false if the manifest cannot be read.
+
+		bool Verify(std::string const& path, std::function<void()> const& tick = std::function<void()>());
+
+		 // Asks a running pass to stop. Workers finish the read they are waiting on.
+
+		void Cancel() { cancel_ = true; }
+
+		 // Hands over the problems found since the last call.
+
+		std::vector<Problem> TakeProblems();
+
+	// -------- ACCESSORS --------
+	public:
+		Algorithm GetAlgorithm() const { return algorithm_; }
+		Stats GetStats() const;
+
+		// Name the manifest of algorithm is written under.
+		static char const* GetName(Algorithm algorithm) { return algorithm == CRC32C ? CRC32C_NAME : SHA256_NAME; }
+
+	private:
+
+		 // Reads the file at path to the end with reader and sets digest to its digest in hex. size is what the
+		 // scan found, or ~0 if it is not known. Returns false if it cannot be opened or read, or on cancel.
+
+		bool HashFile(std::string const& path, unsigned long long size, Algorithm algorithm, Reader& reader, std::string& digest);
+
+		void Report(std::string const& path, Outcome outcome);
+};
+
+#endif
@@ -0,0 +1,171 @@
+/** @file : PathTree.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the folder tree built over the scanned files.
+History : Added so the browser can move between folders of a scan, and sum them up, without rescanning.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "PathTree.hpp"
+
+#include <algorithm>
+
+
+namespace {
+	char Lower(char c) {
+		return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+	}
+
+	bool IsSeparator(char c) {
+		return c == '\\' || c == '/';
+	}
+
+	// Splits text[0, length) into the names between separators, skipping empty ones.
+	std::vector<std::string> Split(std::string const& text, std::size_t length) {
+		std::vector<std::string> names;
+		std::size_t i = 0;
+		while (i < length)
+		{
+			while (i < length && IsSeparator(text[i]))
+				++i;
+
+			std::size_t const start = i;
+			while (i < length && !IsSeparator(text[i]))
+				++i;
+			if (i > start)
+				names.push_back(text.substr(start, i - start));
+		}
+		return names;
+	}
+
+	std::string ToLower(std::string text) {
+		std::transform(text.begin(), text.end(), text.begin(), Lower);
+		return text;
+	}
+}
+
+
+// -------- CONSTRUCTOR --------
+
+// A first tree is built with one node per folder. Since the files are sorted, the folders of one file differ
+// from the previous file's only below some depth: the nodes below it are finished (their run of files ends
+// here) and new nodes are opened for the rest. Sizes are summed into a running total so a node's bytes are
+// the difference of the totals at the ends of its run. The tree is then copied with its chains merged.
+
+PathTree::PathTree(std::vector<FileEntry> const& files) {
+	std::vector<Node> full(1);
+	std::vector<unsigned long long> totals(1, 0);
+	totals.reserve(files.size() + 1);
+
+	std::vector<std::uint32_t> open(1, 0);
+	for (std::size_t i = 0; i < files.size(); ++i)
+	{
+		std::string const& path = files[i].path_;
+		std::size_t const slash = path.find_last_of("\\/");
+		std::vector<std::string> names = Split(path, slash == std::string::npos ? 0 : slash);
+
+		std::size_t depth = 0;
+		while (depth + 1 < open.size() && depth < names.size() && full[open[depth + 1]].label_ == names[depth])
+			++depth;
+
+		while (open.size() > depth + 1)
+		{
+			full[open.back()].end_ = i;
+			open.pop_back();
+		}
+
+		for (; depth < names.size(); ++depth)
+		{
+			Node node;
+			node.label_ = names[depth];
+			node.parent_ = open.back();
+			node.first_ = i;
+
+			full[open.back()].children_.push_back(static_cast<std::uint32_t>(full.size()));
+			open.push_back(static_cast<std::uint32_t>(full.size()));
+			full.push_back(node);
+		}
+
+		totals.push_back(totals.back() + files[i].size_);
+	}
+
+	for (auto node : open)
+		full[node].end_ = files.size();
+
+	for (auto& node : full)
+		node.bytes_ = totals[node.end_] - totals[node.first_];
+
+	nodes_.swap(full);
+	Compress(full, GetRoot(), NONE);
+	nodes_.swap(full);
+}
+
+// -------- OPERATIONS --------
+
+// Each step picks the child whose first name matches by binary search, then checks the rest of its label.
+
+std::uint32_t PathTree::Find(std::string const& folder, std::string* rest) const {
+	if (rest)
+		rest->clear();
+
+	std::vector<std::string> names = Split(folder, folder.size());
+	std::uint32_t node = GetRoot();
+	std::size_t n = 0;
+
+	while (n < names.size())
+	{
+		std::string const key = ToLower(names[n]);
+		auto const& children = nodes_[node].children_;
+		auto it = std::lower_bound(children.begin(), children.end(), key, [this](std::uint32_t child, std::string const& k) { return nodes_[child].key_ < k; });
+		if (it == children.end() || nodes_[*it].key_ != key)
+			return NONE;
+
+		node = *it;
+		std::vector<std::string> label = Split(nodes_[node].label_, nodes_[node].label_.size());
+		for (std::size_t l = 0; l < label.size(); ++l, ++n)
+		{
+			if (n == names.size())
+			{
+				// The folder ends inside this chain, so its files are all of this node's.
+				if (rest)
+					for (std::size_t r = l; r < label.size(); ++r)
+						*rest += (r > l ? "\\" : "") + label[r];
+				return node;
+			}
+
+			if (ToLower(label[l]) != ToLower(names[n]))
+				return NONE;
+		}
+	}
+
+	return node;
+}
+
+// A node is merged with its only child when that child holds all of its files, that is, when the node has no
+// files of its own. The root is never merged, so every path starts below it.
+
+std::uint32_t PathTree::Compress(std::vector<Node>& out, std::uint32_t from, std::uint32_t parent) const {
+	Node node = nodes_[from];
+	node.parent_ = parent;
+	node.children_.clear();
+
+	std::uint32_t at = from;
+	while (parent != NONE && nodes_[at].children_.size() == 1 && GetCount(nodes_[at].children_[0]) == GetCount(at))
+	{
+		at = nodes_[at].children_[0];
+		node.label_ += "\\" + nodes_[at].label_;
+	}
+	node.key_ = ToLower(nodes_[from].label_);
+
+	std::uint32_t const index = static_cast<std::uint32_t>(out.size());
+	out.push_back(node);
+
+	for (auto child : nodes_[at].children_)
+	{
+		std::uint32_t const copy = Compress(out, child, index);
+		out[index].children_.push_back(copy);
+	}
+
+	std::sort(out[index].children_.begin(), out[index].children_.end(), [&out](std::uint32_t a, std::uint32_t b) { return out[a].key_ < out[b].key_; });
+	return index;
+}
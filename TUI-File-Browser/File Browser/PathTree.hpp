@@ -0,0 +1,89 @@
+/** @file : PathTree.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the folder tree built over the scanned files.
+History : Added so the browser can move between folders of a scan, and sum them up, without rescanning.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __PATH_TREE_GUARD__
+#define __PATH_TREE_GUARD__
+
+#include "ScanEngine.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+// A radix tree over the folder names in the scanned paths, one node per folder holding files. A chain of
+// folders that hold nothing but the next folder is kept as a single node whose label joins their names,
+// so a deep, sparse tree costs one node per branch. The files must be sorted by path: every folder's files
+// then sit next to each other, so a node only records where its run of files starts and ends, and iterating
+// a subtree is a walk over that run. The file count and the total size of each subtree are kept in its node.
+// Folder names are compared without regard to case, as Windows does.
+
+class PathTree
+{
+	// -------- CLASS MEMBERS --------
+	public:
+		// Returned by Find when no scanned file is under the folder.
+		static std::uint32_t const NONE = 0xffffffff;
+
+	private:
+		struct Node
+		{
+			std::string					label_;		// one or more folder names joined by '\'; empty for the root
+			std::string					key_;		// first name of the label, in lower case
+			std::vector<std::uint32_t>	children_;	// ordered by key_
+			std::uint32_t				parent_;
+			std::size_t					first_;
+			std::size_t					end_;
+			unsigned long long			bytes_;
+
+			Node() : parent_(NONE), first_(0), end_(0), bytes_(0) { };
+		};
+
+		std::vector<Node>	nodes_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Builds the tree over files, which must be sorted by path.
+
+		PathTree(std::vector<FileEntry> const& files);
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // The node holding the files under folder, found one folder name at a time, or NONE. If folder ends
+		 // part way through a node's label, that node is returned and rest is set to the part of the label
+		 // below folder; otherwise rest is cleared.
+
+		std::uint32_t Find(std::string const& folder, std::string* rest = nullptr) const;
+
+	// -------- ACCESSORS --------
+	public:
+		std::uint32_t GetRoot() const { return 0; }
+		std::size_t GetNodeCount() const { return nodes_.size(); }
+
+		std::string const& GetLabel(std::uint32_t node) const { return nodes_[node].label_; }
+		std::uint32_t GetParent(std::uint32_t node) const { return nodes_[node].parent_; }
+		std::vector<std::uint32_t> const& GetChildren(std::uint32_t node) const { return nodes_[node].children_; }
+
+		// The subtree's files are [GetFirst, GetEnd) of the files the tree was built from.
+		std::size_t GetFirst(std::uint32_t node) const { return nodes_[node].first_; }
+		std::size_t GetEnd(std::uint32_t node) const { return nodes_[node].end_; }
+		std::size_t GetCount(std::uint32_t node) const { return nodes_[node].end_ - nodes_[node].first_; }
+		unsigned long long GetBytes(std::uint32_t node) const { return nodes_[node].bytes_; }
+
+	private:
+
+		 // Copies node from into out below parent, merging it with the chain of single children below it.
+		 // Returns where it was put.
+
+		std::uint32_t Compress(std::vector<Node>& out, std::uint32_t from, std::uint32_t parent) const;
+};
+
+#endif
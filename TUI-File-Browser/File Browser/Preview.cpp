@@ -0,0 +1,252 @@
+/** @file : Preview.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the preview pane's background loader.
+History : Added so the selected file can be previewed next to the file viewer without blocking the keyboard.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Preview.hpp"
+#include "FileIO.hpp"
+
+#include <cstring>
+#include <cctype>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+
+namespace {
+	// Bytes copied out of the mapping at a time. The first block is also used to tell text from binary.
+	std::size_t const BLOCK = 8192;
+
+	// Copies n bytes out of a mapped view. A mapped page that cannot be read (the file was truncated, or the
+	// share it lives on went away) raises an in-page error rather than failing a read, so it is caught here.
+	// Kept free of objects with destructors so structured exception handling can be used.
+	bool CopyMapped(char* dst, char const* src, std::size_t n) {
+#ifdef _MSC_VER
+		__try
+		{
+			memcpy(dst, src, n);
+		}
+		__except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+		{
+			return false;
+		}
+#else
+		memcpy(dst, src, n);
+#endif
+		return true;
+	}
+}
+
+
+// -------- CONSTRUCTOR/DESTRUCTOR --------
+
+// The worker is started by the first request rather than here, so a loader can be a global.
+
+PreviewLoader::PreviewLoader() : width_(0), rows_(0), requested_(0), started_(0), quit_(false), ready_(false) {
+}
+PreviewLoader::~PreviewLoader() {
+	{
+		std::lock_guard<std::mutex> lk(lock_);
+		quit_ = true;
+	}
+	wake_.notify_all();
+
+	if (worker_.joinable())
+		worker_.join();
+}
+
+// -------- OPERATIONS --------
+
+// Stores the request and bumps the generation. A preview being built for an older generation sees the
+// change the next time it checks and gives up.
+
+void PreviewLoader::Request(std::string const& path, std::size_t width, std::size_t rows) {
+	{
+		std::lock_guard<std::mutex> lk(lock_);
+		path_ = path;
+		width_ = width;
+		rows_ = rows;
+		++requested_;
+		ready_ = false;
+
+		if (!worker_.joinable())
+			worker_ = std::thread(&PreviewLoader::Work, this);
+	}
+	wake_.notify_all();
+}
+
+// Bumps the generation without giving the worker anything new to build.
+
+void PreviewLoader::Cancel() {
+	std::lock_guard<std::mutex> lk(lock_);
+	++requested_;
+	started_ = requested_;
+	ready_ = false;
+}
+
+bool PreviewLoader::TakeResult(std::vector<std::string>& lines) {
+	std::lock_guard<std::mutex> lk(lock_);
+	if (!ready_)
+		return false;
+
+	lines.swap(result_);
+	result_.clear();
+	ready_ = false;
+	return true;
+}
+
+// Maps at most WINDOW bytes from the start of the file and copies them out a block at a time, only as far as the
+// pane needs. A NUL byte in the first block marks the file as binary, which is shown as a hex dump with as many
+// bytes per line as fit. Text is shown line by line with tabs expanded and control characters replaced, and
+// every line is cut at the pane's width.
+
+std::vector<std::string> PreviewLoader::Build(std::string const& path, std::size_t width, std::size_t rows, std::function<bool()> const& stale) {
+	std::vector<std::string> lines;
+
+	MappedFile file(path);
+	if (!file.IsOpen())
+	{
+		lines.push_back("Cannot open file.");
+		return lines;
+	}
+	if (file.GetSize() == 0)
+	{
+		lines.push_back("(empty file)");
+		return lines;
+	}
+
+	std::size_t const window = static_cast<std::size_t>(std::min<unsigned long long>(file.GetSize(), WINDOW));
+	char const* view = file.Map(0, window);
+	if (!view)
+	{
+		lines.push_back("Cannot map file.");
+		return lines;
+	}
+
+	// Pulls the next block of the window into buf.
+	std::string buf;
+	auto more = [&]() -> bool {
+		if (buf.size() >= window || (stale && stale()))
+			return false;
+
+		std::size_t n = std::min(BLOCK, window - buf.size());
+		std::size_t at = buf.size();
+		buf.resize(at + n);
+		if (!CopyMapped(&buf[at], view + at, n))
+		{
+			buf.resize(at);
+			return false;
+		}
+		return true;
+	};
+
+	if (!more())
+	{
+		if (!stale || !stale())
+			lines.push_back("Cannot read file.");
+		return lines;
+	}
+
+	if (memchr(buf.data(), 0, buf.size()))
+	{
+		// Offset, two spaces, three columns per byte, a space, then one column per byte. Whole groups of
+		// eight bytes are shown when they fit so the offsets stay round.
+		std::size_t perRow = width > 15 ? std::min<std::size_t>((width - 11) / 4, 16) : 1;
+		if (perRow >= 8)
+			perRow -= perRow % 8;
+		for (std::size_t at = 0; at < buf.size() && lines.size() < rows; at += perRow)
+		{
+			std::ostringstream hex;
+			hex << std::hex << std::setfill('0') << std::setw(8) << static_cast<unsigned>(at) << "  ";
+			std::string text;
+
+			for (std::size_t i = at; i < at + perRow; ++i)
+			{
+				if (i < buf.size())
+				{
+					unsigned char c = static_cast<unsigned char>(buf[i]);
+					hex << std::setw(2) << static_cast<unsigned>(c) << ' ';
+					text += isprint(c) ? static_cast<char>(c) : '.';
+				}
+				else
+					hex << "   ";
+			}
+
+			lines.push_back((hex.str() + " " + text).substr(0, width));
+		}
+		return lines;
+	}
+
+	std::string line;
+	bool cut = false;
+	for (std::size_t i = 0; lines.size() < rows; ++i)
+	{
+		if (i == buf.size() && !more())
+			break;
+
+		unsigned char c = static_cast<unsigned char>(buf[i]);
+		if (c == '\n')
+		{
+			lines.push_back(line);
+			line.clear();
+			cut = false;
+		}
+		else if (c == '\r' || cut)
+			continue;
+		else if (c == '\t')
+			line.append(4 - line.size() % 4, ' ');
+		else
+			line += isprint(c) ? static_cast<char>(c) : '.';
+
+		if (line.size() >= width)
+		{
+			line.resize(width);
+			cut = true;
+		}
+	}
+
+	if (!line.empty() && lines.size() < rows)
+		lines.push_back(line);
+
+	return lines;
+}
+
+// Waits for a generation it has not started, builds it with the lock released, and only stores the
+// result if no newer request came in meanwhile.
+
+void PreviewLoader::Work() {
+	for (;;)
+	{
+		std::string path;
+		std::size_t width, rows;
+		unsigned long long generation;
+		{
+			std::unique_lock<std::mutex> lk(lock_);
+			wake_.wait(lk, [this] { return quit_ || started_ != requested_; });
+			if (quit_)
+				return;
+
+			path = path_;
+			width = width_;
+			rows = rows_;
+			generation = started_ = requested_;
+		}
+
+		std::vector<std::string> lines;
+		if (!path.empty())
+			lines = Build(path, width, rows, [this, generation] {
+				std::lock_guard<std::mutex> lk(lock_);
+				return quit_ || requested_ != generation;
+			});
+
+		std::lock_guard<std::mutex> lk(lock_);
+		if (requested_ == generation)
+		{
+			result_.swap(lines);
+			ready_ = true;
+		}
+	}
+}
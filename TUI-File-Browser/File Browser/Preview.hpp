@@ -0,0 +1,84 @@
+/** @file : Preview.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the preview pane's background loader.
+History : Added so the selected file can be previewed next to the file viewer without blocking the keyboard.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __PREVIEW_GUARD__
+#define __PREVIEW_GUARD__
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+
+// Builds previews on a worker thread. Every request supersedes the one before it: a preview still being
+// built for an earlier selection is dropped when it finishes, and only the latest one is handed back.
+
+class PreviewLoader
+{
+	// -------- CLASS MEMBERS --------
+	public:
+		// Bytes of the file mapped for a preview. A pane never shows more than this, so it bounds the
+		// work done for one selection however big the file is.
+		static std::size_t const WINDOW = 64 * 1024;
+
+	private:
+		std::mutex					lock_;
+		std::condition_variable		wake_;
+		std::thread					worker_;
+
+		std::string					path_;
+		std::size_t					width_;
+		std::size_t					rows_;
+		unsigned long long			requested_;
+		unsigned long long			started_;
+		bool						quit_;
+
+		std::vector<std::string>	result_;
+		bool						ready_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+		PreviewLoader();
+		~PreviewLoader();
+
+		// Add these so the worker thread has a single owner.
+		PreviewLoader(PreviewLoader const&) = delete;
+		void operator=(PreviewLoader const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Asks for a preview of "path" that fits in width columns and rows lines. An empty path clears the pane.
+
+		void Request(std::string const& path, std::size_t width, std::size_t rows);
+
+		 // Drops any pending or running request, so nothing is handed back until the next Request.
+
+		void Cancel();
+
+		 // Moves the preview for the latest request into lines. Returns false if it is not ready yet.
+
+		bool TakeResult(std::vector<std::string>& lines);
+
+		 // Formats the head of a text file, or a hex dump of a binary one, as at most rows lines of at most
+		 // width columns. Only the first WINDOW bytes are mapped. stale is checked between steps and the
+		 // preview is abandoned as soon as it returns true.
+
+		static std::vector<std::string> Build(std::string const& path, std::size_t width, std::size_t rows, std::function<bool()> const& stale = std::function<bool()>());
+
+	private:
+
+		 // Body of the worker thread: builds the latest request until told to quit.
+
+		void Work();
+};
+
+#endif
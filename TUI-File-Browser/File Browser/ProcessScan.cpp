@@ -0,0 +1,681 @@
+/** @file : ProcessScan.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the scan that spreads a walk over worker processes.
+History : Added for trees whose metadata is slow enough that one process's threads stop gaining.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "ProcessScan.hpp"
+#include "Throttle.hpp"
+#include "Progress.hpp"
+
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+
+namespace {
+	char const MAGIC[4] = { 'T', 'P', 'S', 'C' };
+
+	// Folders the shared queue holds at once, and the longest path one of its slots takes.
+	unsigned const QUEUE_SLOTS = 1024;
+	std::size_t const SLOT_PATH = 1024;
+
+	// Bytes in each worker's ring; a record takes RECORD_HEAD bytes and its path.
+	std::size_t const RING_BYTES = 1024 * 1024;
+	std::size_t const RECORD_HEAD = 2 * sizeof(unsigned) + sizeof(unsigned long long) + sizeof(long long);
+
+	// Longest filter the workers are sent.
+	std::size_t const MAX_FILTER = 1024;
+
+	// Most worker processes.
+	unsigned const MAX_PROCESSES = 64;
+
+	// How long a worker waits for the queue to fill before looking again, how long the browser waits for a
+	// worker to finish a folder, and how long workers are given to stop at the end.
+	DWORD const WORK_WAIT_MS = 50;
+	DWORD const READY_WAIT_MS = 10;
+	DWORD const STOP_WAIT_MS = 2000;
+
+	// Number of the browser's next scan block, here rather than a static in Open, which Visual Studio 2013 would
+	// not set up safely for two scans opened at once.
+	std::atomic<unsigned> nextScan(0);
+
+	// Takes a named mutex. One left held by a worker that died is handed over, and counts as taken.
+	bool Lock(HANDLE mutex) {
+		DWORD const got = WaitForSingleObject(mutex, INFINITE);
+		return got == WAIT_OBJECT_0 || got == WAIT_ABANDONED;
+	}
+
+	std::size_t RoundUp(std::size_t bytes) {
+		return (bytes + 63) & ~static_cast<std::size_t>(63);
+	}
+}
+
+
+// The block starts with this, then the queue's slots, then each worker's ring. The queue is only touched with
+// the named mutex held; the rest are atomics both sides use without it.
+
+struct ProcessScan::Shared
+{
+	char					magic_[4];
+	unsigned				workers_;
+	unsigned				recurse_;
+	char					filter_[MAX_FILTER];
+	std::atomic<unsigned>	stop_;
+	std::atomic<unsigned>	background_;
+	std::atomic<unsigned>	rate_;		// tokens a second for each worker; zero for no limit
+
+	unsigned long long		head_;		// the queue runs from head_ to tail_; slot i is slots_[i % QUEUE_SLOTS]
+	unsigned long long		tail_;
+};
+
+struct ProcessScan::Slot
+{
+	unsigned long long	ticket_;
+	char				path_[SLOT_PATH];
+};
+
+// Written and read only ever grow; a record is at written % RING_BYTES. A worker sets claimed_ to the ticket of
+// the folder it takes while it still holds the queue, and clears it once the folder's done record is written.
+// Each counter is padded to a cache line of its own; rings start on one, as RingAt places them.
+
+struct ProcessScan::Ring
+{
+	std::atomic<unsigned long long>	claimed_;
+	char							claimedPad_[64 - sizeof(std::atomic<unsigned long long>)];
+	std::atomic<unsigned long long>	written_;
+	char							writtenPad_[64 - sizeof(std::atomic<unsigned long long>)];
+	std::atomic<unsigned long long>	read_;
+	char							readPad_[64 - sizeof(std::atomic<unsigned long long>)];
+	char							bytes_[RING_BYTES];
+};
+
+namespace {
+	std::size_t SlotsAt() {
+		return RoundUp(sizeof(ProcessScan::Shared));
+	}
+
+	std::size_t RingAt(unsigned w) {
+		return RoundUp(SlotsAt() + QUEUE_SLOTS * sizeof(ProcessScan::Slot)) + w * RoundUp(sizeof(ProcessScan::Ring));
+	}
+
+	// Writes record to ring, waiting for the reader to make room. A record that would run past the end of the
+	// ring goes to its start, after a pad record if there is room for one. Returns false if told to stop first.
+	bool Put(ProcessScan::Ring& ring, ProcessScan::Shared const& shared, ProcessScan::Record const& record) {
+		std::size_t const size = RECORD_HEAD + record.path_.size();
+		unsigned long long at = ring.written_.load(std::memory_order_relaxed);
+		std::size_t const left = RING_BYTES - static_cast<std::size_t>(at % RING_BYTES);
+		std::size_t const skip = left < size ? left : 0;
+
+		while (at + skip + size - ring.read_.load(std::memory_order_acquire) > RING_BYTES)
+		{
+			if (shared.stop_.load(std::memory_order_relaxed))
+				return false;
+			Sleep(1);
+		}
+
+		unsigned head[2] = { 0, ProcessScan::PAD };
+		if (skip >= RECORD_HEAD)
+		{
+			head[0] = static_cast<unsigned>(skip);
+			std::memcpy(ring.bytes_ + at % RING_BYTES, head, sizeof(head));
+		}
+		at += skip;
+
+		char* p = ring.bytes_ + at % RING_BYTES;
+		head[0] = static_cast<unsigned>(size);
+		head[1] = record.type_;
+		std::memcpy(p, head, sizeof(head));
+		std::memcpy(p + sizeof(head), &record.a_, sizeof(record.a_));
+		std::memcpy(p + sizeof(head) + sizeof(record.a_), &record.b_, sizeof(record.b_));
+		std::memcpy(p + RECORD_HEAD, record.path_.data(), record.path_.size());
+
+		ring.written_.store(at + size, std::memory_order_release);
+		return true;
+	}
+
+	// Reads the next record from ring into record. Returns false if there is none yet.
+	bool Take(ProcessScan::Ring& ring, ProcessScan::Record& record) {
+		unsigned long long at = ring.read_.load(std::memory_order_relaxed);
+		unsigned long long const written = ring.written_.load(std::memory_order_acquire);
+		while (at < written)
+		{
+			std::size_t const left = RING_BYTES - static_cast<std::size_t>(at % RING_BYTES);
+			char const* p = ring.bytes_ + at % RING_BYTES;
+			unsigned head[2] = { 0, 0 };
+			if (left >= RECORD_HEAD)
+				std::memcpy(head, p, sizeof(head));
+			if (left < RECORD_HEAD || head[1] == ProcessScan::PAD)
+			{
+				at += left;
+				continue;
+			}
+
+			record.type_ = static_cast<ProcessScan::RecordType>(head[1]);
+			std::memcpy(&record.a_, p + sizeof(head), sizeof(record.a_));
+			std::memcpy(&record.b_, p + sizeof(head) + sizeof(record.a_), sizeof(record.b_));
+			record.path_.assign(p + RECORD_HEAD, head[0] - RECORD_HEAD);
+
+			ring.read_.store(at + head[0], std::memory_order_release);
+			return true;
+		}
+		return false;
+	}
+
+	ProcessScan::Record Failed(std::error_code const& ec, std::string const& path) {
+		ProcessScan::Record record = { ProcessScan::FAILED, static_cast<unsigned long long>(ec.value()), ec.category() == std::system_category() ? 1 : 0, path };
+		return record;
+	}
+}
+
+
+// -------- CONSTRUCTOR/DESTRUCTOR --------
+ProcessScan::ProcessScan(std::vector<std::string> const& roots, unsigned processes) : roots_(roots), processes_(std::min(std::max(processes, 1u), MAX_PROCESSES)), mapping_(NULL), shared_(nullptr), slots_(nullptr), queueLock_(NULL), work_(NULL), ready_(NULL), job_(NULL), nextTicket_(1), recurse_(false), resumed_(false), searched_(0), listed_(0), crashes_(0), throttle_(nullptr), progress_(nullptr) {
+}
+
+ProcessScan::~ProcessScan() {
+	Close();
+}
+
+// -------- OPERATIONS --------
+
+// The browser's side. Each pass moves folders into the shared queue, reads every worker's ring, and replaces a
+// worker that died; with no worker left, the browser lists the rest itself. A pass with nothing to read waits for
+// a worker to signal that it finished a folder, so a quiet walk costs no spinning.
+
+void ProcessScan::Run(bool recurse, std::string const& filter, FileVisitor const& visit, ScanEngine::Tick const& tick, FolderVisitor const& enter) {
+	outstanding_.clear();
+	attempts_.clear();
+	backlog_.clear();
+	here_.clear();
+	nextTicket_ = 1;
+	recurse_ = recurse;
+	filter_ = std::regex(filter);
+	searched_ = 0;
+	listed_ = 0;
+	crashes_ = 0;
+	errors_.Reset();
+
+	for (auto const& folder : resumed_ ? start_ : roots_)
+		Queue(folder);
+	if (progress_)
+		progress_->Queued(0, static_cast<long long>(backlog_.size()));
+
+	if (!Open(recurse, filter))
+		Reclaim();
+
+	auto ticked = std::chrono::steady_clock::now();
+	while (!outstanding_.empty())
+	{
+		std::size_t read = 0;
+		unsigned alive = 0;
+		for (unsigned w = 0; w < workers_.size(); ++w)
+		{
+			Worker& worker = workers_[w];
+			if (!worker.alive_)
+				continue;
+
+			read += Drain(w, visit, enter);
+			if (WaitForSingleObject(worker.process_.hProcess, 0) == WAIT_OBJECT_0)
+			{
+				// Whatever it wrote before it died is still in its ring.
+				read += Drain(w, visit, enter);
+				worker.held_.clear();
+				CloseHandle(worker.process_.hProcess);
+				CloseHandle(worker.process_.hThread);
+				worker.alive_ = false;
+				++crashes_;
+
+				Requeue(w);
+				if (worker.starts_ < MAX_STARTS)
+					Start(w);
+			}
+			alive += worker.alive_ ? 1 : 0;
+		}
+
+		if (alive == 0)
+			Reclaim();
+		else
+			Publish();
+
+		if (!here_.empty())
+		{
+			unsigned long long const ticket = here_.front();
+			here_.pop_front();
+			ListHere(ticket, visit, enter);
+			++read;
+		}
+
+		auto const now = std::chrono::steady_clock::now();
+		if (now - ticked >= std::chrono::milliseconds(100))
+		{
+			ticked = now;
+			if (shared_ && throttle_)
+			{
+				double const rate = throttle_->GetRate();
+				shared_->background_.store(throttle_->IsBackground() ? 1 : 0, std::memory_order_relaxed);
+				shared_->rate_.store(static_cast<unsigned>(rate / processes_ + (rate > 0 ? 1 : 0)), std::memory_order_relaxed);
+			}
+			if (tick)
+				tick();
+		}
+
+		if (read == 0 && alive != 0)
+			WaitForSingleObject(ready_, READY_WAIT_MS);
+	}
+
+	Close();
+}
+
+// The worker's side. The ticket is copied into the ring's claimed_ before head_ moves past it, both under the
+// mutex, so a worker that dies at any point leaves its folder either still queued or claimed.
+
+int ProcessScan::Serve(std::string const& name, unsigned index) {
+	HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+	HANDLE queueLock = OpenMutexA(SYNCHRONIZE, FALSE, (name + "-queue").c_str());
+	HANDLE work = OpenEventA(SYNCHRONIZE | EVENT_MODIFY_STATE, FALSE, (name + "-work").c_str());
+	HANDLE ready = OpenEventA(EVENT_MODIFY_STATE, FALSE, (name + "-ready").c_str());
+	char* view = mapping ? static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0)) : nullptr;
+
+	Shared* shared = reinterpret_cast<Shared*>(view);
+	int result = EXIT_FAILURE;
+	if (view && queueLock && work && ready && std::equal(MAGIC, MAGIC + 4, shared->magic_) && index < shared->workers_)
+	{
+		Slot* slots = reinterpret_cast<Slot*>(view + SlotsAt());
+		Ring& ring = *reinterpret_cast<Ring*>(view + RingAt(index));
+		bool const recurse = shared->recurse_ != 0;
+
+		std::regex filter;
+		try
+		{
+			filter = std::regex(shared->filter_);
+		}
+		catch (std::regex_error const&)
+		{
+			filter = std::regex(".*");
+		}
+
+		ScanThrottle throttle;
+		bool background = false;
+		unsigned rate = ~0u;
+
+		while (!shared->stop_.load(std::memory_order_relaxed))
+		{
+			unsigned long long ticket = 0;
+			std::string folder;
+			if (!Lock(queueLock))
+				break;
+			if (shared->head_ < shared->tail_)
+			{
+				Slot const& slot = slots[shared->head_ % QUEUE_SLOTS];
+				ticket = slot.ticket_;
+				folder = slot.path_;
+				ring.claimed_.store(ticket, std::memory_order_release);
+				++shared->head_;
+			}
+			else
+				ResetEvent(work);
+			ReleaseMutex(queueLock);
+
+			if (ticket == 0)
+			{
+				WaitForSingleObject(work, WORK_WAIT_MS);
+				continue;
+			}
+
+			// Background mode and the rate can be changed mid-walk, so each folder checks them first.
+			if ((shared->background_.load(std::memory_order_relaxed) != 0) != background)
+			{
+				background = !background;
+				SetPriorityClass(GetCurrentProcess(), background ? PROCESS_MODE_BACKGROUND_BEGIN : PROCESS_MODE_BACKGROUND_END);
+				throttle.SetBackground(background);
+			}
+			if (shared->rate_.load(std::memory_order_relaxed) != rate)
+			{
+				rate = shared->rate_.load(std::memory_order_relaxed);
+				throttle.SetRate(rate);
+			}
+
+			bool written = true;
+			List(folder, ticket, recurse, filter, &throttle, [&](Record const& record) { written = written && Put(ring, *shared, record); });
+			ring.claimed_.store(0, std::memory_order_release);
+			if (!written)
+				break;
+			SetEvent(ready);
+		}
+		result = EXIT_SUCCESS;
+	}
+
+	if (view)
+		UnmapViewOfFile(view);
+	for (HANDLE h : { mapping, queueLock, work, ready })
+		if (h)
+			CloseHandle(h);
+	return result;
+}
+
+// Lists a folder as ScanEngine::Work does, with the visitor's filter and stat done here, so the browser only
+// gets what it keeps.
+
+void ProcessScan::List(std::string const& folder, unsigned long long ticket, bool recurse, std::regex const& filter, ScanThrottle* throttle, std::function<void(Record const&)> const& emit) {
+	if (throttle)
+		throttle->Take();
+
+	Record const listed = { LISTED, 0, ScanEngine::Stamp(folder), folder };
+	emit(listed);
+
+	unsigned long long searched = 0;
+	std::error_code ec;
+	std::tr2::sys::directory_iterator d(folder, ec);
+	std::tr2::sys::directory_iterator e;
+
+	for (; !ec && d != e; d.increment(ec))
+	{
+		++searched;
+		std::error_code sec;
+		std::tr2::sys::file_status const status = d->status(sec);
+		if (sec)
+			emit(Failed(sec, d->path().string()));
+		else if (is_directory(status))
+		{
+			if (recurse)
+			{
+				Record const sub = { SUBFOLDER, 0, 0, d->path().string() };
+				emit(sub);
+			}
+		}
+		else
+		{
+			std::string ext = d->path().extension();
+			if (!std::regex_match(ext, filter))
+				continue;
+
+			if (throttle)
+				throttle->Take();
+			std::error_code fec;
+			FileEntry const entry = ScanEngine::Describe(d->path(), fec);
+			if (fec)
+				emit(Failed(fec, entry.path_));
+			else
+			{
+				Record const match = { MATCH, entry.size_, entry.mtime_, entry.path_ };
+				emit(match);
+			}
+		}
+	}
+
+	if (ec)
+		emit(Failed(ec, folder));
+
+	Record const done = { DONE, ticket, static_cast<long long>(searched), std::string() };
+	emit(done);
+}
+
+bool ProcessScan::Checkpoint(std::function<void(std::vector<std::string> const& pending)> const& save) {
+	std::vector<std::string> pending;
+	pending.reserve(outstanding_.size());
+	for (auto const& o : outstanding_)
+		pending.push_back(o.second);
+	save(pending);
+	return true;
+}
+
+// The block is named after the browser and a running number, so two scans never attach to each other's. The
+// workers are put in a job that closes with the browser, so a browser that is killed does not leave them behind.
+
+bool ProcessScan::Open(bool recurse, std::string const& filter) {
+	if (filter.size() >= MAX_FILTER)
+		return false;
+
+	name_ = "Local\\TUIFileBrowser-scan-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(nextScan++);
+	unsigned long long const size = RingAt(processes_);
+	mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), name_.c_str());
+	char* view = mapping_ ? static_cast<char*>(MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, 0)) : nullptr;
+	queueLock_ = CreateMutexA(NULL, FALSE, (name_ + "-queue").c_str());
+	work_ = CreateEventA(NULL, TRUE, FALSE, (name_ + "-work").c_str());
+	ready_ = CreateEventA(NULL, FALSE, FALSE, (name_ + "-ready").c_str());
+	if (!view || !queueLock_ || !work_ || !ready_)
+	{
+		if (view)
+			UnmapViewOfFile(view);
+		Close();
+		return false;
+	}
+
+	shared_ = new (view) Shared();
+	std::memcpy(shared_->magic_, MAGIC, sizeof(MAGIC));
+	shared_->workers_ = processes_;
+	shared_->recurse_ = recurse ? 1 : 0;
+	std::memcpy(shared_->filter_, filter.c_str(), filter.size() + 1);
+	shared_->stop_ = 0;
+	shared_->background_ = throttle_ && throttle_->IsBackground() ? 1 : 0;
+	shared_->rate_ = 0;
+	shared_->head_ = 0;
+	shared_->tail_ = 0;
+	slots_ = reinterpret_cast<Slot*>(view + SlotsAt());
+
+	job_ = CreateJobObjectA(NULL, NULL);
+	if (job_)
+	{
+		JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits = {};
+		limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+		SetInformationJobObject(job_, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+	}
+
+	workers_.assign(processes_, Worker());
+	for (unsigned w = 0; w < processes_; ++w)
+	{
+		workers_[w].ring_ = new (view + RingAt(w)) Ring();
+		Start(w);
+	}
+	return true;
+}
+
+// Started suspended, so it is in the job before it can do anything.
+
+bool ProcessScan::Start(unsigned w) {
+	Worker& worker = workers_[w];
+	++worker.starts_;
+	worker.held_.clear();
+	worker.ring_->claimed_ = 0;
+	worker.ring_->written_ = 0;
+	worker.ring_->read_ = 0;
+
+	char exe[MAX_PATH];
+	DWORD const n = GetModuleFileNameA(NULL, exe, MAX_PATH);
+	if (n == 0 || n >= MAX_PATH)
+		return false;
+
+	std::string const command = "\"" + std::string(exe) + "\" --scan-worker " + name_ + " " + std::to_string(w);
+	std::vector<char> line(command.begin(), command.end());
+	line.push_back('\0');
+
+	STARTUPINFOA startup = {};
+	startup.cb = sizeof(startup);
+	if (!CreateProcessA(exe, line.data(), NULL, NULL, FALSE, CREATE_NO_WINDOW | CREATE_SUSPENDED, NULL, NULL, &startup, &worker.process_))
+		return false;
+
+	if (job_)
+		AssignProcessToJobObject(job_, worker.process_.hProcess);
+	ResumeThread(worker.process_.hThread);
+	worker.alive_ = true;
+	return true;
+}
+
+void ProcessScan::Publish() {
+	if (backlog_.empty() || !Lock(queueLock_))
+		return;
+
+	bool published = false;
+	while (!backlog_.empty() && shared_->tail_ - shared_->head_ < QUEUE_SLOTS)
+	{
+		unsigned long long const ticket = backlog_.front();
+		backlog_.pop_front();
+
+		std::string const& folder = outstanding_[ticket];
+		if (folder.size() >= SLOT_PATH)
+		{
+			here_.push_back(ticket);
+			continue;
+		}
+
+		Slot& slot = slots_[shared_->tail_ % QUEUE_SLOTS];
+		slot.ticket_ = ticket;
+		std::memcpy(slot.path_, folder.c_str(), folder.size() + 1);
+		++shared_->tail_;
+		published = true;
+	}
+	ReleaseMutex(queueLock_);
+
+	if (published)
+		SetEvent(work_);
+}
+
+std::size_t ProcessScan::Drain(unsigned w, FileVisitor const& visit, FolderVisitor const& enter) {
+	Worker& worker = workers_[w];
+	std::size_t read = 0;
+	Record record;
+	while (Take(*worker.ring_, record))
+	{
+		++read;
+		bool const done = record.type_ == DONE;
+		worker.held_.push_back(std::move(record));
+		if (done)
+			Commit(w, worker.held_, visit, enter);
+	}
+	return read;
+}
+
+// A folder whose ticket is no longer outstanding was handed on already, so its records are dropped rather than
+// counted twice.
+
+void ProcessScan::Commit(unsigned w, std::vector<Record>& records, FileVisitor const& visit, FolderVisitor const& enter) {
+	auto const it = outstanding_.find(records.back().a_);
+	if (it == outstanding_.end())
+	{
+		records.clear();
+		return;
+	}
+
+	if (progress_)
+		progress_->Enter(w, it->second);
+	attempts_.erase(it->first);
+	outstanding_.erase(it);
+
+	long long queued = 0;
+	for (auto const& record : records)
+	{
+		switch (record.type_)
+		{
+			case MATCH:
+				visit(w, FileEntry(record.path_, record.a_, record.b_));
+				break;
+			case SUBFOLDER:
+				Queue(record.path_);
+				++queued;
+				break;
+			case LISTED:
+				++listed_;
+				if (enter)
+					enter(w, FolderEntry(record.path_, record.b_));
+				break;
+			case FAILED:
+				errors_.Count(std::error_code(static_cast<int>(record.a_), record.b_ ? std::system_category() : std::generic_category()), record.path_);
+				break;
+			case DONE:
+				searched_ += static_cast<unsigned long long>(record.b_);
+				if (progress_)
+					progress_->Listed(w, static_cast<unsigned long long>(record.b_));
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (progress_)
+		progress_->Queued(w, queued - 1);
+	records.clear();
+}
+
+void ProcessScan::Requeue(unsigned w) {
+	unsigned long long const ticket = workers_[w].ring_->claimed_.load(std::memory_order_acquire);
+	if (ticket == 0 || outstanding_.find(ticket) == outstanding_.end())
+		return;
+
+	bool queued = false;
+	if (Lock(queueLock_))
+	{
+		for (unsigned long long i = shared_->head_; i < shared_->tail_ && !queued; ++i)
+			queued = slots_[i % QUEUE_SLOTS].ticket_ == ticket;
+		ReleaseMutex(queueLock_);
+	}
+	if (queued)
+		return;
+
+	if (++attempts_[ticket] >= MAX_ATTEMPTS)
+		here_.push_back(ticket);
+	else
+		backlog_.push_front(ticket);
+}
+
+void ProcessScan::Reclaim() {
+	if (shared_ && Lock(queueLock_))
+	{
+		for (; shared_->head_ < shared_->tail_; ++shared_->head_)
+			here_.push_back(slots_[shared_->head_ % QUEUE_SLOTS].ticket_);
+		ReleaseMutex(queueLock_);
+	}
+	here_.insert(here_.end(), backlog_.begin(), backlog_.end());
+	backlog_.clear();
+}
+
+void ProcessScan::ListHere(unsigned long long ticket, FileVisitor const& visit, FolderVisitor const& enter) {
+	auto const it = outstanding_.find(ticket);
+	if (it == outstanding_.end())
+		return;
+
+	std::vector<Record> records;
+	List(it->second, ticket, recurse_, filter_, throttle_, [&records](Record const& record) { records.push_back(record); });
+	Commit(0, records, visit, enter);
+}
+
+void ProcessScan::Queue(std::string const& folder) {
+	unsigned long long const ticket = nextTicket_++;
+	outstanding_[ticket] = folder;
+	backlog_.push_back(ticket);
+}
+
+void ProcessScan::Close() {
+	if (shared_)
+	{
+		shared_->stop_.store(1, std::memory_order_relaxed);
+		SetEvent(work_);
+	}
+
+	for (auto& worker : workers_)
+	{
+		if (!worker.alive_)
+			continue;
+		if (WaitForSingleObject(worker.process_.hProcess, STOP_WAIT_MS) != WAIT_OBJECT_0)
+			TerminateProcess(worker.process_.hProcess, EXIT_FAILURE);
+		CloseHandle(worker.process_.hProcess);
+		CloseHandle(worker.process_.hThread);
+		worker.alive_ = false;
+	}
+	workers_.clear();
+
+	if (shared_)
+		UnmapViewOfFile(shared_);
+	shared_ = nullptr;
+	slots_ = nullptr;
+	for (HANDLE* h : { &mapping_, &queueLock_, &work_, &ready_, &job_ })
+	{
+		if (*h)
+			CloseHandle(*h);
+		*h = NULL;
+	}
+}
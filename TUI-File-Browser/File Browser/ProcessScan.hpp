@@ -0,0 +1,226 @@
+/** @file : ProcessScan.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the scan that spreads a walk over worker processes.
+History : Added for trees whose metadata is slow enough that one process's threads stop gaining.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __PROCESS_SCAN_GUARD__
+#define __PROCESS_SCAN_GUARD__
+
+#include "ScanEngine.hpp"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <regex>
+#include <functional>
+#include <unordered_map>
+#include <Windows.h>
+
+class ScanThrottle;
+class ScanProgress;
+
+
+// Walks roots with worker processes: copies of the browser started with --scan-worker, sharing one block of
+// memory with it. The browser keeps the queue of folders to list and publishes them into a bounded queue in the
+// shared block, under a named mutex; a worker claims one, lists it, stats the files that match the filter and
+// writes what it found to a ring buffer of its own in the shared block, ending with a record that the folder is
+// done. The browser reads the rings, holding back a folder's records until its done record arrives, and only
+// then hands its files and folders to the visitors and queues its sub-folders.
+//
+// A worker that dies loses nothing: the records of the folder it was listing are dropped, the folder goes back on
+// the queue and a new worker takes its place, so the files found are the same as with ScanEngine. A folder that
+// takes down MAX_ATTEMPTS workers, and a path too long for the shared queue, is listed by the browser itself.
+
+class ProcessScan
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		typedef std::function<void(unsigned worker, FileEntry const& file)> FileVisitor;
+		typedef std::function<void(unsigned worker, FolderEntry const& folder)> FolderVisitor;
+
+		// Workers a folder may take down before the browser lists it itself, and workers started in a slot.
+		static unsigned const MAX_ATTEMPTS = 3;
+		static unsigned const MAX_STARTS = 4;
+
+		// What a worker writes to its ring. Every record has the same shape: two numbers and a path.
+		enum RecordType
+		{
+			PAD,		// the rest of the ring is unused; the next record starts at its beginning
+			MATCH,		// a file that matched: size and last write time
+			SUBFOLDER,	// a sub-folder to queue
+			LISTED,		// the folder being listed, with its stamp
+			FAILED,		// an entry that could not be read: error code, and 1 if it is a system error
+			DONE		// the folder is done: its ticket, and the entries looked at
+		};
+
+		struct Record
+		{
+			RecordType			type_;
+			unsigned long long	a_;
+			long long			b_;
+			std::string			path_;
+		};
+
+		// How the shared block is laid out; defined where it is used.
+		struct Shared;
+		struct Slot;
+		struct Ring;
+
+	private:
+		// One worker process: its slot in the shared block, the records read since its last done record, and
+		// the process itself.
+		struct Worker
+		{
+			Ring*					ring_;
+			std::vector<Record>		held_;
+			PROCESS_INFORMATION		process_;
+			unsigned				starts_;
+			bool					alive_;
+
+			Worker() : ring_(nullptr), process_(), starts_(0), alive_(false) { };
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::vector<std::string>	roots_;
+		unsigned					processes_;
+
+		// The shared block and the named objects that go with it.
+		std::string			name_;
+		HANDLE				mapping_;
+		Shared*				shared_;
+		Slot*				slots_;
+		HANDLE				queueLock_;		// mutex over the shared queue
+		HANDLE				work_;			// set while the shared queue has folders
+		HANDLE				ready_;			// set by a worker when it finishes a folder
+		HANDLE				job_;			// takes the workers down with the browser
+
+		std::vector<Worker>		workers_;
+
+		// Folders not yet done, by ticket, and those not yet published; how many workers each took down.
+		std::unordered_map<unsigned long long, std::string>		outstanding_;
+		std::unordered_map<unsigned long long, unsigned>		attempts_;
+		std::deque<unsigned long long>							backlog_;
+		std::deque<unsigned long long>							here_;		// to be listed by the browser itself
+		unsigned long long										nextTicket_;
+
+		bool			recurse_;
+		std::regex		filter_;
+
+		std::vector<std::string>	start_;
+		bool						resumed_;
+
+		unsigned long long	searched_;
+		unsigned long long	listed_;
+		unsigned			crashes_;
+		ScanErrors			errors_;
+		ScanThrottle*		throttle_;
+		ScanProgress*		progress_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+
+		 // Sets up a walk of roots, which should be MultiScan's, by processes workers.
+
+		ProcessScan(std::vector<std::string> const& roots, unsigned processes);
+		~ProcessScan();
+
+		ProcessScan(ProcessScan const&) = delete;
+		void operator=(ProcessScan const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Walks the roots (and their sub-folders when recurse is set), calling visit for every file whose
+		 // extension matches filter and enter for every folder listed, both on this thread, and tick every 100ms.
+		 // Worker numbers are below GetProcessCount(). Falls back on listing every folder on this thread if no
+		 // worker can be started.
+
+		void Run(bool recurse, std::string const& filter, FileVisitor const& visit, ScanEngine::Tick const& tick = ScanEngine::Tick(), FolderVisitor const& enter = FolderVisitor());
+
+		 // Body of a worker process: attaches to the shared block called name and lists folders into ring index
+		 // until the browser says stop. Returns the process's exit code.
+
+		static int Serve(std::string const& name, unsigned index);
+
+		 // Lists folder as a worker does, passing each record to emit and ending with its done record.
+
+		static void List(std::string const& folder, unsigned long long ticket, bool recurse, std::regex const& filter, ScanThrottle* throttle, std::function<void(Record const&)> const& emit);
+
+		 // As MultiScan::SetStart.
+
+		void SetStart(std::vector<std::string> const& folders) { start_ = folders; resumed_ = true; }
+
+		 // As MultiScan::Checkpoint. Results are only handed on once a folder is done, so from the tick they always
+		 // match the folders not yet done, and nothing needs pausing.
+
+		bool Checkpoint(std::function<void(std::vector<std::string> const& pending)> const& save);
+
+		 // The workers follow throttle's background mode and share its rate evenly.
+
+		void SetThrottle(ScanThrottle* throttle) { throttle_ = throttle; }
+
+		 // Publishes each folder done to progress, in the slot of the worker that listed it.
+
+		void SetProgress(ScanProgress* progress) { progress_ = progress; }
+
+	// -------- ACCESSORS --------
+	public:
+		unsigned GetProcessCount() const { return processes_; }
+		unsigned long long GetSearched() const { return searched_; }
+		unsigned long long GetListed() const { return listed_; }
+		unsigned GetCrashCount() const { return crashes_; }
+		ScanErrors& GetErrors() { return errors_; }
+		ScanErrors const& GetErrors() const { return errors_; }
+
+	private:
+
+		 // Creates the shared block and named objects, and starts the workers. Returns false if the block
+		 // cannot be made.
+
+		bool Open(bool recurse, std::string const& filter);
+
+		 // Starts the worker in slot w, with an empty ring. Returns false if it cannot be started.
+
+		bool Start(unsigned w);
+
+		 // Moves folders from the backlog into the shared queue while it has room.
+
+		void Publish();
+
+		 // Reads worker w's ring, handing on every folder done. Returns the records read.
+
+		std::size_t Drain(unsigned w, FileVisitor const& visit, FolderVisitor const& enter);
+
+		 // Hands on the records of a folder done by worker w: its files and folders to the visitors, and its
+		 // sub-folders to the backlog.
+
+		void Commit(unsigned w, std::vector<Record>& records, FileVisitor const& visit, FolderVisitor const& enter);
+
+		 // Puts the folder worker w was listing when it died back in the backlog, unless it is still in the
+		 // shared queue or was done after all; after MAX_ATTEMPTS, it goes to the browser's own list instead.
+
+		void Requeue(unsigned w);
+
+		 // Moves everything in the shared queue and the backlog to the browser's own list, once no worker is left.
+
+		void Reclaim();
+
+		 // Lists the folder with ticket on this thread and hands it on at once.
+
+		void ListHere(unsigned long long ticket, FileVisitor const& visit, FolderVisitor const& enter);
+
+		 // Queues folder under a new ticket.
+
+		void Queue(std::string const& folder);
+
+		 // Stops the workers and lets go of the shared block.
+
+		void Close();
+};
+
+#endif
@@ -0,0 +1,110 @@
+/** @file : Progress.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the counters a scan publishes while it runs.
+History : Added so the footer can show a long scan's progress instead of staying blank until it returns.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Progress.hpp"
+
+#include <cstring>
+
+
+namespace {
+	// Times the reader tries to copy a folder that keeps changing before keeping the one it had.
+	unsigned const READ_ATTEMPTS = 4;
+}
+
+
+// -------- CONSTRUCTOR --------
+ScanProgress::ScanProgress() : workers_(0), tickets_(0), start_(std::chrono::steady_clock::now()) {
+}
+
+// -------- OPERATIONS --------
+
+void ScanProgress::Reset(unsigned workers) {
+	if (workers != workers_)
+		slots_.reset(new Slot[workers ? workers : 1]);
+	workers_ = workers;
+
+	for (unsigned i = 0; i < (workers ? workers : 1); ++i)
+	{
+		Slot& slot = slots_[i];
+		slot.entries_ = 0;
+		slot.matched_ = 0;
+		slot.bytes_ = 0;
+		slot.pending_ = 0;
+		slot.sequence_ = 0;
+		slot.started_ = 0;
+		slot.folder_[0] = '\0';
+	}
+
+	tickets_ = 0;
+	start_ = std::chrono::steady_clock::now();
+}
+
+// The sequence count is made odd before the folder is written and even again after, with fences so the reader
+// cannot see the new count without the new folder. The ticket tells the reader which worker started last.
+
+void ScanProgress::Enter(unsigned worker, std::string const& folder) {
+	Slot& slot = slots_[worker];
+	std::size_t const from = folder.size() > MAX_FOLDER ? folder.size() - MAX_FOLDER : 0;
+
+	unsigned const sequence = slot.sequence_.load(std::memory_order_relaxed);
+	slot.sequence_.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	std::memcpy(slot.folder_, folder.data() + from, folder.size() - from);
+	slot.folder_[folder.size() - from] = '\0';
+	slot.started_.store(tickets_.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+	slot.sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+ScanProgress::Reading ScanProgress::Read() const {
+	Reading reading;
+	reading.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+
+	unsigned long long latest = 0;
+	for (unsigned i = 0; i < workers_; ++i)
+	{
+		Slot const& slot = slots_[i];
+		reading.entries_ += slot.entries_.load(std::memory_order_relaxed);
+		reading.matched_ += slot.matched_.load(std::memory_order_relaxed);
+		reading.bytes_ += slot.bytes_.load(std::memory_order_relaxed);
+		reading.pending_ += slot.pending_.load(std::memory_order_relaxed);
+
+		if (slot.started_.load(std::memory_order_relaxed) <= latest)
+			continue;
+
+		for (unsigned attempt = 0; attempt < READ_ATTEMPTS; ++attempt)
+		{
+			unsigned const before = slot.sequence_.load(std::memory_order_acquire);
+			if (before & 1)
+				continue;
+
+			char folder[MAX_FOLDER + 1];
+			std::memcpy(folder, slot.folder_, sizeof(folder));
+			unsigned long long const started = slot.started_.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (slot.sequence_.load(std::memory_order_relaxed) == before)
+			{
+				folder[MAX_FOLDER] = '\0';
+				if (started > latest)
+				{
+					latest = started;
+					reading.folder_ = folder;
+				}
+				break;
+			}
+		}
+	}
+
+	// Folders are queued before the worker that lists them counts them off, so a reading taken in between is
+	// briefly behind, never ahead.
+	if (reading.pending_ < 0)
+		reading.pending_ = 0;
+	return reading;
+}
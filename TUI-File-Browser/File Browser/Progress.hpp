@@ -0,0 +1,107 @@
+/** @file : Progress.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the counters a scan publishes while it runs.
+History : Added so the footer can show a long scan's progress instead of staying blank until it returns.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __PROGRESS_GUARD__
+#define __PROGRESS_GUARD__
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+
+
+// What a running scan has got through, written by its workers and read by the thread drawing the footer. Each
+// worker has a slot of its own and only ever writes to that slot, so the counters are plain relaxed stores
+// rather than shared read-modify-writes; a slot's counters sit a folder's length away from the next slot's, so
+// workers do not contend for a cache line either. The folder a worker is listing is kept in its slot under a
+// sequence count: the reader copies it and retries if the count moved, so neither side takes a lock. The reader
+// adds the slots up.
+
+class ScanProgress
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// Longest folder kept; a longer one keeps its last part, which is the part that moves.
+		static std::size_t const MAX_FOLDER = 260;
+
+		// One reading of the counters, summed over the workers.
+		struct Reading
+		{
+			double				seconds_;	// since the scan started
+			unsigned long long	entries_;	// files and folders listed
+			long long			pending_;	// folders queued and not yet listed
+			unsigned long long	matched_;
+			unsigned long long	bytes_;		// size of the matched files
+			std::string			folder_;	// the folder most recently started
+
+			Reading() : seconds_(0), entries_(0), pending_(0), matched_(0), bytes_(0) { };
+		};
+
+	private:
+		struct Slot
+		{
+			std::atomic<unsigned long long>	entries_;
+			std::atomic<unsigned long long>	matched_;
+			std::atomic<unsigned long long>	bytes_;
+			std::atomic<long long>			pending_;	// may go below zero: one worker queues what another lists
+
+			std::atomic<unsigned>			sequence_;	// odd while folder_ is being written
+			std::atomic<unsigned long long>	started_;	// ticket of the folder in folder_
+			char							folder_[MAX_FOLDER + 1];
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::unique_ptr<Slot[]>					slots_;
+		unsigned								workers_;
+		std::atomic<unsigned long long>			tickets_;
+		std::chrono::steady_clock::time_point	start_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		ScanProgress();
+
+		ScanProgress(ScanProgress const&) = delete;
+		void operator=(ScanProgress const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Zeroes the counters and makes room for workers slots. Not to be called while a scan is publishing.
+
+		void Reset(unsigned workers);
+
+		 // Called by a worker as it starts listing folder.
+
+		void Enter(unsigned worker, std::string const& folder);
+
+		 // Called by a worker for every file and folder it lists, and for every file it keeps.
+
+		void Listed(unsigned worker, unsigned long long entries = 1) { Bump(slots_[worker].entries_, entries); }
+		void Matched(unsigned worker, unsigned long long bytes) { Bump(slots_[worker].matched_, 1); Bump(slots_[worker].bytes_, bytes); }
+
+		 // Called by a worker when it queues folders, and when it takes one off the queue.
+
+		void Queued(unsigned worker, long long folders) { slots_[worker].pending_.store(slots_[worker].pending_.load(std::memory_order_relaxed) + folders, std::memory_order_relaxed); }
+
+		 // Adds up the slots. Safe to call while the workers run.
+
+		Reading Read() const;
+
+	// -------- ACCESSORS --------
+	public:
+		unsigned GetWorkerCount() const { return workers_; }
+
+	private:
+
+		// Only the slot's own worker writes a counter, so a load and a store do the work of a fetch_add.
+		static void Bump(std::atomic<unsigned long long>& counter, unsigned long long by) { counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed); }
+};
+
+#endif
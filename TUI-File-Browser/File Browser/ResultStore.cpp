@@ -0,0 +1,282 @@
+/** @file : ResultStore.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the result set that moves to disk when a scan outgrows its memory budget.
+History : Added so a scan of tens of millions of files can run on a machine without the memory to hold them.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "ResultStore.hpp"
+#include "Snapshot.hpp"
+
+#include <queue>
+#include <atomic>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+
+
+namespace {
+	// Most chunks merged at once. Each one being read holds a snapshot reader's buffer, so with more chunks
+	// than this they are merged in rounds, into fewer, larger chunks, until they are few enough.
+	std::size_t const MAX_FAN_IN = 32;
+
+	// Bytes buffered while the paged file is written.
+	std::size_t const BUFFER_SIZE = 1024 * 1024;
+
+	// Number of the next spill file. Kept out of TempPath, where a static would be set up unguarded by the first
+	// of several threads to get there.
+	std::atomic<unsigned> nextSpill(0);
+
+	// What Get returns for a file past the end or on a page that cannot be read, kept out of Get for the same reason.
+	FileEntry const missing;
+
+	// Seven bits per byte, lowest first, as in a snapshot.
+	char* PutVarint(char* out, unsigned long long value) {
+		while (value >= 0x80)
+		{
+			*out++ = static_cast<char>(value | 0x80);
+			value >>= 7;
+		}
+		*out++ = static_cast<char>(value);
+		return out;
+	}
+
+	bool GetVarint(char const*& p, char const* end, unsigned long long& value) {
+		value = 0;
+		for (unsigned shift = 0; p < end && shift < 64; shift += 7)
+		{
+			unsigned char const byte = static_cast<unsigned char>(*p++);
+			value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+
+	unsigned long long ZigZag(long long value) {
+		return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+	}
+
+	long long UnZigZag(unsigned long long value) {
+		return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+	}
+
+	// Calls add for every file of the chunks and of files, which are each sorted, in path order. Returns false
+	// if a chunk cannot be read to its end.
+	bool Merge(std::vector<std::string> const& chunks, std::vector<FileEntry> const& files, std::function<void(FileEntry const&)> const& add) {
+		std::vector<std::unique_ptr<SnapshotReader>> readers;
+		std::vector<FileEntry> heads;
+		for (auto const& chunk : chunks)
+		{
+			readers.push_back(std::unique_ptr<SnapshotReader>(new SnapshotReader(chunk)));
+			if (!readers.back()->IsValid())
+				return false;
+			heads.push_back(FileEntry());
+		}
+
+		// The heap holds the index of each source with a file left, the one with the first path on top; the
+		// files vector is the source after the last chunk.
+		std::size_t next = 0;
+		auto head = [&](std::size_t source) -> FileEntry const& { return source < readers.size() ? heads[source] : files[next]; };
+		auto later = [&](std::size_t a, std::size_t b) { return head(a).path_ > head(b).path_; };
+		std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> heap(later);
+
+		for (std::size_t r = 0; r < readers.size(); ++r)
+			if (readers[r]->Next(heads[r]))
+				heap.push(r);
+		if (!files.empty())
+			heap.push(readers.size());
+
+		unsigned long long read = 0;
+		while (!heap.empty())
+		{
+			std::size_t const source = heap.top();
+			heap.pop();
+			add(head(source));
+
+			if (source < readers.size())
+			{
+				++read;
+				if (readers[source]->Next(heads[source]))
+					heap.push(source);
+			}
+			else if (++next < files.size())
+				heap.push(source);
+		}
+
+		unsigned long long expected = 0;
+		for (auto const& reader : readers)
+			expected += reader->GetCount();
+		return read == expected;
+	}
+}
+
+
+// -------- CONSTRUCTOR/DESTRUCTOR --------
+ResultStore::ResultStore(unsigned long long budget, unsigned workers) : budget_(budget), share_(budget / (workers ? workers : 1)), spilled_(0), spills_(0), count_(0), bytes_(0), pageAt_(~0ull) {
+}
+
+ResultStore::~ResultStore() {
+	pages_.reset();
+	if (!path_.empty())
+		DeleteFileA(path_.c_str());
+	for (auto const& chunk : chunks_)
+		DeleteFileA(chunk.c_str());
+}
+
+// -------- OPERATIONS --------
+
+// The chunk is written outside the lock, so workers spilling at the same time write side by side.
+
+bool ResultStore::Spill(std::vector<FileEntry>& files) {
+	std::string const chunk = TempPath(".chunk");
+	if (chunk.empty())
+		return false;
+
+	std::sort(files.begin(), files.end(), [](FileEntry const& a, FileEntry const& b) { return a.path_ < b.path_; });
+	SnapshotWriter writer(chunk, std::string(), 0);
+	for (auto const& f : files)
+		writer.Add(f);
+	if (!writer.Close())
+		return false;
+
+	{
+		std::lock_guard<std::mutex> lk(lock_);
+		chunks_.push_back(chunk);
+		spilled_ += files.size();
+		++spills_;
+	}
+
+	std::vector<FileEntry>().swap(files);
+	return true;
+}
+
+// A page starts with a whole path and every later path on it only stores what differs from the one before,
+// so a page can be decoded without reading any other. Merged chunks are deleted as soon as they are read.
+
+bool ResultStore::Finish(std::vector<FileEntry>& files) {
+	while (chunks_.size() > MAX_FAN_IN)
+	{
+		std::vector<std::string> round(chunks_.begin(), chunks_.begin() + MAX_FAN_IN);
+		std::string const merged = TempPath(".chunk");
+		if (merged.empty())
+			return false;
+
+		SnapshotWriter writer(merged, std::string(), 0);
+		bool const read = Merge(round, std::vector<FileEntry>(), [&](FileEntry const& f) { writer.Add(f); });
+		if (!writer.Close() || !read)
+		{
+			DeleteFileA(merged.c_str());
+			return false;
+		}
+
+		for (auto const& chunk : round)
+			DeleteFileA(chunk.c_str());
+		chunks_.erase(chunks_.begin(), chunks_.begin() + MAX_FAN_IN);
+		chunks_.push_back(merged);
+	}
+
+	path_ = TempPath(".pages");
+	if (path_.empty())
+		return false;
+
+	std::vector<char> buffer(BUFFER_SIZE);
+	std::ofstream out;
+	out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+	out.open(path_, std::ios::binary | std::ios::trunc);
+
+	unsigned long long at = 0;
+	std::string previous;
+	count_ = 0;
+	bytes_ = 0;
+	offsets_.clear();
+
+	bool const merged = Merge(chunks_, files, [&](FileEntry const& f) {
+		if (count_ % PAGE_FILES == 0)
+		{
+			offsets_.push_back(at);
+			previous.clear();
+		}
+
+		std::size_t shared = 0;
+		std::size_t const most = std::min(previous.size(), f.path_.size());
+		while (shared < most && previous[shared] == f.path_[shared])
+			++shared;
+
+		char numbers[40];
+		char* p = PutVarint(numbers, shared);
+		p = PutVarint(p, f.path_.size() - shared);
+		out.write(numbers, p - numbers);
+		out.write(f.path_.data() + shared, f.path_.size() - shared);
+		at += (p - numbers) + (f.path_.size() - shared);
+
+		p = PutVarint(numbers, f.size_);
+		p = PutVarint(p, ZigZag(f.mtime_));
+		out.write(numbers, p - numbers);
+		at += p - numbers;
+
+		previous = f.path_;
+		bytes_ += f.size_;
+		++count_;
+	});
+	offsets_.push_back(at);
+	out.close();
+
+	std::vector<FileEntry>().swap(files);
+	if (!merged || out.fail())
+		return false;
+
+	for (auto const& chunk : chunks_)
+		DeleteFileA(chunk.c_str());
+	chunks_.clear();
+
+	pages_.reset(new MappedFile(path_));
+	return pages_->IsOpen();
+}
+
+FileEntry const& ResultStore::Get(unsigned long long i) const {
+	unsigned long long const page = i / PAGE_FILES;
+	if (!pages_ || page + 1 >= offsets_.size())
+		return missing;
+
+	if (page != pageAt_)
+	{
+		page_.clear();
+		pageAt_ = page;
+
+		std::size_t const length = static_cast<std::size_t>(offsets_[page + 1] - offsets_[page]);
+		char const* p = pages_->Map(offsets_[page], length);
+		char const* const end = p ? p + length : nullptr;
+
+		std::string path;
+		while (p && p < end)
+		{
+			unsigned long long shared, rest, size, mtime;
+			if (!GetVarint(p, end, shared) || !GetVarint(p, end, rest) || shared > path.size() || rest > static_cast<unsigned long long>(end - p))
+				break;
+
+			path.resize(static_cast<std::size_t>(shared));
+			path.append(p, static_cast<std::size_t>(rest));
+			p += rest;
+			if (!GetVarint(p, end, size) || !GetVarint(p, end, mtime))
+				break;
+
+			page_.push_back(FileEntry(path, size, UnZigZag(mtime)));
+		}
+		pages_->Unmap();
+	}
+
+	std::size_t const at = static_cast<std::size_t>(i % PAGE_FILES);
+	return at < page_.size() ? page_[at] : missing;
+}
+
+// Named after the process and a running number, so two browsers, or two scans in one, never share a file.
+
+std::string ResultStore::TempPath(char const* extension) {
+	std::string const cache = GetCacheFolder();
+	if (cache.empty())
+		return std::string();
+
+	return cache + "spill-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(nextSpill++) + extension;
+}
@@ -0,0 +1,107 @@
+/** @file : ResultStore.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the result set that moves to disk when a scan outgrows its memory budget.
+History : Added so a scan of tens of millions of files can run on a machine without the memory to hold them.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __RESULT_STORE_GUARD__
+#define __RESULT_STORE_GUARD__
+
+#include "ScanEngine.hpp"
+#include "FileIO.hpp"
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <memory>
+
+
+// The files of a scan that did not fit in its memory budget. Each scan worker is allowed an even share of the
+// budget; a worker whose files outgrow its share sorts them and spills them to a chunk on disk, written the way
+// a snapshot is, and starts again. When the scan is done the chunks and whatever is still in memory are merged
+// into one sorted file of pages, each page a fixed number of files with its paths sharing prefixes within it.
+// Only the offset of each page is kept in memory. The file is mapped, and a page is read and decoded when a row
+// on it is asked for, so the viewer costs a page of memory however many files there are.
+
+class ResultStore
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// Files to a page.
+		static unsigned const PAGE_FILES = 256;
+
+	// -------- CLASS MEMBERS --------
+	private:
+		unsigned long long			budget_;
+		unsigned long long			share_;
+
+		std::mutex					lock_;
+		std::vector<std::string>	chunks_;
+		unsigned long long			spilled_;	// files written to chunks, and chunks written
+		unsigned					spills_;
+
+		std::string							path_;
+		std::unique_ptr<MappedFile>			pages_;
+		std::vector<unsigned long long>		offsets_;	// where each page starts, and where the last one ends
+		unsigned long long					count_;
+		unsigned long long					bytes_;		// size of the files
+
+		mutable std::vector<FileEntry>		page_;		// the page last read, and its number
+		mutable unsigned long long			pageAt_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+
+		 // Sets up a store for a scan with workers workers, allowed budget bytes of files between them.
+
+		ResultStore(unsigned long long budget, unsigned workers);
+		~ResultStore();
+
+		ResultStore(ResultStore const&) = delete;
+		void operator=(ResultStore const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // The memory a file kept in a vector costs, as counted against the budget.
+
+		static std::size_t Footprint(FileEntry const& file) { return sizeof(FileEntry) + file.path_.capacity() + 1; }
+
+		 // Sorts files, writes them to a new chunk and empties them, giving their memory back. Safe to call from
+		 // several workers at once. Returns false, leaving files as they were, if the chunk cannot be written.
+
+		bool Spill(std::vector<FileEntry>& files);
+
+		 // Merges the chunks and files, which must be sorted by path, into the paged file, and empties files.
+		 // Returns false if the paged file cannot be written or mapped.
+
+		bool Finish(std::vector<FileEntry>& files);
+
+		 // File i, in path order. Reading along the files, as the viewer and a snapshot do, decodes each page once.
+
+		FileEntry const& Get(unsigned long long i) const;
+
+	// -------- ACCESSORS --------
+	public:
+		// Each worker's share of the budget.
+		unsigned long long GetShare() const { return share_; }
+		unsigned long long GetBudget() const { return budget_; }
+
+		bool IsSpilled() const { return spills_ != 0; }
+		unsigned GetSpillCount() const { return spills_; }
+		unsigned long long GetSpilled() const { return spilled_; }
+
+		unsigned long long GetCount() const { return count_; }
+		unsigned long long GetBytes() const { return bytes_; }
+
+	private:
+
+		 // A new file name in the cache folder for this store to write to.
+
+		static std::string TempPath(char const* extension);
+};
+
+#endif
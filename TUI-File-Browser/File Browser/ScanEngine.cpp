@@ -0,0 +1,798 @@
+/** @file : ScanEngine.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the parallel directory walker used by FileModel::Scan.
+History : Split out of FileModel::Scan so the walk can be spread across worker threads.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "ScanEngine.hpp"
+#include "Throttle.hpp"
+#include "Progress.hpp"
+#include "FileIO.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <algorithm>
+#include <Windows.h>
+
+
+// BusTypeNvme in STORAGE_BUS_TYPE, which the Windows 10 SDK added; the 8.1 SDK's enum stops before it.
+#ifndef STORAGE_BUS_TYPE_NVME
+#define STORAGE_BUS_TYPE_NVME 0x11
+#endif
+
+namespace {
+	// How often the number of workers is tuned, and how much the rate must move to count as a change rather
+	// than noise.
+	std::chrono::milliseconds const TUNE_INTERVAL(500);
+	double const TOLERANCE = 0.05;
+
+	// Most workers any one volume is given.
+	unsigned const MAX_WORKERS = 64;
+
+	// Lower case with '\' separators, so paths typed differently compare equal.
+	std::string Fold(std::string text) {
+		for (auto& c : text)
+			c = c == '/' ? '\\' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+		return text;
+	}
+
+	// The root folder of the volume holding folder, such as c:\ or \\server\share\, or the folder itself
+	// if that cannot be told.
+	std::string VolumeOf(std::string const& folder) {
+		char volume[MAX_PATH];
+		if (!GetVolumePathNameA(folder.c_str(), volume, MAX_PATH))
+			return Fold(folder);
+		return Fold(volume);
+	}
+}
+
+
+// -------- CONSTRUCTOR --------
+ScanEngine::ScanEngine(unsigned threads, unsigned tickMs, unsigned maxThreads) : threads_(std::max(threads ? threads : 1, maxThreads)), tickMs_(tickMs), initial_(threads ? threads : 1), limit_(initial_), direction_(1), lastRate_(0), lastSearched_(0), busy_(0), running_(0), paused_(false), started_(false), pauses_(0), searched_(0), listed_(0), throttle_(nullptr), progress_(nullptr), firstWorker_(0), errors_(&ownErrors_) {
+}
+
+// -------- OPERATIONS --------
+
+// Uses the number of hardware threads reported by the library, falling back to four when
+// the library cannot tell.
+
+unsigned ScanEngine::DefaultThreadCount() {
+	unsigned n = std::thread::hardware_concurrency();
+	return n ? n : 4;
+}
+
+// Stats the file for its size and last write time.
+
+FileEntry ScanEngine::Describe(std::tr2::sys::path const& file) {
+	return FileEntry(file.string(), std::tr2::sys::file_size(file), static_cast<long long>(std::tr2::sys::last_write_time(file)));
+}
+
+FileEntry ScanEngine::Describe(std::tr2::sys::path const& file, std::error_code& ec) {
+	unsigned long long const size = std::tr2::sys::file_size(file, ec);
+	if (ec)
+		return FileEntry(file.string(), 0, 0);
+
+	long long const mtime = static_cast<long long>(std::tr2::sys::last_write_time(file, ec));
+	return FileEntry(file.string(), size, ec ? 0 : mtime);
+}
+
+// One attribute query, which does not open the folder.
+
+long long ScanEngine::Stamp(std::string const& folder) {
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(folder.c_str(), GetFileExInfoStandard, &data))
+		return MISSING;
+
+	return static_cast<long long>((static_cast<unsigned long long>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime);
+}
+
+// Seeds the queue with the root folder and starts the workers. The calling thread then sleeps on the
+// finished condition, waking every tickMs_ to run the tick so the caller can redraw while the walk continues.
+// Once the last worker leaves, the threads are joined and any error a worker stored is rethrown here.
+
+void ScanEngine::Run(std::tr2::sys::path const& root, bool recurse, Visitor const& visit, Tick const& tick, FolderVisitor const& enter) {
+	Run(std::vector<std::tr2::sys::path>(1, root), recurse, visit, tick, enter);
+}
+
+void ScanEngine::Run(std::vector<std::tr2::sys::path> const& roots, bool recurse, Visitor const& visit, Tick const& tick, FolderVisitor const& enter) {
+	// Reset state left over from a previous walk. The queue is set up under the lock, since Pause may be called
+	// from another thread as soon as it is.
+	{
+		std::lock_guard<std::mutex> lk(lock_);
+		pending_.assign(roots.begin(), roots.end());
+		busy_ = 0;
+		running_ = threads_;
+		error_ = nullptr;
+		paused_ = false;
+		started_ = true;
+	}
+	searched_ = 0;
+	listed_ = 0;
+	limit_ = initial_;
+	direction_ = 1;
+	lastRate_ = 0;
+	lastSearched_ = 0;
+	samples_.clear();
+	if (errors_ == &ownErrors_)
+		ownErrors_.Reset();
+	if (progress_)
+		progress_->Queued(firstWorker_, static_cast<long long>(roots.size()));
+
+	std::vector<std::thread> workers;
+	for (unsigned i = 0; i < threads_; ++i)
+		workers.push_back(std::thread(&ScanEngine::Work, this, i, recurse, std::cref(visit), std::cref(enter)));
+
+	// Tick, and tune, while the workers run.
+	auto const start = std::chrono::steady_clock::now();
+	auto tuned = start;
+	unsigned pauses = 0;
+	{
+		std::unique_lock<std::mutex> lk(lock_);
+		while (running_ != 0)
+		{
+			finished_.wait_for(lk, std::chrono::milliseconds(tickMs_));
+
+			// An interval with a pause in it says nothing about the limit, so it is started again instead.
+			auto const now = std::chrono::steady_clock::now();
+			if (pauses != pauses_ || paused_)
+			{
+				pauses = pauses_;
+				lastSearched_ = GetSearched();
+				tuned = now;
+			}
+			else if (running_ != 0 && IsTuned() && now - tuned >= TUNE_INTERVAL)
+			{
+				Tune(std::chrono::duration<double>(now - start).count(), std::chrono::duration<double>(now - tuned).count());
+				tuned = now;
+			}
+
+			if (running_ != 0 && tick)
+			{
+				lk.unlock();
+				tick();
+				lk.lock();
+			}
+		}
+	}
+
+	for (auto& w : workers)
+		w.join();
+
+	if (error_)
+		std::rethrow_exception(error_);
+}
+
+// Each pass takes one folder off the queue and lists it. Sub-folders are collected locally and pushed
+// in one go once the listing is done, so the lock is taken twice per folder rather than once per entry.
+// A worker only gives up when the queue is empty and no other worker is busy, since a busy worker may
+// still push more folders. The listing uses the error_code overloads, so a folder that cannot be opened, or
+// that fails part way, is counted and left behind without unwinding anything; the sub-folders found before a
+// failure part way are still walked. Only an exception from a visitor stops the walk.
+
+void ScanEngine::Work(unsigned worker, bool recurse, Visitor const& visit, FolderVisitor const& enter) {
+	std::vector<std::tr2::sys::path> found;
+	bool background = false;
+
+	for (;;)
+	{
+		std::tr2::sys::path dir;
+		{
+			std::unique_lock<std::mutex> lk(lock_);
+			wake_.wait(lk, [this] { return error_ || (!paused_ && ((!pending_.empty() && busy_ < limit_) || busy_ == 0)); });
+
+			if (pending_.empty() || error_)
+			{
+				// Nothing left to do; let the other workers see the same thing.
+				wake_.notify_all();
+				if (--running_ == 0)
+					finished_.notify_all();
+				if (background)
+					SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+				return;
+			}
+
+			dir = pending_.front();
+			pending_.pop_front();
+			++busy_;
+		}
+
+		if (progress_)
+		{
+			progress_->Queued(firstWorker_ + worker, -1);
+			progress_->Enter(firstWorker_ + worker, dir.string());
+		}
+
+		try
+		{
+			// Background mode can be switched mid-walk, so each folder checks it first.
+			if (throttle_)
+			{
+				if (throttle_->IsBackground() != background)
+				{
+					background = !background;
+					SetThreadPriority(GetCurrentThread(), background ? THREAD_MODE_BACKGROUND_BEGIN : THREAD_MODE_BACKGROUND_END);
+				}
+				throttle_->Take();
+			}
+
+			if (enter)
+				enter(worker, dir);
+
+			listed_.fetch_add(1, std::memory_order_relaxed);
+			std::error_code ec;
+			std::tr2::sys::directory_iterator d(dir, ec);
+			std::tr2::sys::directory_iterator e;
+
+			for (; !ec && d != e; d.increment(ec))
+			{
+				searched_.fetch_add(1, std::memory_order_relaxed);
+				if (progress_)
+					progress_->Listed(firstWorker_ + worker);
+
+				std::error_code sec;
+				std::tr2::sys::file_status const status = d->status(sec);
+				if (sec)
+					errors_->Count(sec, d->path().string());
+				else if (is_directory(status))
+				{
+					if (recurse)
+						found.push_back(d->path());
+				}
+				else
+					visit(worker, d->path());
+			}
+
+			if (ec)
+				errors_->Count(ec, dir.string());
+		}
+		catch (...)
+		{
+			// Keep the first failure from a visitor; the rest of the walk is abandoned.
+			std::lock_guard<std::mutex> lk(lock_);
+			if (!error_)
+				error_ = std::current_exception();
+			found.clear();
+		}
+
+		if (progress_)
+			progress_->Queued(firstWorker_ + worker, static_cast<long long>(found.size()));
+		{
+			std::lock_guard<std::mutex> lk(lock_);
+			pending_.insert(pending_.end(), found.begin(), found.end());
+			--busy_;
+		}
+		wake_.notify_all();
+		found.clear();
+	}
+}
+
+// The workers' wait holds back while paused_ is set, even with the queue empty and none busy, so a walk that
+// ends during a pause still waits for Resume to finish. Each worker notifies wake_ as it finishes a folder,
+// which is what the pause waits on.
+
+bool ScanEngine::Pause() {
+	std::unique_lock<std::mutex> lk(lock_);
+	if (!started_)
+		return false;
+
+	paused_ = true;
+	++pauses_;
+	wake_.wait(lk, [this] { return busy_ == 0; });
+	return true;
+}
+
+void ScanEngine::Resume() {
+	{
+		std::lock_guard<std::mutex> lk(lock_);
+		paused_ = false;
+	}
+	wake_.notify_all();
+}
+
+std::vector<std::string> ScanEngine::GetPending() {
+	std::lock_guard<std::mutex> lk(lock_);
+	std::vector<std::string> pending;
+	pending.reserve(pending_.size());
+	for (auto const& p : pending_)
+		pending.push_back(p.string());
+	return pending;
+}
+
+// A plain hill climb on entries per second. A step that made the rate worse by more than noise is undone by
+// stepping back; a step that changed nothing is followed by a step down, since workers that add nothing only
+// add seeks. The limit so settles on the fewest workers that reach the best rate, and moves again if the
+// device gets busier or quieter. Steps are a quarter of the limit, so a large limit is reached quickly.
+
+void ScanEngine::Tune(double seconds, double interval) {
+	unsigned long long const searched = GetSearched();
+	double const rate = (searched - lastSearched_) / interval;
+	lastSearched_ = searched;
+	samples_.push_back(Sample(seconds, limit_, rate));
+
+	// The first interval is mostly the top folders, which are listed before there is enough work for every
+	// worker, so it is not compared with.
+	if (samples_.size() == 1)
+		return;
+
+	if (lastRate_ > 0 && rate < lastRate_ * (1 - TOLERANCE))
+		direction_ = -direction_;
+	else if (lastRate_ > 0 && rate < lastRate_ * (1 + TOLERANCE))
+		direction_ = -1;
+	lastRate_ = rate;
+
+	// More workers cannot help while fewer folders are waiting than workers are already allowed.
+	if (direction_ > 0 && pending_.size() < limit_)
+		return;
+
+	unsigned const step = std::max(1u, limit_ / 4);
+	if (direction_ > 0)
+		limit_ = std::min(threads_, limit_ + step);
+	else
+		limit_ = limit_ > step ? limit_ - step : 1;
+	wake_.notify_all();
+}
+
+// -------- SCAN ERRORS --------
+
+// The first failure of a kind is the one whose increment took the count from zero, so only it takes the lock.
+
+void ScanErrors::Count(std::error_code const& ec, std::string const& path) {
+	Kind const kind = Classify(ec);
+	if (counts_[kind].fetch_add(1, std::memory_order_relaxed) == 0)
+	{
+		std::lock_guard<std::mutex> lk(lock_);
+		first_[kind] = path;
+	}
+}
+
+void ScanErrors::Add(ScanErrors const& other) {
+	for (int k = 0; k < KINDS; ++k)
+	{
+		unsigned long long const count = other.GetCount(static_cast<Kind>(k));
+		if (count && counts_[k].fetch_add(count, std::memory_order_relaxed) == 0)
+		{
+			std::string const first = other.GetFirst(static_cast<Kind>(k));
+			std::lock_guard<std::mutex> lk(lock_);
+			first_[k] = first;
+		}
+	}
+}
+
+void ScanErrors::Reset() {
+	std::lock_guard<std::mutex> lk(lock_);
+	for (int k = 0; k < KINDS; ++k)
+	{
+		counts_[k] = 0;
+		first_[k].clear();
+	}
+}
+
+// The filesystem reports Windows error codes; the ones a walk meets are told apart here before falling back on
+// the portable conditions they map to.
+
+ScanErrors::Kind ScanErrors::Classify(std::error_code const& ec) {
+	if (ec.category() == std::system_category())
+	{
+		switch (ec.value())
+		{
+			case ERROR_ACCESS_DENIED:
+			case ERROR_SHARING_VIOLATION:
+			case ERROR_PRIVILEGE_NOT_HELD:
+				return DENIED;
+			case ERROR_FILE_NOT_FOUND:
+			case ERROR_PATH_NOT_FOUND:
+			case ERROR_BAD_NETPATH:
+			case ERROR_NOT_READY:
+			case ERROR_DIRECTORY:
+				return VANISHED;
+			case ERROR_FILENAME_EXCED_RANGE:
+			case ERROR_BUFFER_OVERFLOW:
+				return TOO_LONG;
+		}
+	}
+
+	if (ec == std::errc::permission_denied || ec == std::errc::operation_not_permitted)
+		return DENIED;
+	if (ec == std::errc::no_such_file_or_directory || ec == std::errc::not_a_directory || ec == std::errc::no_such_device)
+		return VANISHED;
+	if (ec == std::errc::filename_too_long)
+		return TOO_LONG;
+	return OTHER;
+}
+
+char const* ScanErrors::GetKindName(Kind kind) {
+	switch (kind)
+	{
+		case DENIED: return "denied";
+		case VANISHED: return "gone";
+		case TOO_LONG: return "too long";
+		default: return "other";
+	}
+}
+
+std::string ScanErrors::Summarize() const {
+	unsigned long long const total = GetTotal();
+	if (total == 0)
+		return "No errors";
+
+	std::string summary = std::to_string(total) + " skipped:";
+	std::string first;
+	for (int k = 0; k < KINDS; ++k)
+	{
+		unsigned long long const count = GetCount(static_cast<Kind>(k));
+		if (count == 0)
+			continue;
+
+		summary += " " + std::to_string(count) + " " + GetKindName(static_cast<Kind>(k)) + ",";
+		if (first.empty())
+			first = GetFirst(static_cast<Kind>(k));
+	}
+	summary.back() = ';';
+	return summary + " first " + first;
+}
+
+unsigned long long ScanErrors::GetTotal() const {
+	unsigned long long total = 0;
+	for (int k = 0; k < KINDS; ++k)
+		total += GetCount(static_cast<Kind>(k));
+	return total;
+}
+
+std::string ScanErrors::GetFirst(Kind kind) const {
+	std::lock_guard<std::mutex> lk(lock_);
+	return first_[kind];
+}
+
+// -------- MULTI SCAN --------
+
+// Shorter roots are kept first, so a root below one already kept is seen as such and dropped. The workers are
+// then shared out evenly between the volumes, the first ones taking any left over.
+
+MultiScan::MultiScan(std::vector<std::string> const& roots, bool adapt) : threads_(0), throttle_(nullptr), progress_(nullptr) {
+	std::vector<std::string> prefixes;
+	for (auto const& root : roots)
+	{
+		std::string prefix = Fold(root);
+		while (!prefix.empty() && prefix.back() == '\\')
+			prefix.pop_back();
+		prefixes.push_back(prefix + '\\');
+	}
+
+	std::vector<std::size_t> order(roots.size());
+	for (std::size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&prefixes](std::size_t a, std::size_t b) { return prefixes[a].size() < prefixes[b].size(); });
+
+	std::vector<bool> keep(roots.size(), false);
+	std::vector<std::string> kept;
+	for (auto i : order)
+	{
+		bool inside = false;
+		for (auto const& k : kept)
+			inside = inside || prefixes[i].compare(0, k.size(), k) == 0;
+		if (!inside)
+		{
+			kept.push_back(prefixes[i]);
+			keep[i] = true;
+		}
+	}
+
+	for (std::size_t i = 0; i < roots.size(); ++i)
+	{
+		if (!keep[i])
+			continue;
+
+		roots_.push_back(roots[i]);
+		prefixes_.push_back(prefixes[i]);
+
+		std::string const volume = VolumeOf(roots[i]);
+		auto it = std::find_if(devices_.begin(), devices_.end(), [&volume](Device const& d) { return d.volume_ == volume; });
+		if (it == devices_.end())
+		{
+			devices_.push_back(Device());
+			devices_.back().volume_ = volume;
+			it = devices_.end() - 1;
+		}
+		it->roots_.push_back(roots[i]);
+	}
+
+	unsigned const cores = ScanEngine::DefaultThreadCount();
+	unsigned const count = static_cast<unsigned>(devices_.size());
+	for (unsigned d = 0; d < count; ++d)
+	{
+		Device& device = devices_[d];
+		if (!adapt)
+		{
+			device.threads_ = std::max(1u, cores / count + (d < cores % count ? 1 : 0));
+			device.maxThreads_ = device.threads_;
+		}
+		else
+		{
+			// Where to start, and how far the tuner may go.
+			device.medium_ = Probe(device.volume_);
+			switch (device.medium_)
+			{
+				case ROTATIONAL: device.threads_ = 2; device.maxThreads_ = std::max(4u, cores); break;
+				case SOLID_STATE: device.threads_ = cores; device.maxThreads_ = 2 * cores; break;
+				case NVME: device.threads_ = 2 * cores; device.maxThreads_ = 4 * cores; break;
+				case NETWORK: device.threads_ = 2 * cores; device.maxThreads_ = 8 * cores; break;
+				default: device.threads_ = cores; device.maxThreads_ = 2 * cores; break;
+			}
+			device.threads_ = std::min(device.threads_, MAX_WORKERS);
+			device.maxThreads_ = std::min(device.maxThreads_, MAX_WORKERS);
+		}
+
+		device.firstWorker_ = threads_;
+		threads_ += device.maxThreads_;
+	}
+}
+
+// A single volume is walked on this thread, as a single root always was. Otherwise every volume's engine runs
+// on a thread of its own while this one ticks, waking early when the last of them finishes.
+
+void MultiScan::Run(bool recurse, ScanEngine::Visitor const& visit, ScanEngine::Tick const& tick, ScanEngine::FolderVisitor const& enter) {
+	engines_.clear();
+	errors_.Reset();
+	for (auto const& device : devices_)
+	{
+		engines_.push_back(std::unique_ptr<ScanEngine>(new ScanEngine(device.threads_, 100, device.maxThreads_)));
+		engines_.back()->SetThrottle(throttle_);
+		engines_.back()->SetProgress(progress_, device.firstWorker_);
+		engines_.back()->SetErrors(&errors_);
+	}
+
+	auto pathsOf = [](Device const& device) {
+		std::vector<std::string> const& from = device.resumed_ ? device.start_ : device.roots_;
+		return std::vector<std::tr2::sys::path>(from.begin(), from.end());
+	};
+
+	if (devices_.size() == 1)
+	{
+		engines_[0]->Run(pathsOf(devices_[0]), recurse, visit, tick, enter);
+		Log();
+		return;
+	}
+
+	std::mutex lock;
+	std::condition_variable finished;
+	std::size_t running = devices_.size();
+	std::exception_ptr error;
+
+	std::vector<std::thread> runners;
+	for (std::size_t d = 0; d < devices_.size(); ++d)
+	{
+		runners.push_back(std::thread([&, d] {
+			unsigned const first = devices_[d].firstWorker_;
+			try
+			{
+				engines_[d]->Run(pathsOf(devices_[d]), recurse,
+					[&visit, first](unsigned worker, std::tr2::sys::path const& file) { visit(first + worker, file); },
+					ScanEngine::Tick(),
+					enter ? ScanEngine::FolderVisitor([&enter, first](unsigned worker, std::tr2::sys::path const& folder) { enter(first + worker, folder); }) : ScanEngine::FolderVisitor());
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lk(lock);
+				if (!error)
+					error = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lk(lock);
+			if (--running == 0)
+				finished.notify_all();
+		}));
+	}
+
+	{
+		std::unique_lock<std::mutex> lk(lock);
+		while (running != 0)
+		{
+			finished.wait_for(lk, std::chrono::milliseconds(100));
+			if (running != 0 && tick)
+			{
+				lk.unlock();
+				tick();
+				lk.lock();
+			}
+		}
+	}
+
+	for (auto& r : runners)
+		r.join();
+
+	if (error)
+		std::rethrow_exception(error);
+	Log();
+}
+
+// A folder goes to the device holding the root it is under; RootOf falls back on the first root, which is
+// where a folder under none of them would be walked from anyway.
+
+void MultiScan::SetStart(std::vector<std::string> const& folders) {
+	for (auto& device : devices_)
+	{
+		device.start_.clear();
+		device.resumed_ = true;
+	}
+
+	for (auto const& folder : folders)
+	{
+		if (roots_.empty())
+			break;
+
+		std::string const& root = roots_[RootOf(folder)];
+		for (auto& device : devices_)
+			if (std::find(device.roots_.begin(), device.roots_.end(), root) != device.roots_.end())
+				device.start_.push_back(folder);
+	}
+}
+
+// Every engine is paused before any queue is read, so no volume goes on finding files the folders passed
+// would not account for.
+
+bool MultiScan::Checkpoint(std::function<void(std::vector<std::string> const& pending)> const& save) {
+	if (engines_.size() != devices_.size())
+		return false;
+
+	std::size_t paused = 0;
+	while (paused < engines_.size() && engines_[paused]->Pause())
+		++paused;
+
+	bool const all = paused == engines_.size();
+	if (all)
+	{
+		std::vector<std::string> pending;
+		for (auto& engine : engines_)
+		{
+			std::vector<std::string> const queued = engine->GetPending();
+			pending.insert(pending.end(), queued.begin(), queued.end());
+		}
+		save(pending);
+	}
+
+	for (std::size_t e = 0; e < paused; ++e)
+		engines_[e]->Resume();
+	return all;
+}
+
+std::size_t MultiScan::RootOf(std::string const& path) const {
+	if (prefixes_.size() < 2)
+		return 0;
+
+	for (std::size_t r = 0; r < prefixes_.size(); ++r)
+	{
+		std::string const& prefix = prefixes_[r];
+		if (path.size() < prefix.size())
+			continue;
+
+		std::size_t i = 0;
+		for (; i < prefix.size(); ++i)
+		{
+			char c = path[i];
+			c = c == '/' ? '\\' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+			if (c != prefix[i])
+				break;
+		}
+		if (i == prefix.size())
+			return r;
+	}
+	return 0;
+}
+
+std::vector<std::string> MultiScan::SplitRoots(std::string const& text) {
+	std::vector<std::string> roots;
+	std::string::size_type start = 0;
+	while (start <= text.size())
+	{
+		std::string::size_type end = text.find(';', start);
+		if (end == std::string::npos)
+			end = text.size();
+
+		std::string::size_type b = text.find_first_not_of(" \t", start);
+		if (b != std::string::npos && b < end)
+		{
+			std::string::size_type e = text.find_last_not_of(" \t", end - 1);
+			roots.push_back(text.substr(b, e - b + 1));
+		}
+		start = end + 1;
+	}
+	return roots;
+}
+
+unsigned long long MultiScan::GetSearched() const {
+	unsigned long long searched = 0;
+	for (auto const& engine : engines_)
+		searched += engine->GetSearched();
+	return searched;
+}
+
+unsigned long long MultiScan::GetListed() const {
+	unsigned long long listed = 0;
+	for (auto const& engine : engines_)
+		listed += engine->GetListed();
+	return listed;
+}
+
+// The medium is worked out from three questions: whether the volume is a network share, whether its disk
+// incurs a seek penalty, and what bus its adapter is on. A volume on several disks, or one the system will not
+// describe, is UNKNOWN.
+
+MultiScan::Medium MultiScan::Probe(std::string const& volume) {
+	if (GetDriveTypeA(volume.c_str()) == DRIVE_REMOTE)
+		return NETWORK;
+
+	// The volume's own name, \\?\Volume{...}, opened without its trailing separator, takes the queries.
+	char name[MAX_PATH];
+	if (!GetVolumeNameForVolumeMountPointA(volume.c_str(), name, MAX_PATH))
+		return UNKNOWN;
+	std::string device(name);
+	if (!device.empty() && device.back() == '\\')
+		device.pop_back();
+
+	HANDLE h = CreateFileA(device.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+	if (h == INVALID_HANDLE_VALUE)
+		return UNKNOWN;
+
+	Medium medium = UNKNOWN;
+	DWORD got = 0;
+
+	STORAGE_PROPERTY_QUERY query = {};
+	query.PropertyId = StorageDeviceSeekPenaltyProperty;
+	query.QueryType = PropertyStandardQuery;
+	DEVICE_SEEK_PENALTY_DESCRIPTOR seek = {};
+	if (DeviceIoControl(h, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query), &seek, sizeof(seek), &got, NULL) && got >= sizeof(seek))
+		medium = seek.IncursSeekPenalty ? ROTATIONAL : SOLID_STATE;
+
+	query.PropertyId = StorageAdapterProperty;
+	STORAGE_ADAPTER_DESCRIPTOR adapter = {};
+	if (medium == SOLID_STATE && DeviceIoControl(h, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query), &adapter, sizeof(adapter), &got, NULL) && got >= sizeof(adapter) && adapter.BusType == STORAGE_BUS_TYPE_NVME)
+		medium = NVME;
+
+	CloseHandle(h);
+	return medium;
+}
+
+char const* MultiScan::GetMediumName(Medium medium) {
+	switch (medium)
+	{
+		case ROTATIONAL: return "rotational";
+		case SOLID_STATE: return "solid state";
+		case NVME: return "NVMe";
+		case NETWORK: return "network";
+		default: return "unknown";
+	}
+}
+
+// One line per reading, then one with where the limit ended, so the climb can be followed and checked to settle.
+
+void MultiScan::Log() const {
+	std::string const cache = GetCacheFolder();
+	if (cache.empty())
+		return;
+
+	std::ofstream out(cache + "scan-tuning.log", std::ios::app);
+	if (!out)
+		return;
+
+	char stamp[32] = "";
+	std::time_t const now = std::time(nullptr);
+	std::tm local;
+	if (localtime_s(&local, &now) == 0)
+		std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+
+	for (std::size_t d = 0; d < devices_.size() && d < engines_.size(); ++d)
+	{
+		ScanEngine const& engine = *engines_[d];
+		if (!engine.IsTuned())
+			continue;
+
+		for (auto const& sample : engine.GetSamples())
+			out << stamp << "  " << devices_[d].volume_ << "  " << GetMediumName(devices_[d].medium_) << "  " << static_cast<long long>(sample.seconds_ * 1000) << "ms  "
+				<< sample.workers_ << " workers  " << static_cast<long long>(sample.rate_) << " entries/s\n";
+		out << stamp << "  " << devices_[d].volume_ << "  " << GetMediumName(devices_[d].medium_) << "  started with " << devices_[d].threads_ << " of " << devices_[d].maxThreads_
+			<< " workers, ended with " << engine.GetLimit() << ", " << engine.GetSearched() << " entries\n";
+	}
+}
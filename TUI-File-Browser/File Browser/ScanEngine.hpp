@@ -0,0 +1,403 @@
+/** @file : ScanEngine.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the parallel directory walker used by FileModel::Scan.
+History : Split out of FileModel::Scan so the walk can be spread across worker threads.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __SCAN_ENGINE_GUARD__
+#define __SCAN_ENGINE_GUARD__
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <condition_variable>
+#include <system_error>
+#include <filesystem>
+
+class ScanThrottle;
+class ScanProgress;
+
+
+// A single file found by the walk, carrying the metadata the model needs to rank it.
+
+struct FileEntry
+{
+	std::string			path_;
+	unsigned long long	size_;
+	long long			mtime_;
+
+	FileEntry() : size_(0), mtime_(0) { };
+	FileEntry(std::string path, unsigned long long size, long long mtime) : path_(path), size_(size), mtime_(mtime) { };
+};
+
+// A folder the walk listed, with its last write time when it was listed, so a later refresh can tell
+// whether its entries changed.
+
+struct FolderEntry
+{
+	std::string	path_;
+	long long	stamp_;
+
+	FolderEntry() : stamp_(0) { };
+	FolderEntry(std::string path, long long stamp) : path_(path), stamp_(stamp) { };
+};
+
+// What the walk stepped over: files and folders it could not read, counted by kind, with the first path of each
+// kind. A folder that cannot be listed is skipped with everything under it and the walk goes on. Counting is
+// safe from any worker; only the first failure of a kind takes the lock, to keep its path.
+
+class ScanErrors
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		enum Kind
+		{
+			DENIED,		// no permission
+			VANISHED,	// deleted, or on a volume that went away, between being listed and being read
+			TOO_LONG,	// path or name too long
+			OTHER,
+			KINDS
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::atomic<unsigned long long>	counts_[KINDS];
+		mutable std::mutex				lock_;
+		std::string						first_[KINDS];
+
+	// -------- CONSTRUCTOR --------
+	public:
+		ScanErrors() { Reset(); }
+
+		ScanErrors(ScanErrors const&) = delete;
+		void operator=(ScanErrors const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Counts a failure to read path.
+
+		void Count(std::error_code const& ec, std::string const& path);
+
+		 // Adds other's counts to these, and its first path of each kind that has none here yet.
+
+		void Add(ScanErrors const& other);
+
+		void Reset();
+
+		 // The kind a failure counts as.
+
+		static Kind Classify(std::error_code const& ec);
+
+		static char const* GetKindName(Kind kind);
+
+		 // One line for the footer: how many entries were skipped, by kind, and the first path skipped.
+
+		std::string Summarize() const;
+
+	// -------- ACCESSORS --------
+	public:
+		unsigned long long GetCount(Kind kind) const { return counts_[kind].load(std::memory_order_relaxed); }
+		unsigned long long GetTotal() const;
+		std::string GetFirst(Kind kind) const;
+};
+
+class ScanEngine
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// Called on a worker thread for every file found. The worker index lets the caller keep
+		// per-thread state without locking.
+		typedef std::function<void(unsigned worker, std::tr2::sys::path const& file)> Visitor;
+
+		// Called on a worker thread for every folder, just before it is listed.
+		typedef std::function<void(unsigned worker, std::tr2::sys::path const& folder)> FolderVisitor;
+
+		// Called on the thread that started the walk, at a fixed interval, until the walk completes.
+		typedef std::function<void()> Tick;
+
+		// One reading taken while the number of workers is tuned: how many were allowed to list folders, and
+		// the entries per second they managed over the interval before.
+		struct Sample
+		{
+			double		seconds_;	// since the walk started
+			unsigned	workers_;
+			double		rate_;
+
+			Sample(double seconds, unsigned workers, double rate) : seconds_(seconds), workers_(workers), rate_(rate) { };
+		};
+
+	// -------- CLASS MEMBERS --------
+	public:
+		// Stamp of a folder that cannot be read.
+		static long long const MISSING = -1;
+
+	private:
+		unsigned	threads_;
+		unsigned	tickMs_;
+
+		// How many workers may list a folder at once, and the tuner's state; see Tune.
+		unsigned				initial_;
+		unsigned				limit_;
+		int						direction_;
+		double					lastRate_;
+		unsigned long long		lastSearched_;
+		std::vector<Sample>		samples_;
+
+		std::mutex								lock_;
+		std::condition_variable					wake_;
+		std::condition_variable					finished_;
+		std::deque<std::tr2::sys::path>		pending_;
+		unsigned								busy_;
+		unsigned								running_;
+		std::exception_ptr						error_;
+
+		// Set while Pause holds the workers back; started_ once a walk has set up its queue, and pauses_ counts
+		// the pauses so the tuner can leave out an interval that had one.
+		bool									paused_;
+		bool									started_;
+		unsigned								pauses_;
+
+		std::atomic<unsigned long long>	searched_;
+		std::atomic<unsigned long long>	listed_;
+		ScanThrottle*					throttle_;
+		ScanProgress*					progress_;
+		unsigned						firstWorker_;	// this engine's first slot in progress_
+
+		// Where failures are counted: ownErrors_ unless SetErrors gave somewhere else.
+		ScanErrors						ownErrors_;
+		ScanErrors*						errors_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Starts threads workers. With a larger maxThreads, that many are started but only threads of them may
+		 // list folders at first, and that number is tuned while the walk runs.
+
+		ScanEngine(unsigned threads = DefaultThreadCount(), unsigned tickMs = 100, unsigned maxThreads = 0);
+
+		// Add these so a walk's queue cannot be shared by accident.
+		ScanEngine(ScanEngine const&) = delete;
+		void operator=(ScanEngine const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Walks "root" (and its sub-folders when recurse is set) on the worker threads, calling visit for every file
+		 // and enter, if given, for every folder. Folders and entries that cannot be read are counted in GetErrors()
+		 // and skipped. Rethrows the first exception raised by a visitor once every worker has stopped.
+
+		void Run(std::tr2::sys::path const& root, bool recurse, Visitor const& visit, Tick const& tick = Tick(), FolderVisitor const& enter = FolderVisitor());
+
+		 // Walks several roots the same way, all from the one queue.
+
+		void Run(std::vector<std::tr2::sys::path> const& roots, bool recurse, Visitor const& visit, Tick const& tick = Tick(), FolderVisitor const& enter = FolderVisitor());
+
+		// Number of workers to use when the caller has no better idea.
+
+		static unsigned DefaultThreadCount();
+
+		// Reads the size and last write time of a file. Only called for files the caller keeps,
+		// so files that do not match cost no extra stat.
+
+		static FileEntry Describe(std::tr2::sys::path const& file);
+
+		// As above, but sets ec instead of throwing when the file cannot be read.
+
+		static FileEntry Describe(std::tr2::sys::path const& file, std::error_code& ec);
+
+		 // Last write time of a folder, which changes whenever an entry is added to, removed from or renamed in it,
+		 // or MISSING if the folder cannot be read.
+
+		static long long Stamp(std::string const& folder);
+
+		 // Makes the workers follow throttle's background mode, checked before each folder they list, and take
+		 // one of its tokens per folder. The throttle must outlive the walk; null turns it off.
+
+		void SetThrottle(ScanThrottle* throttle) { throttle_ = throttle; }
+
+		 // Makes the workers publish what they list to progress, in the slots from firstWorker on. progress must
+		 // have room for them and outlive the walk; null turns it off.
+
+		void SetProgress(ScanProgress* progress, unsigned firstWorker = 0) { progress_ = progress; firstWorker_ = firstWorker; }
+
+		 // Has the workers count failures in errors, which must outlive the walk, instead of in the engine.
+
+		void SetErrors(ScanErrors* errors) { errors_ = errors ? errors : &ownErrors_; }
+
+		 // Stops the workers taking more folders and waits for those listing one to finish it, so every folder is
+		 // either listed with all its files visited or still queued. Called from another thread, or from the tick,
+		 // while the walk runs; returns false, holding nothing back, if the walk has not set up its queue yet.
+
+		bool Pause();
+
+		 // Lets the workers go on after Pause.
+
+		void Resume();
+
+		 // The folders still queued. Only meaningful while paused, or once the walk is done.
+
+		std::vector<std::string> GetPending();
+
+	// -------- ACCESSORS --------
+	public:
+		unsigned GetThreadCount() const { return threads_; }
+
+		// Workers allowed to list folders at once, and, when that is tuned, its readings from the last walk.
+		unsigned GetLimit() const { return limit_; }
+		bool IsTuned() const { return threads_ > initial_; }
+		std::vector<Sample> const& GetSamples() const { return samples_; }
+
+		// Files and folders looked at so far, and folders listed; safe to read while the walk is running.
+		unsigned long long GetSearched() const { return searched_.load(std::memory_order_relaxed); }
+		unsigned long long GetListed() const { return listed_.load(std::memory_order_relaxed); }
+
+		// What the walk could not read; safe to use while the walk is running, and to count into from a visitor.
+		ScanErrors& GetErrors() { return *errors_; }
+		ScanErrors const& GetErrors() const { return *errors_; }
+
+	private:
+
+		 // Body of each worker thread: pops folders until the queue is drained and no worker can add more.
+
+		void Work(unsigned worker, bool recurse, Visitor const& visit, FolderVisitor const& enter);
+
+		 // Takes a reading of the entries listed per second over the last interval and moves the limit one step
+		 // towards the better rate. Called with lock_ held.
+
+		void Tune(double seconds, double interval);
+};
+
+// Walks several roots in one search. Roots are grouped by the volume they are on, and each volume gets its own
+// engine, with its own queue and its own workers, so two disks are walked side by side instead of taking turns
+// on one queue, and a slow one cannot starve a fast one. How many workers a volume starts with, and how far its
+// engine may tune that, depends on what the volume is on: a spinning disk loses to seeking with many, while
+// NVMe and network shares need many requests in flight to be kept busy. Roots inside another root, and repeats,
+// are dropped, so every file is found once and belongs to exactly one root.
+
+class MultiScan
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// What a volume is stored on, as far as the system will say.
+		enum Medium
+		{
+			UNKNOWN,
+			ROTATIONAL,
+			SOLID_STATE,
+			NVME,
+			NETWORK
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		struct Device
+		{
+			std::string					volume_;
+			std::vector<std::string>	roots_;
+			Medium						medium_;
+			unsigned					threads_;		// allowed to list folders at first
+			unsigned					maxThreads_;
+			unsigned					firstWorker_;	// the device's workers are numbered from here in the visitors
+			std::vector<std::string>	start_;			// folders to walk instead of roots_, when resumed_
+			bool						resumed_;
+
+			Device() : medium_(UNKNOWN), threads_(0), maxThreads_(0), firstWorker_(0), resumed_(false) { };
+		};
+
+		std::vector<std::string>					roots_;
+		std::vector<std::string>					prefixes_;	// each root in lower case with '\' separators and one at the end
+		std::vector<Device>							devices_;
+		unsigned									threads_;
+		std::vector<std::unique_ptr<ScanEngine>>	engines_;
+		ScanThrottle*								throttle_;
+		ScanProgress*								progress_;
+		ScanErrors									errors_;	// shared by every volume's engine
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Sets up a walk of roots. With adapt set, each volume's workers are chosen by its medium and tuned as
+		 // it is walked; otherwise the default thread count is shared between the volumes.
+
+		MultiScan(std::vector<std::string> const& roots, bool adapt = true);
+
+		MultiScan(MultiScan const&) = delete;
+		void operator=(MultiScan const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Walks every root as ScanEngine::Run does. Worker numbers passed to the visitors are unique across the
+		 // volumes, below GetThreadCount(). tick runs on this thread until every volume is done, and the first
+		 // error from any volume is rethrown once all of them have stopped. The tuning of each volume is then
+		 // added to the tuning log in the cache folder.
+
+		void Run(bool recurse, ScanEngine::Visitor const& visit, ScanEngine::Tick const& tick = ScanEngine::Tick(), ScanEngine::FolderVisitor const& enter = ScanEngine::FolderVisitor());
+
+		 // Index in GetRoots() of the root path is under.
+
+		std::size_t RootOf(std::string const& path) const;
+
+		 // Splits a list of folders separated by ';', as typed in the folder box, dropping blanks around them.
+
+		static std::vector<std::string> SplitRoots(std::string const& text);
+
+		 // Asks the storage stack what the volume mounted at volume (as returned by GetVolumePathName) is on.
+
+		static Medium Probe(std::string const& volume);
+
+		static char const* GetMediumName(Medium medium);
+
+		 // Puts every volume's engine under throttle, as ScanEngine::SetThrottle; one bucket serves them all.
+
+		void SetThrottle(ScanThrottle* throttle) { throttle_ = throttle; }
+
+		 // Has every volume's engine publish to progress, which must have GetThreadCount() slots.
+
+		void SetProgress(ScanProgress* progress) { progress_ = progress; }
+
+		 // Has the next Run walk folders, the queue a checkpoint saved, instead of the roots. Each folder goes to
+		 // the volume of the root it is under; sub-folders are still walked if Run is asked to recurse.
+
+		void SetStart(std::vector<std::string> const& folders);
+
+		 // Pauses every volume's engine, passes save the folders still queued on all of them, and lets them go on.
+		 // Called from the tick. Every file found so far is then in a folder that was listed in full, and every
+		 // folder not listed is among those passed, so the walk can be picked up from there. Returns false,
+		 // without calling save, if a volume's walk has not started yet.
+
+		bool Checkpoint(std::function<void(std::vector<std::string> const& pending)> const& save);
+
+	// -------- ACCESSORS --------
+	public:
+		std::vector<std::string> const& GetRoots() const { return roots_; }
+		std::size_t GetDeviceCount() const { return devices_.size(); }
+		unsigned GetThreadCount() const { return threads_; }
+
+		// Files and folders looked at, and folders listed, so far on every volume; safe to read while the walk
+		// is running.
+		unsigned long long GetSearched() const;
+		unsigned long long GetListed() const;
+
+		// What the walk could not read on any volume, as ScanEngine::GetErrors.
+		ScanErrors& GetErrors() { return errors_; }
+		ScanErrors const& GetErrors() const { return errors_; }
+
+	private:
+
+		 // Appends every volume's readings from the last walk to the tuning log.
+
+		void Log() const;
+};
+
+#endif
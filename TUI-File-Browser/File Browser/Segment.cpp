@@ -0,0 +1,379 @@
+/** @file : Segment.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the shared memory segment a scan's result is published in for other browsers to read.
+History : Added so browsers on one machine share one copy of a big result set instead of holding one each.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Segment.hpp"
+
+#include <new>
+#include <atomic>
+#include <ctime>
+#include <cstring>
+#include <algorithm>
+#include <Sddl.h>
+
+
+namespace {
+	char const MAGIC[4] = { 'T', 'S', 'E', 'G' };
+	char const CONTROL_MAGIC[4] = { 'T', 'S', 'E', 'C' };
+	unsigned const VERSION = 1;
+
+	// Tried in turn: names every session sees, then names this session sees.
+	char const* const PREFIXES[] = { "Global\\", "Local\\" };
+	char const* const NAME = "TUIFileBrowser-segment";
+
+	// Who may open the blocks: the system, administrators and the publisher in full, everyone else to read.
+	char const* const ACCESS = "D:(A;;GA;;;SY)(A;;GA;;;BA)(A;;GA;;;OW)(A;;GR;;;WD)";
+
+	// Times a reader looks again for a block replaced while it was opening it, and numbers a publisher passes
+	// over when a block of an earlier publisher's is still held under one.
+	unsigned const ATTACH_TRIES = 4;
+	unsigned const PUBLISH_TRIES = 16;
+
+	std::string BlockName(std::string const& base, unsigned long long number) {
+		return base + "-" + std::to_string(number);
+	}
+
+	std::size_t RoundUp(std::size_t bytes) {
+		return (bytes + 63) & ~static_cast<std::size_t>(63);
+	}
+
+	// The security attributes for ACCESS, for as long as this lives; null, for the default, if they cannot be made.
+	struct Access
+	{
+		SECURITY_ATTRIBUTES		attributes_;
+		PSECURITY_DESCRIPTOR	descriptor_;
+
+		Access() : attributes_(), descriptor_(nullptr) {
+			attributes_.nLength = sizeof(attributes_);
+			if (ConvertStringSecurityDescriptorToSecurityDescriptorA(ACCESS, SDDL_REVISION_1, &descriptor_, nullptr))
+				attributes_.lpSecurityDescriptor = descriptor_;
+		}
+
+		~Access() {
+			if (descriptor_)
+				LocalFree(descriptor_);
+		}
+
+		SECURITY_ATTRIBUTES* Get() { return descriptor_ ? &attributes_ : nullptr; }
+	};
+}
+
+
+// Written once by the publisher and read by everyone: the number of the block published last, zero before the first.
+
+struct SegmentControl
+{
+	char							magic_[4];
+	unsigned						version_;
+	std::atomic<unsigned long long>	number_;
+};
+
+// Every offset is from the start of the block, except a path's, which is from paths_.
+
+struct SegmentHeader
+{
+	char				magic_[4];
+	unsigned			version_;
+	unsigned long long	number_;
+	unsigned long long	size_;		// bytes of the whole block
+	unsigned long long	count_;
+	unsigned long long	bytes_;		// size of the files
+	unsigned long long	searched_;
+	long long			publishedAt_;
+	unsigned long long	entries_;
+	unsigned long long	paths_;
+	unsigned long long	roots_;
+	unsigned long long	rootsLength_;
+	unsigned long long	filter_;
+	unsigned long long	filterLength_;
+};
+
+struct SegmentEntry
+{
+	unsigned long long	path_;
+	unsigned long long	size_;
+	long long			mtime_;
+	unsigned long long	before_;	// size of the files before this one
+	unsigned			length_;
+	unsigned			reserved_;
+};
+
+namespace {
+	// Number of the block published last, and the names it goes by; zero if nothing is published.
+	unsigned long long ReadPublished(std::string& base) {
+		for (auto prefix : PREFIXES)
+		{
+			std::string const name = std::string(prefix) + NAME;
+			HANDLE control = OpenFileMappingA(FILE_MAP_READ, FALSE, (name + "-current").c_str());
+			if (!control)
+				continue;
+
+			unsigned long long number = 0;
+			auto block = static_cast<SegmentControl const*>(MapViewOfFile(control, FILE_MAP_READ, 0, 0, sizeof(SegmentControl)));
+			if (block && std::equal(block->magic_, block->magic_ + 4, CONTROL_MAGIC) && block->version_ == VERSION)
+				number = block->number_.load(std::memory_order_acquire);
+			if (block)
+				UnmapViewOfFile(block);
+			CloseHandle(control);
+
+			if (number)
+			{
+				base = name;
+				return number;
+			}
+		}
+		return 0;
+	}
+}
+
+
+// -------- WRITER --------
+
+SegmentWriter::SegmentWriter() : control_(nullptr), block_(nullptr), current_(nullptr), number_(0) {
+	Access access;
+	for (auto prefix : PREFIXES)
+	{
+		std::string const name = std::string(prefix) + NAME;
+		control_ = CreateFileMappingA(INVALID_HANDLE_VALUE, access.Get(), PAGE_READWRITE, 0, sizeof(SegmentControl), (name + "-current").c_str());
+		if (control_)
+		{
+			base_ = name;
+			break;
+		}
+	}
+	if (!control_)
+		return;
+
+	bool const existed = GetLastError() == ERROR_ALREADY_EXISTS;
+	void* view = MapViewOfFile(control_, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SegmentControl));
+	if (!view)
+	{
+		CloseHandle(control_);
+		control_ = nullptr;
+		return;
+	}
+
+	block_ = static_cast<SegmentControl*>(view);
+	if (existed && std::equal(block_->magic_, block_->magic_ + 4, CONTROL_MAGIC) && block_->version_ == VERSION)
+		number_ = block_->number_.load(std::memory_order_acquire);
+	else
+	{
+		block_ = new (view) SegmentControl;
+		std::memcpy(block_->magic_, CONTROL_MAGIC, sizeof(CONTROL_MAGIC));
+		block_->version_ = VERSION;
+		block_->number_.store(0, std::memory_order_release);
+	}
+}
+
+SegmentWriter::~SegmentWriter() {
+	if (block_)
+		UnmapViewOfFile(block_);
+	if (control_)
+		CloseHandle(control_);
+	if (current_)
+		CloseHandle(current_);
+}
+
+// The block is filled in before its number goes in the control block, so a reader never finds one half written.
+
+bool SegmentWriter::Publish(std::vector<FileEntry> const& files, std::string const& roots, std::string const& filter, unsigned long long searched) {
+	if (!block_)
+		return false;
+
+	unsigned long long pathBytes = roots.size() + filter.size();
+	for (auto const& f : files)
+		pathBytes += f.path_.size();
+	unsigned long long const entriesAt = RoundUp(sizeof(SegmentHeader));
+	unsigned long long const pathsAt = entriesAt + files.size() * sizeof(SegmentEntry);
+	unsigned long long const size = pathsAt + pathBytes;
+
+	Access access;
+	HANDLE mapping = nullptr;
+	unsigned long long number = number_;
+	for (unsigned attempt = 0; attempt < PUBLISH_TRIES && !mapping; ++attempt)
+	{
+		++number;
+		mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, access.Get(), PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), BlockName(base_, number).c_str());
+		if (mapping && GetLastError() == ERROR_ALREADY_EXISTS)
+		{
+			CloseHandle(mapping);
+			mapping = nullptr;
+		}
+	}
+	char* view = mapping ? static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0)) : nullptr;
+	if (!view)
+	{
+		if (mapping)
+			CloseHandle(mapping);
+		return false;
+	}
+
+	SegmentHeader* header = new (view) SegmentHeader();
+	std::memcpy(header->magic_, MAGIC, sizeof(MAGIC));
+	header->version_ = VERSION;
+	header->number_ = number;
+	header->size_ = size;
+	header->count_ = files.size();
+	header->searched_ = searched;
+	header->publishedAt_ = static_cast<long long>(std::time(nullptr));
+	header->entries_ = entriesAt;
+	header->paths_ = pathsAt;
+
+	SegmentEntry* entries = reinterpret_cast<SegmentEntry*>(view + entriesAt);
+	char* paths = view + pathsAt;
+	unsigned long long at = 0, before = 0;
+	for (std::size_t i = 0; i < files.size(); ++i)
+	{
+		SegmentEntry& e = *new (entries + i) SegmentEntry();
+		e.path_ = at;
+		e.length_ = static_cast<unsigned>(files[i].path_.size());
+		e.size_ = files[i].size_;
+		e.mtime_ = files[i].mtime_;
+		e.before_ = before;
+		std::memcpy(paths + at, files[i].path_.data(), e.length_);
+		at += e.length_;
+		before += e.size_;
+	}
+	header->bytes_ = before;
+
+	header->roots_ = at;
+	header->rootsLength_ = roots.size();
+	std::memcpy(paths + at, roots.data(), roots.size());
+	at += roots.size();
+	header->filter_ = at;
+	header->filterLength_ = filter.size();
+	std::memcpy(paths + at, filter.data(), filter.size());
+	UnmapViewOfFile(view);
+
+	block_->number_.store(number, std::memory_order_release);
+	if (current_)
+		CloseHandle(current_);
+	current_ = mapping;
+	number_ = number;
+	return true;
+}
+
+// -------- READER --------
+
+SegmentReader::SegmentReader() : mapping_(nullptr), view_(nullptr), header_(nullptr), entries_(nullptr), paths_(nullptr) {
+}
+
+SegmentReader::~SegmentReader() {
+	Detach();
+}
+
+// The header is checked against the size of what was mapped, so a block that does not read as one is never
+// read past its end.
+
+bool SegmentReader::Attach() {
+	Detach();
+	for (unsigned attempt = 0; attempt < ATTACH_TRIES; ++attempt)
+	{
+		std::string base;
+		unsigned long long const number = ReadPublished(base);
+		if (!number)
+			return false;
+
+		mapping_ = OpenFileMappingA(FILE_MAP_READ, FALSE, BlockName(base, number).c_str());
+		if (!mapping_)
+			continue;
+		view_ = static_cast<char const*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+
+		MEMORY_BASIC_INFORMATION region = {};
+		auto header = reinterpret_cast<SegmentHeader const*>(view_);
+		bool const valid = view_ && VirtualQuery(view_, &region, sizeof(region)) && region.RegionSize >= sizeof(SegmentHeader)
+			&& std::equal(header->magic_, header->magic_ + 4, MAGIC) && header->version_ == VERSION && header->number_ == number
+			&& header->size_ <= region.RegionSize && header->entries_ <= header->paths_ && header->paths_ <= header->size_
+			&& (header->paths_ - header->entries_) / sizeof(SegmentEntry) >= header->count_
+			&& header->roots_ + header->rootsLength_ <= header->size_ - header->paths_
+			&& header->filter_ + header->filterLength_ <= header->size_ - header->paths_;
+		if (!valid)
+		{
+			Detach();
+			return false;
+		}
+
+		header_ = header;
+		entries_ = reinterpret_cast<SegmentEntry const*>(view_ + header->entries_);
+		paths_ = view_ + header->paths_;
+		return true;
+	}
+	return false;
+}
+
+unsigned long long SegmentReader::GetPublished() {
+	std::string base;
+	return ReadPublished(base);
+}
+
+FileEntry SegmentReader::Get(unsigned long long i) const {
+	SegmentEntry const& e = entries_[i];
+	return FileEntry(PathOf(e), e.size_, e.mtime_);
+}
+
+// The files under a prefix come together in path order, so their run ends at the first one past it.
+
+std::pair<unsigned long long, unsigned long long> SegmentReader::Find(std::string const& prefix) const {
+	if (!header_)
+		return std::make_pair(0ull, 0ull);
+
+	SegmentEntry const* end = entries_ + header_->count_;
+	SegmentEntry const* first = std::lower_bound(entries_, end, prefix, [&](SegmentEntry const& e, std::string const& p) { return PathOf(e) < p; });
+	SegmentEntry const* last = std::partition_point(first, end, [&](SegmentEntry const& e) { return PathOf(e).compare(0, prefix.size(), prefix) == 0; });
+	return std::make_pair(static_cast<unsigned long long>(first - entries_), static_cast<unsigned long long>(last - entries_));
+}
+
+unsigned long long SegmentReader::GetBytes(unsigned long long first, unsigned long long end) const {
+	if (!header_ || first >= end)
+		return 0;
+	unsigned long long const after = end < header_->count_ ? entries_[end].before_ : header_->bytes_;
+	return after - entries_[first].before_;
+}
+
+unsigned long long SegmentReader::GetNumber() const {
+	return header_ ? header_->number_ : 0;
+}
+
+unsigned long long SegmentReader::GetCount() const {
+	return header_ ? header_->count_ : 0;
+}
+
+unsigned long long SegmentReader::GetSearched() const {
+	return header_ ? header_->searched_ : 0;
+}
+
+long long SegmentReader::GetPublishedAt() const {
+	return header_ ? header_->publishedAt_ : 0;
+}
+
+std::string SegmentReader::GetRoots() const {
+	return header_ ? std::string(paths_ + header_->roots_, static_cast<std::size_t>(header_->rootsLength_)) : std::string();
+}
+
+std::string SegmentReader::GetFilter() const {
+	return header_ ? std::string(paths_ + header_->filter_, static_cast<std::size_t>(header_->filterLength_)) : std::string();
+}
+
+// A path that would run past the block reads as empty.
+
+std::string SegmentReader::PathOf(SegmentEntry const& entry) const {
+	if (entry.path_ + entry.length_ > header_->size_ - header_->paths_)
+		return std::string();
+	return std::string(paths_ + entry.path_, entry.length_);
+}
+
+void SegmentReader::Detach() {
+	if (view_)
+		UnmapViewOfFile(view_);
+	if (mapping_)
+		CloseHandle(mapping_);
+	mapping_ = nullptr;
+	view_ = nullptr;
+	header_ = nullptr;
+	entries_ = nullptr;
+	paths_ = nullptr;
+}
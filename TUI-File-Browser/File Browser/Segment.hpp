@@ -0,0 +1,132 @@
+/** @file : Segment.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the shared memory segment a scan's result is published in for other browsers to read.
+History : Added so browsers on one machine share one copy of a big result set instead of holding one each.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __SEGMENT_GUARD__
+#define __SEGMENT_GUARD__
+
+#include "ScanEngine.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <Windows.h>
+
+
+// A scan's files published in a named block of shared memory. The block holds no pointers, only offsets from its
+// start, so it reads the same wherever a process maps it: a header, a table of fixed size entries in path order,
+// then the bytes of every path. Each entry carries its file's size, time and the size of every file before it, so
+// the size of any run of files is one subtraction.
+//
+// Every publish makes a new block, named after its number, and only then sets that number in a small control
+// block with a fixed name, which is how a reader finds the latest. A reader maps a block read-only and keeps it as
+// long as it likes: the publisher lets go of a block once the next one is in place, and the system frees it when
+// the last reader does. The names are Global\ ones, so every session on the machine sees them, when the publisher
+// is allowed to make those, and Local\ ones otherwise.
+
+struct SegmentHeader;
+struct SegmentEntry;
+struct SegmentControl;
+
+class SegmentWriter
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		std::string			base_;		// what the names start with, once the control block is made
+		HANDLE				control_;
+		SegmentControl*		block_;
+		HANDLE				current_;	// the block published last
+		unsigned long long	number_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+
+		 // Makes the control block, or takes over the one left by an earlier publisher.
+
+		SegmentWriter();
+		~SegmentWriter();
+
+		SegmentWriter(SegmentWriter const&) = delete;
+		void operator=(SegmentWriter const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Publishes files, which must be sorted by path, as the scan of roots with filter, which looked at
+		 // searched entries. Readers attaching from now on see it. Returns false, leaving the last block
+		 // published, if the new one cannot be made.
+
+		bool Publish(std::vector<FileEntry> const& files, std::string const& roots, std::string const& filter, unsigned long long searched);
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsOpen() const { return block_ != nullptr; }
+		unsigned long long GetNumber() const { return number_; }
+};
+
+class SegmentReader
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		HANDLE					mapping_;
+		char const*				view_;
+		SegmentHeader const*	header_;
+		SegmentEntry const*		entries_;
+		char const*				paths_;
+
+	// -------- CONSTRUCTOR/DESTRUCTOR --------
+	public:
+		SegmentReader();
+		~SegmentReader();
+
+		SegmentReader(SegmentReader const&) = delete;
+		void operator=(SegmentReader const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Maps the block published last, read-only. Returns false if nothing is published or the block does not
+		 // read as one; a block replaced between finding its number and opening it is passed over for the next.
+
+		bool Attach();
+
+		 // Number of the block published last, or zero if there is none. Cheap enough to ask on every refresh.
+
+		static unsigned long long GetPublished();
+
+		 // File i, in path order.
+
+		FileEntry Get(unsigned long long i) const;
+
+		 // The run of files whose path starts with prefix.
+
+		std::pair<unsigned long long, unsigned long long> Find(std::string const& prefix) const;
+
+		 // Size of the files in the run [first, end).
+
+		unsigned long long GetBytes(unsigned long long first, unsigned long long end) const;
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsAttached() const { return header_ != nullptr; }
+		unsigned long long GetNumber() const;
+		unsigned long long GetCount() const;
+		unsigned long long GetSearched() const;
+		long long GetPublishedAt() const;
+		std::string GetRoots() const;
+		std::string GetFilter() const;
+
+	private:
+		std::string PathOf(SegmentEntry const& entry) const;
+
+		 // Lets go of the block mapped, if any.
+
+		void Detach();
+};
+
+#endif
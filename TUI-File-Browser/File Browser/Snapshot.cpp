@@ -0,0 +1,322 @@
+/** @file : Snapshot.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for saving the files of a scan to disk and comparing two saved scans.
+History : Added so what appeared, disappeared or grew between two scans of a volume can be listed.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Snapshot.hpp"
+
+#include <map>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+
+namespace {
+	char const MAGIC[4] = { 'T', 'S', 'N', 'P' };
+	unsigned const VERSION = 1;
+
+	// Where the file count sits in the header: after the magic, the version and the time taken.
+	std::streamoff const COUNT_AT = sizeof(MAGIC) + sizeof(unsigned) + sizeof(long long);
+
+	// Bytes buffered on each side.
+	std::size_t const BUFFER_SIZE = 1024 * 1024;
+
+	// Longest path a snapshot may hold, and so the most one record can take with its four numbers.
+	std::size_t const MAX_PATH_LENGTH = 32768;
+	std::size_t const MAX_RECORD = MAX_PATH_LENGTH + 4 * 10;
+
+	// Seven bits per byte, lowest first; the top bit is set on every byte but the last.
+	char* PutVarint(char* out, unsigned long long value) {
+		while (value >= 0x80)
+		{
+			*out++ = static_cast<char>(value | 0x80);
+			value >>= 7;
+		}
+		*out++ = static_cast<char>(value);
+		return out;
+	}
+
+	bool GetVarint(char const*& p, char const* end, unsigned long long& value) {
+		value = 0;
+		for (unsigned shift = 0; p < end && shift < 64; shift += 7)
+		{
+			unsigned char const byte = static_cast<unsigned char>(*p++);
+			value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+
+	// Folds a signed time so that small values either side of zero take few bytes.
+	unsigned long long ZigZag(long long value) {
+		return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+	}
+
+	long long UnZigZag(unsigned long long value) {
+		return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+	}
+
+	std::string FolderOf(std::string const& path) {
+		std::string::size_type slash = path.find_last_of("\\/");
+		return slash == std::string::npos ? std::string() : path.substr(0, slash);
+	}
+}
+
+
+// -------- SNAPSHOT WRITER --------
+
+SnapshotWriter::SnapshotWriter(std::string const& path, std::string const& root, long long taken) : path_(path), temp_(path + ".tmp"), buffer_(BUFFER_SIZE), count_(0) {
+	out_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+	out_.open(temp_, std::ios::binary | std::ios::trunc);
+
+	unsigned const length = static_cast<unsigned>(root.size());
+	out_.write(MAGIC, sizeof(MAGIC));
+	out_.write(reinterpret_cast<char const*>(&VERSION), sizeof(VERSION));
+	out_.write(reinterpret_cast<char const*>(&taken), sizeof(taken));
+	out_.write(reinterpret_cast<char const*>(&count_), sizeof(count_));
+	out_.write(reinterpret_cast<char const*>(&length), sizeof(length));
+	out_.write(root.data(), root.size());
+}
+
+// A record is the shared length, the length and characters of the rest of the path, the size and the time.
+
+void SnapshotWriter::Add(FileEntry const& file) {
+	if (file.path_.size() > MAX_PATH_LENGTH)
+		return;
+
+	std::size_t shared = 0;
+	std::size_t const most = std::min(previous_.size(), file.path_.size());
+	while (shared < most && previous_[shared] == file.path_[shared])
+		++shared;
+
+	char numbers[20];
+	char* p = PutVarint(numbers, shared);
+	p = PutVarint(p, file.path_.size() - shared);
+	out_.write(numbers, p - numbers);
+	out_.write(file.path_.data() + shared, file.path_.size() - shared);
+
+	p = PutVarint(numbers, file.size_);
+	p = PutVarint(p, ZigZag(file.mtime_));
+	out_.write(numbers, p - numbers);
+
+	previous_ = file.path_;
+	++count_;
+}
+
+bool SnapshotWriter::Close() {
+	out_.seekp(COUNT_AT);
+	out_.write(reinterpret_cast<char const*>(&count_), sizeof(count_));
+	out_.close();
+
+	if (out_.fail())
+	{
+		DeleteFileA(temp_.c_str());
+		return false;
+	}
+
+	return MoveFileExA(temp_.c_str(), path_.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+}
+
+// -------- SNAPSHOT READER --------
+
+SnapshotReader::SnapshotReader(std::string const& path) : file_(path), buffer_(BUFFER_SIZE + MAX_RECORD), pos_(0), end_(0), eof_(false), taken_(0), count_(0), read_(0), valid_(false) {
+	std::size_t const header = COUNT_AT + sizeof(count_) + sizeof(unsigned);
+	if (!file_.IsOpen() || Fill(header) < header || memcmp(&buffer_[0], MAGIC, sizeof(MAGIC)) != 0)
+		return;
+
+	unsigned version = 0, length = 0;
+	memcpy(&version, &buffer_[sizeof(MAGIC)], sizeof(version));
+	memcpy(&taken_, &buffer_[sizeof(MAGIC) + sizeof(version)], sizeof(taken_));
+	memcpy(&count_, &buffer_[COUNT_AT], sizeof(count_));
+	memcpy(&length, &buffer_[COUNT_AT + sizeof(count_)], sizeof(length));
+	pos_ = header;
+	if (version != VERSION || length > MAX_PATH_LENGTH || Fill(length) < length)
+		return;
+
+	root_.assign(&buffer_[pos_], length);
+	pos_ += length;
+	valid_ = true;
+}
+
+// Each path is rebuilt from the start of the one before, which is still in path_.
+
+bool SnapshotReader::Next(FileEntry& entry) {
+	if (!valid_ || read_ == count_)
+		return false;
+
+	std::size_t const buffered = Fill(MAX_RECORD);
+	char const* p = &buffer_[pos_];
+	char const* end = p + buffered;
+
+	unsigned long long shared, rest, size, mtime;
+	if (!GetVarint(p, end, shared) || !GetVarint(p, end, rest) || shared > path_.size() || rest > static_cast<unsigned long long>(end - p))
+	{
+		valid_ = false;
+		return false;
+	}
+
+	path_.resize(static_cast<std::size_t>(shared));
+	path_.append(p, static_cast<std::size_t>(rest));
+	p += rest;
+
+	if (!GetVarint(p, end, size) || !GetVarint(p, end, mtime))
+	{
+		valid_ = false;
+		return false;
+	}
+
+	entry.path_ = path_;
+	entry.size_ = size;
+	entry.mtime_ = UnZigZag(mtime);
+
+	pos_ = p - &buffer_[0];
+	++read_;
+	return true;
+}
+
+std::size_t SnapshotReader::Fill(std::size_t want) {
+	if (end_ - pos_ < want && !eof_)
+	{
+		std::memmove(&buffer_[0], &buffer_[pos_], end_ - pos_);
+		end_ -= pos_;
+		pos_ = 0;
+
+		while (end_ < buffer_.size())
+		{
+			std::size_t got = file_.Read(&buffer_[end_], buffer_.size() - end_);
+			if (got == 0)
+			{
+				eof_ = true;
+				break;
+			}
+			end_ += got;
+		}
+	}
+
+	return end_ - pos_;
+}
+
+// -------- SNAPSHOT DIFF --------
+
+// Both snapshots are in path order, so one pass with a cursor on each pairs every path with itself. Changes
+// come in path order too, and most follow one in the same folder, so the folder of the last change is
+// remembered and the table of folders is only searched when the folder moves.
+
+bool SnapshotDiff::Run(std::string const& before, std::string const& after, Visitor const& visit) {
+	auto start = std::chrono::steady_clock::now();
+	stats_ = Stats();
+	folders_.clear();
+
+	SnapshotReader older(before);
+	SnapshotReader newer(after);
+	if (!older.IsValid() || !newer.IsValid())
+		return false;
+
+	std::unordered_map<std::string, std::size_t> index;
+	std::size_t last = 0;
+	auto record = [&](Change change, FileEntry const& b, FileEntry const& a) {
+		++stats_.counts_[change];
+		if (visit)
+			visit(change, b, a);
+
+		std::string const folder = FolderOf(change == REMOVED ? b.path_ : a.path_);
+		if (folders_.empty() || folders_[last].path_ != folder)
+		{
+			auto it = index.find(folder);
+			if (it == index.end())
+			{
+				it = index.insert(std::make_pair(folder, folders_.size())).first;
+				folders_.push_back(FolderDelta());
+				folders_.back().path_ = folder;
+			}
+			last = it->second;
+		}
+
+		FolderDelta& delta = folders_[last];
+		switch (change)
+		{
+			case ADDED: ++delta.added_; delta.bytes_ += a.size_; stats_.addedBytes_ += a.size_; break;
+			case REMOVED: ++delta.removed_; delta.bytes_ -= b.size_; stats_.removedBytes_ += b.size_; break;
+			default:
+			{
+				long long const grown = static_cast<long long>(a.size_) - static_cast<long long>(b.size_);
+				++delta.changed_;
+				delta.bytes_ += grown;
+				stats_.resizedBytes_ += grown;
+			}
+			break;
+		}
+	};
+
+	FileEntry b, a;
+	FileEntry const none;
+	bool hasB = older.Next(b);
+	bool hasA = newer.Next(a);
+	while (hasB || hasA)
+	{
+		int const order = !hasB ? 1 : !hasA ? -1 : b.path_.compare(a.path_);
+		if (order < 0)
+		{
+			record(REMOVED, b, none);
+			hasB = older.Next(b);
+		}
+		else if (order > 0)
+		{
+			record(ADDED, none, a);
+			hasA = newer.Next(a);
+		}
+		else
+		{
+			if (a.size_ != b.size_)
+				record(RESIZED, b, a);
+			else if (a.mtime_ != b.mtime_)
+				record(MODIFIED, b, a);
+			else
+				++stats_.unchanged_;
+
+			hasB = older.Next(b);
+			hasA = newer.Next(a);
+		}
+	}
+
+	stats_.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return older.IsValid() && newer.IsValid();
+}
+
+// Each folder's own changes are added to it and to every folder above it.
+
+std::vector<SnapshotDiff::FolderDelta> SnapshotDiff::GetFolders() const {
+	std::map<std::string, FolderDelta> totals;
+	for (auto const& own : folders_)
+	{
+		std::string folder = own.path_;
+		for (;;)
+		{
+			FolderDelta& total = totals[folder];
+			total.path_ = folder;
+			total.bytes_ += own.bytes_;
+			total.added_ += own.added_;
+			total.removed_ += own.removed_;
+			total.changed_ += own.changed_;
+
+			if (folder.find_first_of("\\/") == std::string::npos)
+				break;
+			folder = FolderOf(folder);
+		}
+	}
+
+	std::vector<FolderDelta> folders;
+	folders.reserve(totals.size());
+	for (auto const& t : totals)
+		folders.push_back(t.second);
+
+	std::stable_sort(folders.begin(), folders.end(), [](FolderDelta const& x, FolderDelta const& y) {
+		return (x.bytes_ < 0 ? -x.bytes_ : x.bytes_) > (y.bytes_ < 0 ? -y.bytes_ : y.bytes_);
+	});
+	return folders;
+}
@@ -0,0 +1,171 @@
+/** @file : Snapshot.hpp
+Name : Fayomi Augustine
+Purpose: Header file for saving the files of a scan to disk and comparing two saved scans.
+History : Added so what appeared, disappeared or grew between two scans of a volume can be listed.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __SNAPSHOT_GUARD__
+#define __SNAPSHOT_GUARD__
+
+#include "ScanEngine.hpp"
+#include "FileIO.hpp"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+
+
+// Writes the files of a scan, in increasing path order, as a snapshot. Each path is stored as the number of
+// characters it shares with the one before and the characters that follow, since sorted paths share most of
+// their folders; sizes and times are stored in as few bytes as they need. The count is filled in when the
+// snapshot is closed, and the file is written under a temporary name and moved into place, so a reader never
+// sees half a snapshot.
+
+class SnapshotWriter
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		std::string			path_;
+		std::string			temp_;
+		std::ofstream		out_;
+		std::vector<char>	buffer_;
+		std::string			previous_;
+		unsigned long long	count_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Starts a snapshot of the scan of root, taken at the given time.
+
+		SnapshotWriter(std::string const& path, std::string const& root, long long taken);
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Adds a file. Paths must come in increasing order.
+
+		void Add(FileEntry const& file);
+
+		 // Finishes the snapshot and moves it into place. Returns false if it could not be written.
+
+		bool Close();
+
+	// -------- ACCESSORS --------
+	public:
+		unsigned long long GetCount() const { return count_; }
+};
+
+// Reads a snapshot back one file at a time through a large buffer, so the whole snapshot is never in memory.
+
+class SnapshotReader
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		InputFile			file_;
+		std::vector<char>	buffer_;
+		std::size_t			pos_;
+		std::size_t			end_;
+		bool				eof_;
+
+		std::string			root_;
+		long long			taken_;
+		unsigned long long	count_;
+		unsigned long long	read_;
+		std::string			path_;
+		bool				valid_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		SnapshotReader(std::string const& path);
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Reads the next file into entry. Returns false at the end of the snapshot, or if it is damaged.
+
+		bool Next(FileEntry& entry);
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsValid() const { return valid_; }
+		std::string const& GetRoot() const { return root_; }
+		long long GetTaken() const { return taken_; }
+		unsigned long long GetCount() const { return count_; }
+
+	private:
+
+		 // Makes sure at least want bytes are buffered, unless the file ends first. Returns the bytes buffered.
+
+		std::size_t Fill(std::size_t want);
+};
+
+// Compares two snapshots by walking both in path order at once: a path in only the newer one was added, one in
+// only the older one was removed, and one in both was resized or modified if its size or last write time
+// moved. Byte changes are summed for the folder holding each file.
+
+class SnapshotDiff
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		enum Change
+		{
+			ADDED,
+			REMOVED,
+			RESIZED,
+			MODIFIED
+		};
+
+		// Called for every file that changed. For an added file before is empty, for a removed one after is.
+		typedef std::function<void(Change change, FileEntry const& before, FileEntry const& after)> Visitor;
+
+		// How a folder's files changed; for a folder in GetFolders, its sub-folders' files included.
+		struct FolderDelta
+		{
+			std::string			path_;
+			long long			bytes_;
+			unsigned long long	added_;
+			unsigned long long	removed_;
+			unsigned long long	changed_;
+
+			FolderDelta() : bytes_(0), added_(0), removed_(0), changed_(0) { };
+		};
+
+		struct Stats
+		{
+			unsigned long long	counts_[4];
+			unsigned long long	unchanged_;
+			unsigned long long	addedBytes_;
+			unsigned long long	removedBytes_;
+			long long			resizedBytes_;
+			double				seconds_;
+
+			Stats() : unchanged_(0), addedBytes_(0), removedBytes_(0), resizedBytes_(0), seconds_(0) { counts_[0] = counts_[1] = counts_[2] = counts_[3] = 0; };
+		};
+
+	// -------- CLASS MEMBERS --------
+	private:
+		std::vector<FolderDelta>	folders_;
+		Stats						stats_;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Compares the snapshot at after with the older one at before, calling visit for every change.
+		 // Returns false if either snapshot cannot be read.
+
+		bool Run(std::string const& before, std::string const& after, Visitor const& visit = Visitor());
+
+		 // The folders whose files changed, each with the changes in and below it, biggest change in bytes first.
+
+		std::vector<FolderDelta> GetFolders() const;
+
+	// -------- ACCESSORS --------
+	public:
+		Stats const& GetStats() const { return stats_; }
+};
+
+#endif
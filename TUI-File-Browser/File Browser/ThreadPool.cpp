@@ -0,0 +1,136 @@
+/** @file : ThreadPool.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the worker pool used by the passes that run over a scan's result set.
+History : Added for the duplicate finder; the scan itself uses ScanEngine. Items are now split into
+          per-worker ranges that idle workers steal from, for the content search.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "ThreadPool.hpp"
+
+#include <vector>
+#include <memory>
+#include <chrono>
+
+
+namespace {
+	// The items a worker still has to run. The owner takes from the front and thieves take from the back,
+	// so the lock is almost never contended.
+	struct Slice
+	{
+		std::mutex	lock_;
+		std::size_t	begin_;
+		std::size_t	end_;
+
+		Slice(std::size_t begin, std::size_t end) : begin_(begin), end_(end) { };
+
+		bool Pop(std::size_t& item) {
+			std::lock_guard<std::mutex> lk(lock_);
+			if (begin_ == end_)
+				return false;
+			item = begin_++;
+			return true;
+		}
+	};
+
+	// Moves the back half of the first non-empty victim slice into the thief's (empty) slice and hands back its first item.
+	bool Steal(std::vector<std::unique_ptr<Slice>>& slices, unsigned thief, std::size_t& item) {
+		for (std::size_t n = 1; n < slices.size(); ++n)
+		{
+			Slice& victim = *slices[(thief + n) % slices.size()];
+			std::size_t begin;
+			std::size_t end;
+			{
+				std::lock_guard<std::mutex> lk(victim.lock_);
+				if (victim.begin_ == victim.end_)
+					continue;
+
+				begin = victim.begin_ + (victim.end_ - victim.begin_) / 2;
+				end = victim.end_;
+				victim.end_ = begin;
+			}
+
+			Slice& own = *slices[thief];
+			std::lock_guard<std::mutex> lk(own.lock_);
+			own.begin_ = begin + 1;
+			own.end_ = end;
+			item = begin;
+			return true;
+		}
+
+		return false;
+	}
+}
+
+
+// -------- CONSTRUCTOR --------
+ThreadPool::ThreadPool(unsigned threads, unsigned tickMs) : threads_(threads ? threads : 4), tickMs_(tickMs) {
+}
+
+// -------- OPERATIONS --------
+
+// Starts one thread per worker (never more than there are items), each with an even slice of the items.
+// Since items are never added, a worker that finds nothing to steal can stop for good. The calling thread
+// ticks while it waits, then joins the workers.
+
+void ThreadPool::ParallelFor(std::size_t count, Task const& task, Tick const& tick, std::atomic<bool> const* stop) const {
+	if (count == 0)
+		return;
+
+	std::mutex lock;
+	std::condition_variable finished;
+	std::exception_ptr error;
+	std::atomic<bool> failed(false);
+	unsigned running = static_cast<unsigned>(count < threads_ ? count : threads_);
+
+	std::vector<std::unique_ptr<Slice>> slices;
+	for (unsigned w = 0; w < running; ++w)
+		slices.push_back(std::unique_ptr<Slice>(new Slice(count * w / running, count * (w + 1) / running)));
+
+	std::vector<std::thread> workers;
+	for (unsigned w = 0, n = running; w < n; ++w)
+	{
+		workers.push_back(std::thread([&, w] {
+			try
+			{
+				std::size_t i;
+				while (!failed && !(stop && *stop) && (slices[w]->Pop(i) || Steal(slices, w, i)))
+					task(w, i);
+			}
+			catch (...)
+			{
+				// Keep the first failure and stop starting work.
+				std::lock_guard<std::mutex> lk(lock);
+				if (!error)
+					error = std::current_exception();
+				failed = true;
+			}
+
+			std::lock_guard<std::mutex> lk(lock);
+			if (--running == 0)
+				finished.notify_all();
+		}));
+	}
+
+	// Tick while the workers run.
+	{
+		std::unique_lock<std::mutex> lk(lock);
+		while (running != 0)
+		{
+			finished.wait_for(lk, std::chrono::milliseconds(tickMs_));
+			if (running != 0 && tick)
+			{
+				lk.unlock();
+				tick();
+				lk.lock();
+			}
+		}
+	}
+
+	for (auto& w : workers)
+		w.join();
+
+	if (error)
+		std::rethrow_exception(error);
+}
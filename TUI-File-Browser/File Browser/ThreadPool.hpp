@@ -0,0 +1,56 @@
+/** @file : ThreadPool.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the worker pool used by the passes that run over a scan's result set.
+History : Added for the duplicate finder; the scan itself uses ScanEngine. Items are now split into
+          per-worker ranges that idle workers steal from, for the content search.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __THREAD_POOL_GUARD__
+#define __THREAD_POOL_GUARD__
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+
+class ThreadPool
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		// Called on a worker thread for one item. The worker index lets the caller keep per-thread buffers.
+		typedef std::function<void(unsigned worker, std::size_t item)> Task;
+
+		// Called on the thread that started the pass, at a fixed interval, until the pass completes.
+		typedef std::function<void()> Tick;
+
+	// -------- CLASS MEMBERS --------
+	private:
+		unsigned	threads_;
+		unsigned	tickMs_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		ThreadPool(unsigned threads = std::thread::hardware_concurrency(), unsigned tickMs = 100);
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Runs task for every item in [0, count). Each worker starts with an even slice of the items and,
+		 // once its own slice is done, steals half of what is left of another worker's, so one large file
+		 // does not hold up the rest of a worker's share. If stop is given and becomes true, no further
+		 // items are started. Rethrows the first exception raised by a task once every worker has stopped.
+
+		void ParallelFor(std::size_t count, Task const& task, Tick const& tick = Tick(), std::atomic<bool> const* stop = nullptr) const;
+
+	// -------- ACCESSORS --------
+	public:
+		unsigned GetThreadCount() const { return threads_; }
+};
+
+#endif
@@ -0,0 +1,71 @@
+/** @file : Throttle.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the limits a background scan puts on itself.
+History : Added so a scan can run on a busy machine without competing with its real work.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Throttle.hpp"
+
+#include <thread>
+#include <algorithm>
+
+
+// -------- CONSTRUCTOR --------
+ScanThrottle::ScanThrottle(double rate) : background_(false), limited_(false), rate_(0), burst_(1), tokens_(0), last_(std::chrono::steady_clock::now()), taken_(0), waitedUs_(0) {
+	SetRate(rate);
+}
+
+// -------- OPERATIONS --------
+
+// Each taker refills the bucket for the time since the last one and takes its token, going into debt if the
+// bucket is empty; it then sleeps off its share of the debt outside the lock. Workers queue up one behind the
+// other this way without any of them spinning, and together they take tokens no faster than the rate.
+
+void ScanThrottle::Take() {
+	if (!limited_.load(std::memory_order_relaxed))
+		return;
+
+	double wait = 0;
+	{
+		std::lock_guard<std::mutex> lk(lock_);
+		auto const now = std::chrono::steady_clock::now();
+		tokens_ = std::min(burst_, tokens_ + std::chrono::duration<double>(now - last_).count() * rate_);
+		last_ = now;
+
+		tokens_ -= 1;
+		if (tokens_ < 0 && rate_ > 0)
+			wait = -tokens_ / rate_;
+	}
+
+	taken_.fetch_add(1, std::memory_order_relaxed);
+	if (wait > 0)
+	{
+		waitedUs_.fetch_add(static_cast<unsigned long long>(wait * 1e6), std::memory_order_relaxed);
+		std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(wait * 1e6)));
+	}
+}
+
+void ScanThrottle::SetBackground(bool on) {
+	std::lock_guard<std::mutex> lk(lock_);
+	background_ = on;
+	limited_ = on && rate_ > 0;
+}
+
+// A tenth of a second's worth of tokens may be saved up. Debt run up at the old rate is cut to the same, so
+// raising the rate takes effect at once.
+
+void ScanThrottle::SetRate(double rate) {
+	std::lock_guard<std::mutex> lk(lock_);
+	rate_ = std::max(0.0, rate);
+	burst_ = std::max(1.0, rate_ / 10);
+	tokens_ = std::max(-burst_, std::min(tokens_, burst_));
+	last_ = std::chrono::steady_clock::now();
+	limited_ = background_ && rate_ > 0;
+}
+
+double ScanThrottle::GetRate() {
+	std::lock_guard<std::mutex> lk(lock_);
+	return rate_;
+}
@@ -0,0 +1,71 @@
+/** @file : Throttle.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the limits a background scan puts on itself.
+History : Added so a scan can run on a busy machine without competing with its real work.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __THROTTLE_GUARD__
+#define __THROTTLE_GUARD__
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+
+// The settings of background mode, shared by the browser, which changes them, and the scan workers, which
+// read them while they run, so a change takes effect in the middle of a scan. In background mode the workers
+// run at background priority, which lowers both their CPU and their I/O priority, and every folder listing and
+// every file stat takes a token from a bucket refilled at the set rate, so the scan's load on the disk has a
+// ceiling whatever the disk could take. Outside background mode both are off and Take costs one atomic read.
+
+class ScanThrottle
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		std::atomic<bool>	background_;
+		std::atomic<bool>	limited_;		// background_ and a rate is set
+
+		std::mutex								lock_;
+		double									rate_;		// tokens per second; zero for no limit
+		double									burst_;		// most tokens that can be saved up
+		double									tokens_;	// may go below zero: the debt is slept off
+		std::chrono::steady_clock::time_point	last_;
+
+		std::atomic<unsigned long long>	taken_;
+		std::atomic<unsigned long long>	waitedUs_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		ScanThrottle(double rate = 2000);
+
+		ScanThrottle(ScanThrottle const&) = delete;
+		void operator=(ScanThrottle const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Takes one token for a folder listing or a file stat, sleeping as long as it takes to come in.
+		 // Returns at once outside background mode.
+
+		void Take();
+
+		void SetBackground(bool on);
+
+		 // Sets the listings and stats allowed per second in background mode; zero lifts the limit.
+
+		void SetRate(double rate);
+
+	// -------- ACCESSORS --------
+	public:
+		bool IsBackground() const { return background_.load(std::memory_order_relaxed); }
+		double GetRate();
+
+		// Tokens taken, and time spent waiting for them, since the throttle was made.
+		unsigned long long GetTaken() const { return taken_.load(std::memory_order_relaxed); }
+		double GetWaitedSeconds() const { return waitedUs_.load(std::memory_order_relaxed) / 1e6; }
+};
+
+#endif
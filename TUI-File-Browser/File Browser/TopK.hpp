@@ -0,0 +1,83 @@
+/** @file : TopK.hpp
+Name : Fayomi Augustine
+Purpose: Bounded heap used to keep a leaderboard of the K best entries seen during a scan.
+History : Added for the largest/newest file modes of the file browser.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __TOPK_GUARD__
+#define __TOPK_GUARD__
+
+#include <vector>
+#include <algorithm>
+
+
+// Keeps at most capacity_ items. "Better" is a strict ordering where Better(a, b) means a ranks above b.
+// The heap is ordered so its front is the worst item kept, which makes rejecting an item O(1)
+// and replacing the worst item O(log K).
+
+template <typename T, typename Better>
+class BoundedHeap
+{
+	// -------- CLASS MEMBERS --------
+	private:
+		std::vector<T>	heap_;
+		std::size_t		capacity_;
+		Better			better_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		BoundedHeap(std::size_t capacity = 0, Better better = Better()) : capacity_(capacity), better_(better) { heap_.reserve(capacity); };
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Offers an item to the heap. Returns true if it was kept.
+
+		bool Offer(T const& item) {
+			if (capacity_ == 0)
+				return false;
+
+			if (heap_.size() < capacity_)
+			{
+				heap_.push_back(item);
+				std::push_heap(heap_.begin(), heap_.end(), better_);
+				return true;
+			}
+
+			// Only beat the worst item kept.
+			if (!better_(item, heap_.front()))
+				return false;
+
+			std::pop_heap(heap_.begin(), heap_.end(), better_);
+			heap_.back() = item;
+			std::push_heap(heap_.begin(), heap_.end(), better_);
+			return true;
+		}
+
+		 // Offers every item of another heap, used to merge per-thread heaps.
+
+		void Merge(BoundedHeap const& other) {
+			for (auto const& item : other.heap_)
+				Offer(item);
+		}
+
+		 // Returns the items kept, best first.
+
+		std::vector<T> Sorted() const {
+			std::vector<T> items(heap_);
+			std::sort(items.begin(), items.end(), better_);
+			return items;
+		}
+
+		void Clear() { heap_.clear(); }
+
+	// -------- ACCESSORS --------
+	public:
+		std::size_t GetSize() const { return heap_.size(); }
+		std::size_t GetCapacity() const { return capacity_; }
+};
+
+#endif
@@ -0,0 +1,398 @@
+/** @file : Transfer.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for copying and moving the files of a listing to another folder.
+History : Added so files found in the browser can be copied or moved without leaving it.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Transfer.hpp"
+#include "ThreadPool.hpp"
+
+#include <set>
+#include <memory>
+#include <chrono>
+#include <utility>
+#include <algorithm>
+#include <Windows.h>
+#include <winioctl.h>
+
+
+// Block cloning came with ReFS on Windows Server 2016 and the Windows 10 SDK; built against an older SDK, it is
+// declared here. Volumes that cannot clone never report the flag, so the request is then never made.
+#ifndef FSCTL_DUPLICATE_EXTENTS_TO_FILE
+#define FSCTL_DUPLICATE_EXTENTS_TO_FILE CTL_CODE(FILE_DEVICE_FILE_SYSTEM, 209, METHOD_BUFFERED, FILE_WRITE_DATA)
+
+typedef struct _DUPLICATE_EXTENTS_DATA
+{
+	HANDLE			FileHandle;
+	LARGE_INTEGER	SourceFileOffset;
+	LARGE_INTEGER	TargetFileOffset;
+	LARGE_INTEGER	ByteCount;
+} DUPLICATE_EXTENTS_DATA;
+#endif
+
+#ifndef FILE_SUPPORTS_BLOCK_REFCOUNTING
+#define FILE_SUPPORTS_BLOCK_REFCOUNTING 0x08000000
+#endif
+
+namespace {
+	// Attributes a copy takes from its source. The rest are the file system's to set.
+	DWORD const KEPT_ATTRIBUTES = FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_ARCHIVE | FILE_ATTRIBUTE_NOT_CONTENT_INDEXED;
+
+	// Allocated ranges asked for at a time.
+	unsigned const RANGES = 64;
+
+	// Makes folder and every folder above it that is missing.
+	void MakeFolders(std::string const& folder) {
+		for (std::string::size_type at = folder.find_first_of("\\/", folder.find(':') == 1 ? 3 : 2); ; at = folder.find_first_of("\\/", at + 1))
+		{
+			CreateDirectoryA(folder.substr(0, at).c_str(), nullptr);
+			if (at == std::string::npos)
+				break;
+		}
+	}
+
+	// Runs a control request on a handle opened for overlapped I/O and waits for it. Returns false, with the
+	// error left for GetLastError, if it fails; ERROR_MORE_DATA is such a failure, with got set.
+	bool Control(HANDLE file, DWORD code, void* in, DWORD inSize, void* out, DWORD outSize, DWORD& got, HANDLE event) {
+		OVERLAPPED o = OVERLAPPED();
+		o.hEvent = event;
+		got = 0;
+		if (DeviceIoControl(file, code, in, inSize, out, outSize, nullptr, &o))
+			return GetOverlappedResult(file, &o, &got, TRUE) != FALSE;
+		if (GetLastError() != ERROR_IO_PENDING && GetLastError() != ERROR_MORE_DATA)
+			return false;
+		return GetOverlappedResult(file, &o, &got, TRUE) != FALSE;
+	}
+
+	bool SetSize(HANDLE file, unsigned long long size) {
+		FILE_END_OF_FILE_INFO end;
+		end.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+		return SetFileInformationByHandle(file, FileEndOfFileInfo, &end, sizeof(end)) != FALSE;
+	}
+
+	void At(OVERLAPPED& o, unsigned long long offset, HANDLE event) {
+		o = OVERLAPPED();
+		o.Offset = static_cast<DWORD>(offset);
+		o.OffsetHigh = static_cast<DWORD>(offset >> 32);
+		o.hEvent = event;
+	}
+}
+
+
+// Both buffers are page-aligned, as VirtualAlloc gives them, and the second is only made for a file of more than one
+// piece. events_ are for the read into each buffer and for the write.
+
+struct FileTransfer::Buffers
+{
+	char*	buffers_[2];
+	HANDLE	events_[3];
+
+	Buffers() {
+		buffers_[0] = buffers_[1] = nullptr;
+		for (auto& e : events_)
+			e = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+	}
+
+	~Buffers() {
+		for (auto b : buffers_)
+			if (b)
+				VirtualFree(b, 0, MEM_RELEASE);
+		for (auto e : events_)
+			if (e)
+				CloseHandle(e);
+	}
+
+	char* Get(unsigned i) {
+		if (!buffers_[i])
+			buffers_[i] = static_cast<char*>(VirtualAlloc(nullptr, CHUNK, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+		return buffers_[i];
+	}
+
+	bool IsReady() const { return events_[0] && events_[1] && events_[2]; }
+};
+
+// -------- CONSTRUCTOR --------
+
+FileTransfer::FileTransfer(Mode mode) : mode_(mode), cancel_(false), cloneable_(false), cluster_(0),
+	files_(0), bytes_(0), renamed_(0), cloned_(0), sparse_(0), failed_(0), seconds_(0) {
+}
+
+// -------- OPERATIONS --------
+
+// The targets are taken to be on one volume, the one of the first; a target elsewhere only misses out on cloning.
+// The folders are made up front, in order, so the workers never race to make the same one.
+
+bool FileTransfer::Run(std::vector<Item> const& items, std::function<void()> const& tick) {
+	auto start = std::chrono::steady_clock::now();
+
+	char root[MAX_PATH];
+	if (!items.empty() && GetVolumePathNameA(items[0].to_.c_str(), root, MAX_PATH))
+	{
+		DWORD flags = 0, sectors = 0, bytes = 0, free = 0, total = 0;
+		cloneable_ = GetVolumeInformationA(root, nullptr, 0, nullptr, nullptr, &flags, nullptr, 0) && (flags & FILE_SUPPORTS_BLOCK_REFCOUNTING)
+			&& GetDiskFreeSpaceA(root, &sectors, &bytes, &free, &total);
+		cluster_ = sectors * bytes;
+	}
+
+	std::set<std::string> folders;
+	for (auto const& item : items)
+	{
+		std::string::size_type const slash = item.to_.find_last_of("\\/");
+		if (slash != std::string::npos)
+			folders.insert(item.to_.substr(0, slash));
+	}
+	for (auto const& folder : folders)
+		MakeFolders(folder);
+
+	ThreadPool pool;
+	std::vector<std::unique_ptr<Buffers>> buffers(pool.GetThreadCount());
+	pool.ParallelFor(items.size(), [&](unsigned worker, std::size_t i) {
+		if (!buffers[worker])
+			buffers[worker].reset(new Buffers);
+
+		unsigned long error = 0;
+		if (mode_ == MOVE ? Move(items[i], *buffers[worker], error) : Copy(items[i], *buffers[worker], error))
+			files_.fetch_add(1, std::memory_order_relaxed);
+		else if (!cancel_)
+		{
+			failed_.fetch_add(1, std::memory_order_relaxed);
+			Report(items[i].from_, error);
+		}
+	}, tick, &cancel_);
+
+	seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return !cancel_ && failed_ == 0;
+}
+
+std::vector<FileTransfer::Failure> FileTransfer::TakeFailures() {
+	std::lock_guard<std::mutex> lk(lock_);
+	std::vector<Failure> failures;
+	failures.swap(failures_);
+	return failures;
+}
+
+// The target is sized before anything goes into it, so it is laid out in one piece and a sparse one has its holes
+// from the start. Pieces are read into one buffer while the piece before is written from the other; every read and
+// write issued is waited for before the handles are closed, however the copy ends.
+
+bool FileTransfer::Copy(Item const& item, Buffers& buffers, unsigned long& error) {
+	if (!buffers.IsReady())
+	{
+		error = ERROR_NOT_ENOUGH_MEMORY;
+		return false;
+	}
+
+	HANDLE in = CreateFileA(item.from_.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	BY_HANDLE_FILE_INFORMATION source;
+	if (in == INVALID_HANDLE_VALUE || !GetFileInformationByHandle(in, &source))
+	{
+		error = GetLastError();
+		if (in != INVALID_HANDLE_VALUE)
+			CloseHandle(in);
+		return false;
+	}
+
+	HANDLE out = CreateFileA(item.to_.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+	if (out == INVALID_HANDLE_VALUE)
+	{
+		error = GetLastError();
+		CloseHandle(in);
+		return false;
+	}
+
+	unsigned long long const size = static_cast<unsigned long long>(source.nFileSizeHigh) << 32 | source.nFileSizeLow;
+	bool const sparse = (source.dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE) != 0;
+	DWORD got = 0;
+	bool ok = (!sparse || Control(out, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, got, buffers.events_[2])) && SetSize(out, size);
+
+	// Within a volume that shares blocks, the target takes the source's; a volume that turns the request down is
+	// copied to instead. Requests end on a cluster boundary even past the end of the file, as they must.
+	bool cloned = false;
+	BY_HANDLE_FILE_INFORMATION target;
+	if (ok && cloneable_ && size && cluster_ && GetFileInformationByHandle(out, &target) && target.dwVolumeSerialNumber == source.dwVolumeSerialNumber)
+	{
+		cloned = true;
+		for (unsigned long long offset = 0; cloned && offset < size; offset += CLONE_MAX)
+		{
+			unsigned long long const left = (size - offset + cluster_ - 1) / cluster_ * cluster_;
+			DUPLICATE_EXTENTS_DATA extents;
+			extents.FileHandle = in;
+			extents.SourceFileOffset.QuadPart = static_cast<LONGLONG>(offset);
+			extents.TargetFileOffset.QuadPart = static_cast<LONGLONG>(offset);
+			extents.ByteCount.QuadPart = static_cast<LONGLONG>(left < CLONE_MAX ? left : CLONE_MAX);
+			cloned = !cancel_ && Control(out, FSCTL_DUPLICATE_EXTENTS_TO_FILE, &extents, sizeof(extents), nullptr, 0, got, buffers.events_[2]);
+		}
+		if (cloned)
+		{
+			cloned_.fetch_add(1, std::memory_order_relaxed);
+			bytes_.fetch_add(size, std::memory_order_relaxed);
+		}
+	}
+
+	// The ranges to copy: the whole file, or what is allocated of a sparse one.
+	std::vector<std::pair<unsigned long long, unsigned long long>> ranges;
+	if (ok && !cloned && sparse)
+	{
+		FILE_ALLOCATED_RANGE_BUFFER query, found[RANGES];
+		query.FileOffset.QuadPart = 0;
+		query.Length.QuadPart = static_cast<LONGLONG>(size);
+		for (bool more = size != 0; ok && more; )
+		{
+			ok = Control(in, FSCTL_QUERY_ALLOCATED_RANGES, &query, sizeof(query), found, sizeof(found), got, buffers.events_[2]);
+			more = !ok && GetLastError() == ERROR_MORE_DATA;
+			ok = ok || more;
+
+			DWORD const count = got / sizeof(FILE_ALLOCATED_RANGE_BUFFER);
+			for (DWORD r = 0; r < count; ++r)
+				ranges.push_back(std::make_pair(static_cast<unsigned long long>(found[r].FileOffset.QuadPart), static_cast<unsigned long long>(found[r].Length.QuadPart)));
+			if (more && count)
+			{
+				unsigned long long const end = ranges.back().first + ranges.back().second;
+				query.FileOffset.QuadPart = static_cast<LONGLONG>(end);
+				query.Length.QuadPart = static_cast<LONGLONG>(size - end);
+			}
+			more = more && count && ranges.back().first + ranges.back().second < size;
+		}
+		if (ok)
+			sparse_.fetch_add(1, std::memory_order_relaxed);
+	}
+	else if (ok && !cloned && size)
+		ranges.push_back(std::make_pair(0ull, size));
+
+	std::vector<std::pair<unsigned long long, DWORD>> pieces;
+	for (auto const& r : ranges)
+		for (unsigned long long offset = r.first; offset < r.first + r.second; offset += CHUNK)
+		{
+			unsigned long long const left = r.first + r.second - offset;
+			pieces.push_back(std::make_pair(offset, static_cast<DWORD>(left < CHUNK ? left : CHUNK)));
+		}
+
+	if (!pieces.empty() && (!buffers.Get(0) || (pieces.size() > 1 && !buffers.Get(1))))
+	{
+		ok = false;
+		SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+	}
+
+	// reading is the buffer a read is in flight into, if any.
+	OVERLAPPED reads[2], write;
+	int reading = -1;
+	bool writing = false;
+	if (ok && !pieces.empty())
+	{
+		At(reads[0], pieces[0].first, buffers.events_[0]);
+		ok = ReadFile(in, buffers.buffers_[0], pieces[0].second, nullptr, &reads[0]) || GetLastError() == ERROR_IO_PENDING;
+		reading = ok ? 0 : -1;
+	}
+	for (std::size_t k = 0; ok && k < pieces.size(); ++k)
+	{
+		unsigned const slot = k % 2;
+		DWORD done = 0;
+		reading = -1;
+		ok = GetOverlappedResult(in, &reads[slot], &done, TRUE) != FALSE;
+		if (ok && done != pieces[k].second)
+		{
+			// The file is shorter than it was when it was opened.
+			ok = false;
+			SetLastError(ERROR_HANDLE_EOF);
+		}
+
+		if (writing)
+		{
+			DWORD wrote = 0;
+			writing = false;
+			ok = GetOverlappedResult(out, &write, &wrote, TRUE) && ok;
+		}
+		if (ok && cancel_)
+		{
+			ok = false;
+			SetLastError(ERROR_OPERATION_ABORTED);
+		}
+		if (!ok)
+			break;
+
+		if (k + 1 < pieces.size())
+		{
+			At(reads[1 - slot], pieces[k + 1].first, buffers.events_[1 - slot]);
+			ok = ReadFile(in, buffers.buffers_[1 - slot], pieces[k + 1].second, nullptr, &reads[1 - slot]) || GetLastError() == ERROR_IO_PENDING;
+			reading = ok ? 1 - slot : -1;
+		}
+		if (ok)
+		{
+			At(write, pieces[k].first, buffers.events_[2]);
+			ok = WriteFile(out, buffers.buffers_[slot], done, nullptr, &write) || GetLastError() == ERROR_IO_PENDING;
+			writing = ok;
+		}
+		if (ok)
+			bytes_.fetch_add(done, std::memory_order_relaxed);
+	}
+
+	if (!ok)
+		error = GetLastError();
+	DWORD waited = 0;
+	if (reading >= 0)
+		GetOverlappedResult(in, &reads[reading], &waited, TRUE);
+	if (writing && !GetOverlappedResult(out, &write, &waited, TRUE) && ok)
+	{
+		ok = false;
+		error = GetLastError();
+	}
+
+	if (ok)
+		SetFileTime(out, &source.ftCreationTime, &source.ftLastAccessTime, &source.ftLastWriteTime);
+	CloseHandle(out);
+	CloseHandle(in);
+
+	if (!ok)
+	{
+		DeleteFileA(item.to_.c_str());
+		return false;
+	}
+	if (source.dwFileAttributes & KEPT_ATTRIBUTES)
+		SetFileAttributesA(item.to_.c_str(), source.dwFileAttributes & KEPT_ATTRIBUTES);
+	return true;
+}
+
+// A rename never replaces a file, so a target that exists fails the same way a copy's does.
+
+bool FileTransfer::Move(Item const& item, Buffers& buffers, unsigned long& error) {
+	if (MoveFileExA(item.from_.c_str(), item.to_.c_str(), 0))
+	{
+		renamed_.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	error = GetLastError();
+	if (error != ERROR_NOT_SAME_DEVICE || !Copy(item, buffers, error))
+		return false;
+
+	// The copy is kept if the source cannot be removed; the source is reported, as it is still there.
+	if (!DeleteFileA(item.from_.c_str()))
+	{
+		error = GetLastError();
+		return false;
+	}
+	return true;
+}
+
+void FileTransfer::Report(std::string const& path, unsigned long error) {
+	Failure failure = { path, error };
+	std::lock_guard<std::mutex> lk(lock_);
+	failures_.push_back(failure);
+}
+
+// -------- ACCESSORS --------
+
+FileTransfer::Stats FileTransfer::GetStats() const {
+	Stats s;
+	s.files_ = files_;
+	s.bytes_ = bytes_;
+	s.renamed_ = renamed_;
+	s.cloned_ = cloned_;
+	s.sparse_ = sparse_;
+	s.failed_ = failed_;
+	s.seconds_ = seconds_;
+	s.cancelled_ = cancel_;
+	return s;
+}
@@ -0,0 +1,140 @@
+/** @file : Transfer.hpp
+Name : Fayomi Augustine
+Purpose: Header file for copying and moving the files of a listing to another folder.
+History : Added so files found in the browser can be copied or moved without leaving it.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __TRANSFER_GUARD__
+#define __TRANSFER_GUARD__
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+
+
+// Copies or moves files, many at a time on the thread pool, each by the cheapest means the volumes allow:
+//
+//   - a move within a volume is a rename;
+//   - a copy within a volume that shares blocks between files (ReFS) clones the source's extents, so no data is
+//     read or written at all;
+//   - anything else is read and written in CHUNK sized pieces through two buffers, the next piece being read
+//     while the last one is written. A file of no more than CHUNK bytes is one read and one write.
+//
+// A sparse source makes a sparse target, and only its allocated ranges are copied, so its holes stay holes. A copy
+// keeps the source's attributes and times. A target that already exists is left alone and the file reported; a
+// copy that fails or is cancelled part way is removed. A move across volumes is a copy followed by removing the
+// source once the copy is complete.
+
+class FileTransfer
+{
+	// -------- DEPENDENCY CLASSES --------
+	public:
+		enum Mode
+		{
+			COPY,
+			MOVE
+		};
+
+		// A file and where it goes.
+		struct Item
+		{
+			std::string		from_;
+			std::string		to_;
+		};
+
+		struct Failure
+		{
+			std::string		path_;
+			unsigned long	error_;		// the system error code
+		};
+
+		struct Stats
+		{
+			unsigned long long	files_;			// files done
+			unsigned long long	bytes_;			// bytes of the files done, or being done, so far
+			unsigned long long	renamed_;		// files moved by a rename
+			unsigned long long	cloned_;		// files copied by sharing the source's blocks
+			unsigned long long	sparse_;		// files copied range by range, holes kept
+			unsigned long long	failed_;
+			double				seconds_;
+			bool				cancelled_;
+		};
+
+		// Size of each read and write of a copy.
+		static std::size_t const CHUNK = 4 << 20;
+
+		// Most bytes cloned by one request, a whole number of any cluster size.
+		static unsigned long long const CLONE_MAX = 1ull << 30;
+
+	private:
+		// One worker's buffers, made on first use.
+		struct Buffers;
+
+	// -------- CLASS MEMBERS --------
+	private:
+		Mode				mode_;
+		std::atomic<bool>	cancel_;
+
+		// What the volume of the targets can do, found before a run.
+		bool				cloneable_;
+		unsigned long		cluster_;
+
+		std::mutex				lock_;
+		std::vector<Failure>	failures_;
+
+		std::atomic<unsigned long long>	files_;
+		std::atomic<unsigned long long>	bytes_;
+		std::atomic<unsigned long long>	renamed_;
+		std::atomic<unsigned long long>	cloned_;
+		std::atomic<unsigned long long>	sparse_;
+		std::atomic<unsigned long long>	failed_;
+		double							seconds_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+		FileTransfer(Mode mode);
+
+		FileTransfer(FileTransfer const&) = delete;
+		void operator=(FileTransfer const&) = delete;
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Copies or moves every item, making the folders the targets need first. tick is called on this thread
+		 // at a fixed interval. Returns false if any item failed or the run was cancelled.
+
+		bool Run(std::vector<Item> const& items, std::function<void()> const& tick = std::function<void()>());
+
+		 // Asks a running transfer to stop. Files being copied stop at their next piece and are removed.
+
+		void Cancel() { cancel_ = true; }
+
+		 // Hands over the files that failed since the last call.
+
+		std::vector<Failure> TakeFailures();
+
+	// -------- ACCESSORS --------
+	public:
+		Mode GetMode() const { return mode_; }
+		Stats GetStats() const;
+
+	private:
+
+		 // Copies item.from_ to item.to_, which must not exist. Returns false, with the system error in error and
+		 // no target left behind, if it cannot.
+
+		bool Copy(Item const& item, Buffers& buffers, unsigned long& error);
+
+		 // Moves item.from_ to item.to_: a rename if it can be, else a copy and then removing the source.
+
+		bool Move(Item const& item, Buffers& buffers, unsigned long& error);
+
+		void Report(std::string const& path, unsigned long error);
+};
+
+#endif
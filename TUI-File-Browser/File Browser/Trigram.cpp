@@ -0,0 +1,312 @@
+/** @file : Trigram.cpp
+Name : Fayomi Augustine
+Purpose: Implementation file for the trigram index over the names of the scanned files.
+History : Added so a substring of a file name can be found without rescanning or testing every name.
+Date : 18/10/2026
+version: 1.0
+**/
+
+#include "Trigram.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <algorithm>
+
+
+namespace {
+	// Trigrams are merged in this many ranges, split on their first character.
+	std::size_t const RANGES = 256;
+
+	// Follows every trigram; no real trigram is this big.
+	std::uint32_t const END_KEY = 0xffffffff;
+
+	char Lower(char c) {
+		return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+	}
+
+	std::uint32_t Key(char const* s) {
+		return (static_cast<std::uint32_t>(static_cast<unsigned char>(s[0])) << 16) |
+			(static_cast<std::uint32_t>(static_cast<unsigned char>(s[1])) << 8) |
+			static_cast<unsigned char>(s[2]);
+	}
+
+	// Seven bits per byte, lowest first; the top bit is set on every byte but the last.
+	void Put(std::vector<unsigned char>& out, std::uint32_t value) {
+		while (value >= 0x80)
+		{
+			out.push_back(static_cast<unsigned char>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<unsigned char>(value));
+	}
+
+	std::uint32_t Get(unsigned char const*& p) {
+		std::uint32_t value = 0;
+		unsigned shift = 0;
+		while (*p & 0x80)
+		{
+			value |= static_cast<std::uint32_t>(*p++ & 0x7f) << shift;
+			shift += 7;
+		}
+		return value | (static_cast<std::uint32_t>(*p++) << shift);
+	}
+
+	// Sorts (trigram << 32 | name) pairs by trigram in two 12 bit radix passes. The pairs are made in name
+	// order and each pass is stable, so names stay in order within a trigram and a name's repeats of the same
+	// trigram end up next to each other.
+	void SortByKey(std::vector<std::uint64_t>& pairs) {
+		std::vector<std::uint64_t> spare(pairs.size());
+		for (unsigned shift = 32; shift < 56; shift += 12)
+		{
+			std::vector<std::size_t> counts(4097, 0);
+			for (auto pair : pairs)
+				++counts[((pair >> shift) & 0xfff) + 1];
+			for (std::size_t i = 1; i < counts.size(); ++i)
+				counts[i] += counts[i - 1];
+			for (auto pair : pairs)
+				spare[counts[(pair >> shift) & 0xfff]++] = pair;
+			pairs.swap(spare);
+		}
+	}
+
+	// The lists of one chunk of names. The first and last number of each list are kept aside so that when the
+	// chunks are joined only the gap to the first number has to be coded again; the rest are copied as they are.
+	struct Part
+	{
+		std::vector<std::uint32_t>	keys_;
+		std::vector<std::uint32_t>	counts_;
+		std::vector<std::uint32_t>	firsts_;
+		std::vector<std::uint32_t>	lasts_;
+		std::vector<std::size_t>	offsets_;	// of each list's gaps after the first number; one more than keys_
+		std::vector<unsigned char>	bytes_;
+	};
+
+	// One list of one chunk, while merging.
+	struct Ref
+	{
+		std::uint32_t	key_;
+		std::size_t		part_;
+		std::size_t		index_;
+
+		Ref(std::uint32_t key, std::size_t part, std::size_t index) : key_(key), part_(part), index_(index) { };
+	};
+}
+
+
+// -------- CONSTRUCTOR --------
+
+// The names are copied in lower case first. Each chunk then lists its (trigram, name) pairs, sorts them and
+// codes one list per trigram. Since chunks hold consecutive names, a trigram's full list is its chunk lists
+// joined in chunk order, which is what each range task does for the trigrams in its range.
+
+TrigramIndex::TrigramIndex(std::vector<FileEntry> const& files) : buildSeconds_(0), candidates_(0), seconds_(0) {
+	auto start = std::chrono::steady_clock::now();
+
+	std::size_t total = 0;
+	for (auto const& f : files)
+		total += f.path_.size() - (f.path_.find_last_of("\\/") + 1);
+
+	names_.reserve(total);
+	starts_.reserve(files.size() + 1);
+	for (auto const& f : files)
+	{
+		starts_.push_back(names_.size());
+		for (std::size_t i = f.path_.find_last_of("\\/") + 1; i < f.path_.size(); ++i)
+			names_.push_back(Lower(f.path_[i]));
+	}
+	starts_.push_back(names_.size());
+
+	ThreadPool pool;
+	std::size_t const count = files.size();
+	std::vector<Part> parts((count + CHUNK - 1) / CHUNK);
+
+	pool.ParallelFor(parts.size(), [&](unsigned, std::size_t chunk) {
+		std::vector<std::uint64_t> pairs;
+		std::size_t const end = std::min(count, (chunk + 1) * CHUNK);
+		for (std::size_t item = chunk * CHUNK; item < end; ++item)
+			for (std::size_t i = starts_[item]; i + 3 <= starts_[item + 1]; ++i)
+				pairs.push_back((static_cast<std::uint64_t>(Key(&names_[i])) << 32) | item);
+
+		SortByKey(pairs);
+		pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+		Part& part = parts[chunk];
+		for (std::size_t i = 0; i < pairs.size();)
+		{
+			std::uint32_t const key = static_cast<std::uint32_t>(pairs[i] >> 32);
+			std::uint32_t previous = static_cast<std::uint32_t>(pairs[i]);
+			part.keys_.push_back(key);
+			part.firsts_.push_back(previous);
+			part.offsets_.push_back(part.bytes_.size());
+
+			std::size_t j = i + 1;
+			for (; j < pairs.size() && static_cast<std::uint32_t>(pairs[j] >> 32) == key; ++j)
+			{
+				std::uint32_t const item = static_cast<std::uint32_t>(pairs[j]);
+				Put(part.bytes_, item - previous);
+				previous = item;
+			}
+
+			part.counts_.push_back(static_cast<std::uint32_t>(j - i));
+			part.lasts_.push_back(previous);
+			i = j;
+		}
+		part.offsets_.push_back(part.bytes_.size());
+	});
+
+	std::vector<std::vector<Posting>> rangePostings(RANGES);
+	std::vector<std::vector<unsigned char>> rangeBytes(RANGES);
+
+	pool.ParallelFor(RANGES, [&](unsigned, std::size_t range) {
+		std::uint32_t const lo = static_cast<std::uint32_t>(range << 16);
+		std::uint32_t const hi = static_cast<std::uint32_t>((range + 1) << 16);
+
+		std::vector<Ref> refs;
+		for (std::size_t p = 0; p < parts.size(); ++p)
+		{
+			auto const& keys = parts[p].keys_;
+			std::size_t const b = std::lower_bound(keys.begin(), keys.end(), lo) - keys.begin();
+			std::size_t const e = std::lower_bound(keys.begin(), keys.end(), hi) - keys.begin();
+			for (std::size_t i = b; i < e; ++i)
+				refs.push_back(Ref(keys[i], p, i));
+		}
+
+		// Stable, so each trigram's chunk lists stay in chunk order.
+		std::stable_sort(refs.begin(), refs.end(), [](Ref const& a, Ref const& b) { return a.key_ < b.key_; });
+
+		std::vector<Posting>& postings = rangePostings[range];
+		std::vector<unsigned char>& bytes = rangeBytes[range];
+		for (std::size_t i = 0; i < refs.size();)
+		{
+			Posting posting(refs[i].key_, 0, bytes.size());
+			std::uint32_t last = 0;
+			for (; i < refs.size() && refs[i].key_ == posting.key_; ++i)
+			{
+				Part const& part = parts[refs[i].part_];
+				std::size_t const k = refs[i].index_;
+				Put(bytes, part.firsts_[k] - last);
+				bytes.insert(bytes.end(), part.bytes_.begin() + part.offsets_[k], part.bytes_.begin() + part.offsets_[k + 1]);
+				last = part.lasts_[k];
+				posting.count_ += part.counts_[k];
+			}
+			postings.push_back(posting);
+		}
+	});
+
+	parts.clear();
+
+	std::size_t postingCount = 1;
+	std::size_t byteCount = 0;
+	for (std::size_t r = 0; r < RANGES; ++r)
+	{
+		postingCount += rangePostings[r].size();
+		byteCount += rangeBytes[r].size();
+	}
+
+	postings_.reserve(postingCount);
+	bytes_.reserve(byteCount);
+	for (std::size_t r = 0; r < RANGES; ++r)
+	{
+		for (auto const& posting : rangePostings[r])
+			postings_.push_back(Posting(posting.key_, posting.count_, posting.offset_ + bytes_.size()));
+		bytes_.insert(bytes_.end(), rangeBytes[r].begin(), rangeBytes[r].end());
+
+		std::vector<Posting>().swap(rangePostings[r]);
+		std::vector<unsigned char>().swap(rangeBytes[r]);
+	}
+	postings_.push_back(Posting(END_KEY, 0, bytes_.size()));
+
+	buildSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// -------- OPERATIONS --------
+
+// The lists are intersected shortest first, so the candidates only shrink; each longer list is decoded only as
+// far as the last candidate left. The candidates are then searched, since holding every trigram of the text
+// does not mean holding them in order.
+
+std::vector<std::uint32_t> TrigramIndex::Find(std::string const& text) {
+	auto start = std::chrono::steady_clock::now();
+
+	std::string q(text);
+	std::transform(q.begin(), q.end(), q.begin(), Lower);
+
+	std::vector<std::uint32_t> candidates;
+	if (q.size() < 3)
+	{
+		candidates.resize(GetNameCount());
+		for (std::size_t i = 0; i < candidates.size(); ++i)
+			candidates[i] = static_cast<std::uint32_t>(i);
+	}
+	else
+	{
+		std::vector<std::uint32_t> keys;
+		for (std::size_t i = 0; i + 3 <= q.size(); ++i)
+			keys.push_back(Key(&q[i]));
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+		std::vector<Posting const*> lists;
+		for (auto key : keys)
+		{
+			Posting const* posting = Lookup(key);
+			if (!posting)
+			{
+				lists.clear();
+				break;
+			}
+			lists.push_back(posting);
+		}
+		std::sort(lists.begin(), lists.end(), [](Posting const* a, Posting const* b) { return a->count_ < b->count_; });
+
+		for (std::size_t l = 0; l < lists.size(); ++l)
+		{
+			unsigned char const* p = bytes_.data() + lists[l]->offset_;
+			std::uint32_t item = 0;
+
+			if (l == 0)
+			{
+				candidates.reserve(lists[l]->count_);
+				for (std::uint32_t n = 0; n < lists[l]->count_; ++n)
+				{
+					item += Get(p);
+					candidates.push_back(item);
+				}
+				continue;
+			}
+
+			std::size_t kept = 0;
+			std::size_t j = 0;
+			for (std::uint32_t n = 0; n < lists[l]->count_ && j < candidates.size(); ++n)
+			{
+				item += Get(p);
+				while (j < candidates.size() && candidates[j] < item)
+					++j;
+				if (j < candidates.size() && candidates[j] == item)
+					candidates[kept++] = candidates[j++];
+			}
+			candidates.resize(kept);
+			if (candidates.empty())
+				break;
+		}
+	}
+
+	candidates_ = candidates.size();
+
+	std::vector<std::uint32_t> found;
+	for (auto item : candidates)
+	{
+		char const* b = names_.data() + starts_[item];
+		char const* e = names_.data() + starts_[item + 1];
+		if (std::search(b, e, q.begin(), q.end()) != e)
+			found.push_back(item);
+	}
+
+	seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return found;
+}
+
+TrigramIndex::Posting const* TrigramIndex::Lookup(std::uint32_t key) const {
+	auto it = std::lower_bound(postings_.begin(), postings_.end() - 1, key, [](Posting const& p, std::uint32_t k) { return p.key_ < k; });
+	return it->key_ == key ? &*it : nullptr;
+}
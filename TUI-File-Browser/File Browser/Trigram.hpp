@@ -0,0 +1,92 @@
+/** @file : Trigram.hpp
+Name : Fayomi Augustine
+Purpose: Header file for the trigram index over the names of the scanned files.
+History : Added so a substring of a file name can be found without rescanning or testing every name.
+Date : 18/10/2026
+version: 1.0
+**/
+
+
+#ifndef __TRIGRAM_GUARD__
+#define __TRIGRAM_GUARD__
+
+#include "ScanEngine.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+// Maps every run of three characters found in a file name to the list of names containing it. A substring of
+// three or more characters can only be in names that hold all of its trigrams, so intersecting those lists
+// leaves a few candidates, and only they are searched. Names are kept in lower case so searches ignore case.
+// Each list holds increasing name numbers stored as the gaps between them in a variable number of bytes,
+// which keeps most entries to one byte. The names are split into chunks indexed on the thread pool, and
+// the chunks' lists are then merged one range of trigrams per task.
+
+class TrigramIndex
+{
+	// -------- CLASS MEMBERS --------
+	public:
+		// Names indexed by one pool task.
+		static std::size_t const CHUNK = 65536;
+
+	private:
+		// Where one trigram's list starts in bytes_; it ends where the next one starts.
+		struct Posting
+		{
+			std::uint32_t	key_;
+			std::uint32_t	count_;
+			std::size_t		offset_;
+
+			Posting(std::uint32_t key = 0, std::uint32_t count = 0, std::size_t offset = 0) : key_(key), count_(count), offset_(offset) { };
+		};
+
+		std::vector<char>			names_;
+		std::vector<std::size_t>	starts_;
+		std::vector<Posting>		postings_;
+		std::vector<unsigned char>	bytes_;
+
+		double						buildSeconds_;
+		std::size_t					candidates_;
+		double						seconds_;
+
+	// -------- CONSTRUCTOR --------
+	public:
+
+		 // Indexes the name of every file; the number of a name is the index of its file in files.
+
+		TrigramIndex(std::vector<FileEntry> const& files);
+
+	// -------- OPERATIONS --------
+	public:
+
+		 // Numbers of the names containing text, ignoring case, in increasing order. Text shorter than a trigram
+		 // is searched for in every name.
+
+		std::vector<std::uint32_t> Find(std::string const& text);
+
+	// -------- ACCESSORS --------
+	public:
+		std::size_t GetNameCount() const { return starts_.size() - 1; }
+		std::size_t GetTrigramCount() const { return postings_.size() - 1; }
+
+		// Memory held by the lists, by the copy of the names, and in all.
+		std::size_t GetPostingMemory() const { return bytes_.capacity() + postings_.capacity() * sizeof(Posting); }
+		std::size_t GetNameMemory() const { return names_.capacity() + starts_.capacity() * sizeof(std::size_t); }
+		std::size_t GetMemory() const { return GetPostingMemory() + GetNameMemory(); }
+
+		double GetBuildSeconds() const { return buildSeconds_; }
+
+		// Names the last Find had to search, and the time it took.
+		std::size_t GetCandidates() const { return candidates_; }
+		double GetSeconds() const { return seconds_; }
+
+	private:
+
+		 // The list of key, or nullptr if no name holds it.
+
+		Posting const* Lookup(std::uint32_t key) const;
+};
+
+#endif